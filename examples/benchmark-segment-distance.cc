@@ -0,0 +1,143 @@
+/*
+ * @file benchmark-segment-distance.cc
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/*
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief Throughput (segments/second) of the point to segment distance:
+ * Geometry::distanceFromSegment against SegmentDistanceKernel on each
+ * instruction set supported by the processor.
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../src/geometry/Geometry.h"
+#include "../src/geometry/SegmentDistanceKernel.h"
+
+using namespace std;
+
+/* Get the time in seconds since the first call. */
+double seconds() {
+  static chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  return chrono::duration<double>(chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main() {
+  /* Declare the variables: */
+  int dimension, instructionSet, i, k, repetition,
+    numberOfSegments = 4096,
+    numberOfRepetitions = 2000;
+
+  int *segmentIDs = new int[numberOfSegments];
+
+  double start, elapsed, checksum,
+    point[3],
+    *proximalPoints = new double[3 * numberOfSegments],
+    *distalPoints = new double[3 * numberOfSegments],
+    *distances = new double[numberOfSegments],
+    *scalarDistances = new double[numberOfSegments];
+
+  string const instructionSetName[3] = {"scalar", "AVX2", "AVX-512"};
+
+  mt19937_64 generator(5489UL);
+  uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+  seconds();
+  for (dimension = 2; dimension <= 3; dimension++) {
+    /* Random segments (z is zero in 2D) and a shuffled order of them. */
+    for (i = 0; i < numberOfSegments; i++) {
+      for (k = 0; k < 3; k++) {
+        proximalPoints[3 * i + k] = k < dimension ? uniform(generator) : 0.0;
+        distalPoints[3 * i + k] = k < dimension ? uniform(generator) : 0.0;
+      }
+      segmentIDs[i] = i;
+    }
+    shuffle(segmentIDs, segmentIDs + numberOfSegments, generator);
+    for (k = 0; k < 3; k++) {
+      point[k] = k < dimension ? uniform(generator) : 0.0;
+    }
+
+    /* The current scalar path: one Geometry call per segment. */
+    Geometry geometry(dimension);
+    Point P(point, dimension);
+    checksum = 0.0;
+    start = seconds();
+    for (repetition = 0; repetition < numberOfRepetitions; repetition++) {
+      for (i = 0; i < numberOfSegments; i++) {
+        scalarDistances[i] = geometry.distanceFromSegment(
+            P, Point(&proximalPoints[3 * i], dimension),
+            Point(&distalPoints[3 * i], dimension));
+      }
+      checksum += scalarDistances[repetition % numberOfSegments];
+    }
+    elapsed = seconds() - start;
+    cout << dimension << "D Geometry::distanceFromSegment: "
+         << numberOfRepetitions * numberOfSegments / elapsed
+         << " segments/s (checksum " << checksum << ")" << endl;
+
+    for (instructionSet = SegmentDistanceKernel::SCALAR;
+         instructionSet <= SegmentDistanceKernel::supportedInstructionSet();
+         instructionSet++) {
+      SegmentDistanceKernel::setInstructionSet(instructionSet);
+      for (k = 0; k < 2; k++) {
+        checksum = 0.0;
+        start = seconds();
+        for (repetition = 0; repetition < numberOfRepetitions; repetition++) {
+          SegmentDistanceKernel::distancesFromSegments(
+              dimension, point, proximalPoints, distalPoints,
+              k == 0 ? nullptr : segmentIDs, numberOfSegments, distances);
+          checksum += distances[repetition % numberOfSegments];
+        }
+        elapsed = seconds() - start;
+
+        /* The distances must be the same of the scalar path. */
+        for (i = 0; i < numberOfSegments; i++) {
+          if (memcmp(&distances[i],
+                     &scalarDistances[k == 0 ? i : segmentIDs[i]],
+                     sizeof(double)) != 0) {
+            cout << "Oops! Different distance on segment " << i << "."
+                 << endl;
+            return 1;
+          }
+        }
+
+        cout << dimension << "D SegmentDistanceKernel ("
+             << instructionSetName[instructionSet]
+             << (k == 0 ? ", contiguous" : ", indexed")
+             << "): " << numberOfRepetitions * numberOfSegments / elapsed
+             << " segments/s (checksum " << checksum << ")" << endl;
+      }
+    }
+  }
+
+  delete[] segmentIDs;
+  delete[] proximalPoints;
+  delete[] distalPoints;
+  delete[] distances;
+  delete[] scalarDistances;
+
+  return 0;
+}
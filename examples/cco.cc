@@ -31,6 +31,7 @@
 #include "../src/cco/ConstrainedConstructiveOptimization.h"
 #include "../src/domain/CircleFunction.h"
 #include "../src/domain/DomainFile.h"
+#include "../src/progress/AllocationCounter.h"
 #include "../src/tree/Tree.h"
 #include "../src/tree/TreeFile.h"
 
@@ -83,6 +84,12 @@ int main(int argc, char *argv[]) {
   /* Grow the tree: */
   cco.grow();
 
+  /* Heap allocations while growing (DEFINES=-DCCOLAB_COUNT_ALLOCATIONS): */
+  if (AllocationCounter::isEnabled()) {
+    cout << "Heap allocations while growing: " << cco.numberOfAllocations()
+         << endl;
+  }
+
   /* Save the tree file: */
   treeFile = new TreeFile(cco.tree());
 
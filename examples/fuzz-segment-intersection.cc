@@ -0,0 +1,152 @@
+/*
+ * @file fuzz-segment-intersection.cc
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/*
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief Fuzz test of SegmentIntersectionKernel against the scalar test
+ * Geometry::hasIntersection, on each instruction set supported by the
+ * processor. Usage: fuzz-segment-intersection [number of tests] [seed].
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../src/geometry/Geometry.h"
+#include "../src/geometry/SegmentIntersectionKernel.h"
+
+using namespace std;
+
+/* Get a coordinate: uniform, on a coarse lattice (exact ties) or tiny. */
+double coordinate(mt19937_64 &generator) {
+  uniform_real_distribution<double> uniform(-1.0, 1.0);
+  switch (generator() % 4) {
+    case 0:
+      return static_cast<double>(static_cast<long>(generator() % 9) - 4) /
+             4.0;
+    case 1:
+      return 1e-7 * uniform(generator);
+    default:
+      return uniform(generator);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  /* Declare the variables: */
+  int dimension, instructionSet, i, k, n, test,
+    numberOfTests = argc > 1 ? atoi(argv[1]) : 100000,
+    maximumNumberOfSegments =
+        SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS;
+
+  unsigned long expected, mask, firstHit;
+
+  long numberOfHits = 0, numberOfFailures = 0;
+
+  double C[3], D[3],
+    proximalPoints[3 * SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS],
+    distalPoints[3 * SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS],
+    tolerances[SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS];
+
+  mt19937_64 generator(argc > 2 ? strtoul(argv[2], nullptr, 10) : 5489UL);
+  uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  for (test = 0; test < numberOfTests; test++) {
+    dimension = 2 + test % 2;
+    Geometry geometry(dimension);
+
+    /* The segment CD and the segments around it. */
+    for (k = 0; k < 3; k++) {
+      C[k] = k < dimension ? coordinate(generator) : 0.0;
+      D[k] = k < dimension ? coordinate(generator) : 0.0;
+    }
+    n = static_cast<int>(generator() % (maximumNumberOfSegments + 1));
+    for (i = 0; i < n; i++) {
+      for (k = 0; k < 3; k++) {
+        proximalPoints[3 * i + k] = k < dimension ? coordinate(generator) : 0.0;
+        distalPoints[3 * i + k] = k < dimension ? coordinate(generator) : 0.0;
+      }
+      switch (generator() % 4) {
+        case 0:
+          /* Degenerated segment. */
+          for (k = 0; k < 3; k++) {
+            distalPoints[3 * i + k] = proximalPoints[3 * i + k];
+          }
+          break;
+        case 1:
+          /* Parallel to CD. */
+          for (k = 0; k < 3; k++) {
+            distalPoints[3 * i + k] = proximalPoints[3 * i + k] + D[k] - C[k];
+          }
+          break;
+        case 2:
+          /* Starting on CD. */
+          for (k = 0; k < 3; k++) {
+            proximalPoints[3 * i + k] = C[k] + 0.5 * (D[k] - C[k]);
+          }
+          break;
+      }
+      tolerances[i] = generator() % 2 == 0 ? 0.0 : 0.1 * uniform(generator);
+    }
+
+    /* The answer of the scalar test. */
+    expected = 0;
+    for (i = 0; i < n; i++) {
+      if (geometry.hasIntersection(
+              Point(&proximalPoints[3 * i], dimension),
+              Point(&distalPoints[3 * i], dimension), Point(C, dimension),
+              Point(D, dimension), tolerances[i])) {
+        expected |= 1UL << i;
+      }
+    }
+    numberOfHits += __builtin_popcountl(expected);
+    firstHit = expected & (~expected + 1);
+
+    for (instructionSet = SegmentDistanceKernel::SCALAR;
+         instructionSet <= SegmentIntersectionKernel::supportedInstructionSet();
+         instructionSet++) {
+      SegmentIntersectionKernel::setInstructionSet(instructionSet);
+      mask = SegmentIntersectionKernel::intersectionMask(
+          dimension, C, D, proximalPoints, distalPoints, tolerances, n, false);
+      if (mask != expected) {
+        numberOfFailures++;
+        cout << "Oops! Test " << test << " (instruction set "
+             << instructionSet << "): mask " << mask << ", expected "
+             << expected << "." << endl;
+      }
+
+      /* Early out: some hits, the first one included, or none. */
+      mask = SegmentIntersectionKernel::intersectionMask(
+          dimension, C, D, proximalPoints, distalPoints, tolerances, n, true);
+      if ((mask & ~expected) != 0 || (mask & firstHit) != firstHit) {
+        numberOfFailures++;
+        cout << "Oops! Test " << test << " (instruction set "
+             << instructionSet << ", early out): mask " << mask
+             << ", expected " << expected << "." << endl;
+      }
+    }
+  }
+
+  cout << numberOfTests << " tests, " << numberOfHits << " intersections, "
+       << numberOfFailures << " failures." << endl;
+
+  return numberOfFailures == 0 ? 0 : 1;
+}
@@ -44,3 +44,7 @@ bool BifurcationSymmetry::pass(Segment segment) {
   /* Check if the degree of symmetry is more than _degreeOfSymmetry */
   return (degreeOfSymmetry >= _degreeOfSymmetry);
 }
+
+GeometricRestriction *BifurcationSymmetry::clone() {
+  return new BifurcationSymmetry(tree(), _degreeOfSymmetry);
+}
@@ -65,5 +65,12 @@ class BifurcationSymmetry : public GeometricRestriction {
    * restriction or false otherwise.
    */
   virtual bool pass(Segment segment);
+
+  /**
+   * @brief Create a copy of the restriction.
+   *
+   * @return The copy of the restriction.
+   */
+  virtual GeometricRestriction *clone();
 };
 #endif  //_CCOLAB_CCO_BIFURCATION_SYMMETRY_H
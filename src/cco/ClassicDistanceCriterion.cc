@@ -40,14 +40,29 @@ ClassicDistanceCriterion::ClassicDistanceCriterion(TreeModel *tree)
 }
 
 bool ClassicDistanceCriterion::eval(Point point) {
-  int i;
-  double d;
+  int i, j, k, count;
+  double proximalPoints[3 * _BATCHSIZE], distalPoints[3 * _BATCHSIZE],
+      distances[_BATCHSIZE];
+  Point proximalPoint, distalPoint;
 
-  for (i = tree()->begin(); i < tree()->end(); i++) {
-    d = _geometry->distanceFromSegment(point, tree()->proximalPoint(i),
-                                       tree()->distalPoint(i));
-    if (d < _minimumCriterionDistance) {
-      return false;
+  /* The endpoints are copied in batches for SegmentDistanceKernel. */
+  for (i = tree()->begin(); i < tree()->end(); i += _BATCHSIZE) {
+    count = std::min(_BATCHSIZE, tree()->end() - i);
+    for (j = 0; j < count; j++) {
+      proximalPoint = tree()->proximalPoint(i + j);
+      distalPoint = tree()->distalPoint(i + j);
+      for (k = 0; k < 3; k++) {
+        proximalPoints[3 * j + k] = proximalPoint.coordinates()[k];
+        distalPoints[3 * j + k] = distalPoint.coordinates()[k];
+      }
+    }
+    SegmentDistanceKernel::distancesFromSegments(
+        tree()->dimension(), point.coordinates(), proximalPoints,
+        distalPoints, nullptr, count, distances);
+    for (j = 0; j < count; j++) {
+      if (distances[j] < _minimumCriterionDistance) {
+        return false;
+      }
     }
   }
 
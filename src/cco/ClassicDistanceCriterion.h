@@ -26,10 +26,12 @@
  * @version 1.0
  * @date 2022-05-18
  */
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
 #include "geometry/Geometry.h"
+#include "geometry/SegmentDistanceKernel.h"
 #include "interface/DistanceCriterion.h"
 #include "tree/interface/TreeModel.h"
 
@@ -37,6 +39,12 @@
 #define _CCOLAB_CCO_CLASSICDISTANCECRITERION_H
 class ClassicDistanceCriterion : public DistanceCriterion {
  private:
+  /**
+   * @brief The number of segments whose distances are evaluated at once.
+   * 
+   */
+  static constexpr int _BATCHSIZE = 64;
+
   /**
    * @brief Value of the minimum criterion distance.
    * 
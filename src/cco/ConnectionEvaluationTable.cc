@@ -45,46 +45,67 @@ ConnectionEvaluationTable::ConnectionEvaluationTable(TreeModel *tree,
    * */
   _connections = new Connection[numberOfConnections];
   _reasonableConnections = new int[numberOfConnections];
-  withoutIntersection = new WithoutIntersection(_tree);
+  _sortedConnections = new int[numberOfConnections];
+  _trial = new TreeTrial(_tree);
+  withoutIntersection = new WithoutIntersection(_trial);
 }
 
 ConnectionEvaluationTable::~ConnectionEvaluationTable() {
   delete[] _connections;
   delete[] _reasonableConnections;
+  delete[] _sortedConnections;
+  delete withoutIntersection;
+  delete _trial;
 }
 
 TreeModel *ConnectionEvaluationTable::tree() { return _tree; }
 
-void ConnectionEvaluationTable::setTree(TreeModel *tree) { _tree = tree; }
+void ConnectionEvaluationTable::setTree(TreeModel *tree) {
+  _tree = tree;
+  _trial->setTree(tree);
+}
 
 void ConnectionEvaluationTable::reduce() {
-  int i, j, ID;
-  Segment *bifurcationSegment,
-      updatedBifurcationSegment(_tree->dimension()),
-      newSegment(_tree->dimension());
-  bool passGeometricRestriction;
+  int i, j;
   _currentNumberOfReasonableConnections = 0;
 
+  /* Sort the connections by the target function value. */
   for (i = 0; i < _currentNumberOfConnections; i++) {
-    passGeometricRestriction = true;
-
-    /* Do the connection. */
-    bifurcationSegment = _tree->segment(_connections[i].bifurcationSegmentID());
-    newSegment = _connections[i].newSegment();
-    updatedBifurcationSegment = _tree->growSegment(
-        _connections[i].bifurcationPoint(), *bifurcationSegment, newSegment);
-
-    /* Check for intersections. */
-    if (withoutIntersection->pass(updatedBifurcationSegment)) {
-      _reasonableConnections[_currentNumberOfReasonableConnections] = i;
-      _currentNumberOfReasonableConnections++;
+    j = i;
+    while (j > 0 &&
+           _connections[_sortedConnections[j - 1]].targetFunctionValue() >
+               _connections[i].targetFunctionValue()) {
+      _sortedConnections[j] = _sortedConnections[j - 1];
+      j--;
     }
+    _sortedConnections[j] = i;
+  }
 
-    /* Undo the connection. */
-    _tree->remove(newSegment);
+  /* Keep the first reasonable connection. */
+  for (i = 0; i < _currentNumberOfConnections; i++) {
+    if (isReasonable(_connections[_sortedConnections[i]])) {
+      _reasonableConnections[0] = _sortedConnections[i];
+      _currentNumberOfReasonableConnections = 1;
+      break;
+    }
   }
 }
 
+bool ConnectionEvaluationTable::isReasonable(Connection connection) {
+  bool pass;
+
+  /* Do the connection on the trial. */
+  _trial->connect(connection.bifurcationSegmentID(),
+                  connection.bifurcationPoint(), connection.newSegment());
+
+  /* Check for intersections. */
+  pass = withoutIntersection->pass(
+      *_trial->segment(connection.bifurcationSegmentID()));
+  _trial->clear();
+
+  return pass;
+}
+
 void ConnectionEvaluationTable::copy(Connection source,
                                      Connection *destination) {
   destination->setBifurcationSegmentID(source.bifurcationSegmentID());
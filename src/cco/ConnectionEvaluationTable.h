@@ -32,6 +32,7 @@
 #include "ValidSegment.h"
 #include "WithoutIntersection.h"
 #include "interface/GeometricRestriction.h"
+#include "tree/TreeTrial.h"
 #include "tree/interface/TreeModel.h"
 
 #ifndef _CCOLAB_CCO_CONNECTIONEVALUATIONTABLE_H
@@ -56,6 +57,13 @@ class ConnectionEvaluationTable {
    */
   int *_reasonableConnections;
 
+  /**
+   * @brief The connections sorted by the target function value (used by
+   * reduce()).
+   * 
+   */
+  int *_sortedConnections;
+
   /**
    * @brief The total number of connections.
    * 
@@ -81,6 +89,13 @@ class ConnectionEvaluationTable {
    */
   WithoutIntersection *withoutIntersection;
 
+  /**
+   * @brief The trial where the connections are checked, so the tree is
+   * never changed.
+   * 
+   */
+  TreeTrial *_trial;
+
   /**
    * @brief Copy a Connection objetc from source to destination.
    * 
@@ -122,9 +137,24 @@ class ConnectionEvaluationTable {
    * @brief Remove the invalid connections (ie, the connections not passing the
    * geometric restrcions.
    * 
+   * Only the optimal reasonable connection is ever used, so the connections
+   * are checked in the order of the target function value (and of addition
+   * on ties) up to the first reasonable one, which is the only reasonable
+   * connection kept. It usually takes a single check.
+   * 
    */
   void reduce();
 
+  /**
+   * @brief Check if a connection is reasonable (ie, it passes the geometric
+   * restrictions checked by reduce()). The tree is left unchanged.
+   * 
+   * @param connection The connection.
+   * @return Returns true if the connection is reasonable. Returns false
+   * otherwise.
+   */
+  bool isReasonable(Connection connection);
+
   /**
    * @brief Add a new connection.
    * 
@@ -167,7 +197,8 @@ class ConnectionEvaluationTable {
   int currentNumberOfConnections();
 
   /**
-   * @brief Get the current number of reasonable connections.
+   * @brief Get the current number of reasonable connections (one at most,
+   * see reduce()).
    * 
    * @return The current number of reasonable connections.
    */
@@ -49,7 +49,7 @@ ConstrainedConstructiveOptimization::ConstrainedConstructiveOptimization(
 
   int dimension = _tree->dimension(), intervalDivision = 5;
 
-  _distanceCriterion = new ClassicDistanceCriterion(_tree);
+  _distanceCriterion = new GridDistanceCriterion(_tree);
 
   /* Default functions */
   _terminalFlowFunction = new ConstantTerminalFlow(_tree);
@@ -133,6 +133,73 @@ void ConstrainedConstructiveOptimization::setMaximumNumberOfAttempts(
   _maximumNumberOfAttempts = maximumNumberOfAttempts;
 }
 
+int ConstrainedConstructiveOptimization::numberOfThreads() {
+  return _numberOfThreads;
+}
+
+void ConstrainedConstructiveOptimization::setNumberOfThreads(
+    int numberOfThreads) {
+  if (numberOfThreads < 1) {
+    throw invalid_argument("Oops! The number of threads must be positive.");
+  }
+  _numberOfThreads = numberOfThreads;
+}
+
+int ConstrainedConstructiveOptimization::reorderInterval() {
+  return _reorderInterval;
+}
+
+/**
+ *  A positive interval may change the tree grown: the candidate connections
+ *  are visited and their ties broken in index order, and renumbering changes
+ *  that order. The default 0 keeps the growth order.
+ **/
+void ConstrainedConstructiveOptimization::setReorderInterval(
+    int reorderInterval) {
+  if (reorderInterval < 0) {
+    throw invalid_argument(
+        "Oops! The reorder interval must not be negative.");
+  }
+  _reorderInterval = reorderInterval;
+}
+
+long ConstrainedConstructiveOptimization::numberOfAcceptedPoints() {
+  return _numberOfAcceptedPoints;
+}
+
+long ConstrainedConstructiveOptimization::numberOfRejectedPoints() {
+  return _numberOfRejectedPoints;
+}
+
+long ConstrainedConstructiveOptimization::numberOfAllocations() {
+  return _numberOfAllocations;
+}
+
+void ConstrainedConstructiveOptimization::optimizeConcurrently(
+    int *segmentIDs, int numberOfSegments, Segment newSegment,
+    GeometricOptimization **geometricOptimizations, Connection *connections,
+    WorkerPool *workers) {
+  std::atomic<int> nextSegment(0);
+
+  /* From now on the threads only read the tree. */
+  _tree->refresh();
+
+  /**
+   *  Each thread takes the next segment not optimized yet and optimizes it
+   *  with its own geometric optimization. The connections are stored by the
+   *  segment position, so they are the same of the serial loop, whatever
+   *  thread optimized them.
+   **/
+  auto task = [=, &nextSegment](int t) {
+    int i;
+    while ((i = nextSegment++) < numberOfSegments) {
+      connections[i] =
+          geometricOptimizations[t]->bifurcation(segmentIDs[i], newSegment);
+    }
+  };
+  workers->run(task);
+}
+
 void ConstrainedConstructiveOptimization::growRoot() {
   Segment root(_tree->dimension());
   double factor = 0.9;
@@ -170,8 +237,11 @@ void ConstrainedConstructiveOptimization::growRoot() {
 
 void ConstrainedConstructiveOptimization::grow() {
   Progress progress(_numberOfTerminals, "Growing tree");
-  Point point(_tree->dimension()), middle(_tree->dimension());
-  int i, Kterm, attempt, totalAttempts, *closestSegments;
+  Point point(_tree->dimension());
+  int i, t, Kterm, attempt, totalAttempts, *closestSegments;
+  long allocations;
+  _numberOfAcceptedPoints = 0;
+  _numberOfRejectedPoints = 0;
 
   /* Grow the root segment. */
   growRoot();
@@ -183,13 +253,26 @@ void ConstrainedConstructiveOptimization::grow() {
   ConnectionEvaluationTable connectionEvaluationTable(_tree,
                                                       _numberOfConnections);
 
-  Segment *bifurcationSegment, newSegment(_tree->dimension()),
-      updatedBifurcationSegment(_tree->dimension());
-  Geometry geometry(_tree->dimension());
+  Segment newSegment(_tree->dimension());
   Connection connection, optimalConnection;
   totalAttempts = 1;
 
-  /* Grow the tree. */
+  /**
+   *  Allocate all vectors and threads once. In the parallel mode each thread
+   *  needs its own copy of the geometric optimization (the first thread uses
+   *  the original one).
+   **/
+  GeometricOptimization **geometricOptimizations =
+      new GeometricOptimization *[_numberOfThreads];
+  Connection *connections = new Connection[_numberOfConnections];
+  WorkerPool workers(_numberOfThreads);
+  geometricOptimizations[0] = _geometricOptimization;
+  for (t = 1; t < _numberOfThreads; t++) {
+    geometricOptimizations[t] = _geometricOptimization->clone();
+  }
+
+  /* Grow the tree (counting the heap allocations, see AllocationCounter). */
+  allocations = AllocationCounter::numberOfAllocations();
   while (Kterm < _numberOfTerminals) {
     attempt = 0;
     /* Get a random point in Domain */
@@ -198,9 +281,11 @@ void ConstrainedConstructiveOptimization::grow() {
 
       /* Check distance criterion */
       if (_distanceCriterion->eval(point)) {
+        _numberOfAcceptedPoints++;
         break;
       }
 
+      _numberOfRejectedPoints++;
       attempt += 1;
       /* Relax distance criterion. */
       if (attempt > _maximumNumberOfAttempts) {
@@ -216,26 +301,28 @@ void ConstrainedConstructiveOptimization::grow() {
     /* Find the point's vicinity. */
     closestSegments = vicinity.atPoint(point);
 
-    for (i = 0; i < vicinity.currentNumberOfConnections(); i++) {
-      /* Do the connection. */
-      bifurcationSegment = _tree->segment(closestSegments[i]);
-      middle = geometry.middle(_tree->proximalPoint(closestSegments[i]),
-                               _tree->distalPoint(closestSegments[i]));
-      newSegment.setPoint(point);
-      newSegment.setFlow(_terminalFlowFunction->eval(newSegment));
-      updatedBifurcationSegment =
-          _tree->growSegment(middle, *bifurcationSegment, newSegment);
-      newSegment = _tree->right(updatedBifurcationSegment.ID());
-
-      /* Geometric optimization. */
-      connection =
-          _geometricOptimization->bifurcation(updatedBifurcationSegment);
-      if (!connection.empty()) {
-        connectionEvaluationTable.add(connection);
+    newSegment.setPoint(point);
+    newSegment.setFlow(_terminalFlowFunction->eval(newSegment));
+
+    if (_numberOfThreads > 1) {
+      /* Geometric optimizations in parallel (the tree is left unchanged). */
+      optimizeConcurrently(closestSegments,
+                           vicinity.currentNumberOfConnections(), newSegment,
+                           geometricOptimizations, connections, &workers);
+      for (i = 0; i < vicinity.currentNumberOfConnections(); i++) {
+        if (!connections[i].empty()) {
+          connectionEvaluationTable.add(connections[i]);
+        }
+      }
+    } else {
+      for (i = 0; i < vicinity.currentNumberOfConnections(); i++) {
+        /* Geometric optimization (the tree is left unchanged). */
+        connection = _geometricOptimization->bifurcation(closestSegments[i],
+                                                         newSegment);
+        if (!connection.empty()) {
+          connectionEvaluationTable.add(connection);
+        }
       }
-
-      /* Undo the connection. */
-      _tree->remove(newSegment);
     }
 
     /* Reduce bifurcations to reasonable connections. */
@@ -262,6 +349,14 @@ void ConstrainedConstructiveOptimization::grow() {
       /* Update distance criterion. */
       _distanceCriterion->update(Kterm);
 
+      /**
+       *  Renumber the segments in depth-first order (zero never does). It
+       *  may change the tree grown from here on.
+       **/
+      if (_reorderInterval > 0 && Kterm % _reorderInterval == 0) {
+        _tree->reorder();
+      }
+
       /* Update progress bar */
       progress.next();
 
@@ -276,4 +371,14 @@ void ConstrainedConstructiveOptimization::grow() {
     /* Reset Connection Evaluation Table. */
     connectionEvaluationTable.reset();
   }
+  _numberOfAllocations = AllocationCounter::numberOfAllocations() - allocations;
+
+  /* The evaluations of the copies count as the original ones. */
+  for (t = 1; t < _numberOfThreads; t++) {
+    _geometricOptimization->addNumberOfEvaluations(
+        geometricOptimizations[t]->numberOfEvaluations());
+    delete geometricOptimizations[t];
+  }
+  delete[] geometricOptimizations;
+  delete[] connections;
 }
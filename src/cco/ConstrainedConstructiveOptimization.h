@@ -31,17 +31,21 @@
  * @date 2022-05-18
  */
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <string>
 
 #include "ClassicDistanceCriterion.h"
+#include "GridDistanceCriterion.h"
+#include "WorkerPool.h"
 #include "Connection.h"
 #include "ConnectionEvaluationTable.h"
 #include "domain/interface/Domain.h"
 #include "interface/GeometricOptimization.h"
 #include "interface/TargetFunction.h"
 #include "interface/TerminalFlowFunction.h"
+#include "progress/AllocationCounter.h"
 #include "progress/Progress.h"
 #include "tree/TreeConnectionSearch.h"
 #include "tree/interface/TreeModel.h"
@@ -58,6 +62,11 @@ class ConstrainedConstructiveOptimization {
   int _numberOfTerminals = 0;
   int _numberOfConnections = 20;
   int _maximumNumberOfAttempts = 10;
+  int _numberOfThreads = 1;
+  int _reorderInterval = 0;
+  long _numberOfAcceptedPoints = 0;
+  long _numberOfRejectedPoints = 0;
+  long _numberOfAllocations = 0;
   double _radiusExpoent = 0.0;
   double _lengthExpoent = 0.0;
   TargetFunction *_targetFunction;
@@ -66,6 +75,10 @@ class ConstrainedConstructiveOptimization {
   Domain *_domain;
   TreeModel *_tree;
   DistanceCriterion *_distanceCriterion;
+  void optimizeConcurrently(int *segmentIDs, int numberOfSegments,
+                            Segment newSegment,
+                            GeometricOptimization **geometricOptimizations,
+                            Connection *connections, WorkerPool *workers);
 
  public:
   ConstrainedConstructiveOptimization(Domain *domain, TreeModel *tree,
@@ -87,6 +100,13 @@ class ConstrainedConstructiveOptimization {
   void setLengthExpoent(double length);
   int maximumNumberOfAttempts();
   void setMaximumNumberOfAttempts(int maximumNumberOfAttempts);
+  int numberOfThreads();
+  void setNumberOfThreads(int numberOfThreads);
+  int reorderInterval();
+  void setReorderInterval(int reorderInterval);
+  long numberOfAcceptedPoints();
+  long numberOfRejectedPoints();
+  long numberOfAllocations();
   TargetFunction *targetFunction();
   void setTargetFunction(TargetFunction *targetFunction);
   TerminalFlowFunction *terminalFlowFunction();
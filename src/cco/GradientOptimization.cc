@@ -0,0 +1,290 @@
+/**
+ * @file GradientOptimization.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "GradientOptimization.h"
+
+GradientOptimization::GradientOptimization(Domain *domain, TreeModel *tree,
+                                           TargetFunction *targetFunction)
+    : GradientOptimization(domain, tree, targetFunction, 0.0) {}
+
+GradientOptimization::GradientOptimization(Domain *domain, TreeModel *tree,
+                                           TargetFunction *targetFunction,
+                                           double degreeOfSymmetry)
+    : GeometricOptimization(domain, tree, targetFunction) {
+  int numberOfGeometricRestrictions = 2;
+  _degreeOfSymmetry = degreeOfSymmetry;
+  _geometry = new Geometry(domain->dimension());
+  _targetFunction = targetFunction;
+  _trial = new TreeTrial(tree);
+  GeometricRestriction **_geometricRestrictions =
+      new GeometricRestriction *[numberOfGeometricRestrictions];
+  _geometricRestrictions[0] = new ValidSegment(tree);
+  _geometricRestrictions[1] = new BifurcationSymmetry(tree, _degreeOfSymmetry);
+  setGeometricRestrictions(_geometricRestrictions,
+                           numberOfGeometricRestrictions);
+}
+
+GradientOptimization::~GradientOptimization() {
+  delete _geometry;
+  delete _trial;
+}
+
+void GradientOptimization::setTriangle(Point segmentProximalPoint,
+                                       Point oldBifurcationPoint,
+                                       Point connectionSegmentDistalPoint,
+                                       Point newSegmentDistalPoint) {
+  bifurcationTriangle(_geometry, segmentProximalPoint, oldBifurcationPoint,
+                      connectionSegmentDistalPoint, newSegmentDistalPoint, &_Xi,
+                      &_Xj, &_Xnew);
+}
+
+Point GradientOptimization::map(double a, double b) {
+  /* map(a, b) = (1 - a - b)*Xi + a*Xnew + b*Xj */
+  return _geometry->add(
+      _geometry->add(_geometry->scalarProduct(1 - a - b, _Xi),
+                     _geometry->scalarProduct(a, _Xnew)),
+      _geometry->scalarProduct(b, _Xj));
+}
+
+void GradientOptimization::project(double *a, double *b) {
+  double excess;
+
+  /* Project onto the line a + b = 1. */
+  if (*a + *b > 1.0) {
+    excess = 0.5 * (*a + *b - 1.0);
+    *a -= excess;
+    *b -= excess;
+  }
+
+  /* Project onto the lines a = 0 and b = 0. */
+  if (*a < 0.0) {
+    *a = 0.0;
+    *b = std::min(std::max(*b, 0.0), 1.0);
+  }
+
+  if (*b < 0.0) {
+    *b = 0.0;
+    *a = std::min(std::max(*a, 0.0), 1.0);
+  }
+}
+
+bool GradientOptimization::evalAt(Segment segment, double a, double b,
+                                  double *value) {
+  /* Move the bifurcation to the new bifurcation point. */
+  tree()->moveDistalPoint(segment.ID(), map(a, b));
+
+  /* Check the geometric restrictions. */
+  if (!passRestrictions(segment)) {
+    return false;
+  }
+
+  *value =
+      tree() == _trial ? evalTargetFunction(_trial) : evalTargetFunction();
+
+  return true;
+}
+
+double GradientOptimization::derivative(Segment segment, double a, double b,
+                                        double value, double da, double db) {
+  double nextA, nextB, nextValue;
+
+  /* Forward difference. */
+  nextA = a + _differenceStep * da;
+  nextB = b + _differenceStep * db;
+  if (nextA + nextB <= 1.0 && evalAt(segment, nextA, nextB, &nextValue)) {
+    return (nextValue - value) / _differenceStep;
+  }
+
+  /* Backward difference. */
+  nextA = a - _differenceStep * da;
+  nextB = b - _differenceStep * db;
+  if (nextA >= 0.0 && nextB >= 0.0 &&
+      evalAt(segment, nextA, nextB, &nextValue)) {
+    return (value - nextValue) / _differenceStep;
+  }
+
+  return 0.0;
+}
+
+Connection GradientOptimization::bifurcation(Segment segment) {
+  int i, j, iteration, numberOfStarts = 4, fallbackDivision = 4;
+  double a, b, value, nextA, nextB, nextValue, gradientA, gradientB,
+      directionA, directionB, norm, uu, uv, vv, determinant,
+      step = _initialStep;
+  double startA[] = {1.0 / 3.0, 0.5, 0.0, 0.5},
+         startB[] = {1.0 / 3.0, 0.0, 0.5, 0.5};
+  bool hasMinimum = false, hasGradient = false;
+  Point segmentProximalPoint = tree()->proximalPoint(segment.ID());
+  Point oldBifurcationPoint = segment.point();
+  Point newSegmentDistalPoint = tree()->distalPoint(segment.right());
+  Point connectionSegmentDistalPoint = tree()->distalPoint(segment.left());
+  Connection connection;
+
+  setTriangle(segmentProximalPoint, oldBifurcationPoint,
+              connectionSegmentDistalPoint, newSegmentDistalPoint);
+
+  /**
+   *  The barycentric coordinates distort the distances, so the gradient is
+   *  corrected by the metric of the map, G = [u.u u.v; u.v v.v], where
+   *  u = Xnew - Xi and v = Xj - Xi. The direction -G^{-1} gradient is the
+   *  steepest descent on the space where the bifurcation point lives.
+   **/
+  uu = _geometry->dot(_geometry->subtract(_Xnew, _Xi),
+                      _geometry->subtract(_Xnew, _Xi));
+  uv = _geometry->dot(_geometry->subtract(_Xnew, _Xi),
+                      _geometry->subtract(_Xj, _Xi));
+  vv = _geometry->dot(_geometry->subtract(_Xj, _Xi),
+                      _geometry->subtract(_Xj, _Xi));
+  determinant = uu * vv - uv * uv;
+
+  /**
+   *  Start at the centroid of the triangle. If it does not pass the
+   *  geometric restrictions, start at the middle of some edge.
+   **/
+  for (i = 0; i < numberOfStarts && !hasMinimum; i++) {
+    a = startA[i];
+    b = startB[i];
+    hasMinimum = evalAt(segment, a, b, &value);
+  }
+
+  /* Otherwise, start at the best point of a coarse grid. */
+  if (!hasMinimum) {
+    for (i = 0; i <= fallbackDivision; i++) {
+      for (j = 0; i + j <= fallbackDivision; j++) {
+        nextA = (double)i / fallbackDivision;
+        nextB = (double)j / fallbackDivision;
+        if (evalAt(segment, nextA, nextB, &nextValue) &&
+            (!hasMinimum || nextValue < value)) {
+          a = nextA;
+          b = nextB;
+          value = nextValue;
+          hasMinimum = true;
+        }
+      }
+    }
+  }
+
+  for (iteration = 0; hasMinimum && iteration < _maximumNumberOfIterations &&
+                      step >= _tolerance;
+       iteration++) {
+    /* The gradient only changes when the point changes. */
+    if (!hasGradient) {
+      gradientA = derivative(segment, a, b, value, 1.0, 0.0);
+      gradientB = derivative(segment, a, b, value, 0.0, 1.0);
+      if (determinant > 0.0) {
+        directionA = (vv * gradientA - uv * gradientB) / determinant;
+        directionB = (uu * gradientB - uv * gradientA) / determinant;
+      } else {
+        directionA = gradientA;
+        directionB = gradientB;
+      }
+      hasGradient = true;
+    }
+
+    norm = sqrt(directionA * directionA + directionB * directionB);
+    if (norm == 0.0) {
+      break;
+    }
+
+    nextA = a - step * directionA / norm;
+    nextB = b - step * directionB / norm;
+    project(&nextA, &nextB);
+
+    if (evalAt(segment, nextA, nextB, &nextValue) && nextValue < value) {
+      a = nextA;
+      b = nextB;
+      value = nextValue;
+      hasGradient = false;
+      step = std::min(2.0 * step, 1.0);
+    } else {
+      step *= 0.5;
+    }
+  }
+
+  if (hasMinimum) {
+    connection = Connection(segment.ID(), map(a, b),
+                            tree()->right(segment.ID()), value);
+  }
+
+  /* Move back the bifurcation to the old bifurcation point. */
+  tree()->moveDistalPoint(segment.ID(), oldBifurcationPoint);
+
+  return connection;
+}
+
+Connection GradientOptimization::bifurcation(int segmentID,
+                                             Segment newSegment) {
+  Connection connection;
+  TreeModel *tree = GeometricOptimization::tree();
+
+  if (_trial->tree() != tree) {
+    _trial->setTree(tree);
+  }
+
+  /* Connect the new segment to the middle of the segment on the trial. */
+  _trial->connect(segmentID,
+                  _geometry->middle(tree->proximalPoint(segmentID),
+                                    tree->distalPoint(segmentID)),
+                  newSegment);
+
+  /* Optimize on the trial, restrictions included. */
+  setTree(_trial);
+  connection = bifurcation(*_trial->segment(segmentID));
+  setTree(tree);
+  _trial->clear();
+
+  return connection;
+}
+
+void GradientOptimization::setMaximumNumberOfIterations(int value) {
+  _maximumNumberOfIterations = value;
+}
+
+void GradientOptimization::setInitialStep(double value) {
+  _initialStep = value;
+}
+
+void GradientOptimization::setTolerance(double value) { _tolerance = value; }
+
+void GradientOptimization::setDifferenceStep(double value) {
+  _differenceStep = value;
+}
+
+GeometricOptimization *GradientOptimization::clone() {
+  GradientOptimization *gradientOptimization = new GradientOptimization(
+      domain(), tree(), _targetFunction->clone(), _degreeOfSymmetry);
+
+  cloneRestrictionsInto(gradientOptimization);
+  gradientOptimization->_maximumNumberOfIterations =
+      _maximumNumberOfIterations;
+  gradientOptimization->_initialStep = _initialStep;
+  gradientOptimization->_tolerance = _tolerance;
+  gradientOptimization->_differenceStep = _differenceStep;
+
+  return gradientOptimization;
+}
@@ -0,0 +1,269 @@
+/**
+ * @file GradientOptimization.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "BifurcationSymmetry.h"
+#include "TargetVolume.h"
+#include "ValidSegment.h"
+#include "geometry/Geometry.h"
+#include "interface/GeometricOptimization.h"
+#include "tree/TreeTrial.h"
+using std::cout;
+using std::endl;
+
+#ifndef _CCOLAB_CCO_GRADIENTOPTIMIZATION_H
+#define _CCOLAB_CCO_GRADIENTOPTIMIZATION_H
+/**
+ * @brief Geometric optimization by projected gradient descent.
+ *
+ * The bifurcation point moves on the same triangle searched by
+ * SimpleOptimization, given by the barycentric coordinates (a, b) with
+ * a >= 0, b >= 0 and a + b <= 1. The descent starts at the centroid of the
+ * triangle and steps against the gradient of the target function, evaluated
+ * by finite differences and corrected by the metric of the triangle (so it
+ * is the steepest descent for the bifurcation point itself). Every step is
+ * projected back onto the triangle. A point that does not pass the geometric
+ * restrictions is never accepted.
+ *
+ * The step grows after an improvement and is halved otherwise, until it is
+ * smaller than the tolerance.
+ */
+class GradientOptimization : public GeometricOptimization {
+ private:
+  /**
+   * @brief The target function to be evaluated.
+   *
+   */
+  TargetFunction *_targetFunction;
+
+  /**
+   * @brief Geometry object to do some geometric calculations.
+   *
+   */
+  Geometry *_geometry;
+
+  /**
+   * @brief The dregree of symmetry on some bifurcation is the ratio between
+   * the minimum and maximum radius of the descendent segments.
+   *
+   */
+  double _degreeOfSymmetry = 0.0;
+
+  /**
+   * @brief The trial where the connections are optimized.
+   *
+   */
+  TreeTrial *_trial;
+
+  /**
+   * @brief The maximum number of descent steps.
+   *
+   */
+  int _maximumNumberOfIterations = 12;
+
+  /**
+   * @brief The first step length (on barycentric coordinates).
+   *
+   */
+  double _initialStep = 0.3;
+
+  /**
+   * @brief The descent stops when the step is shorter than the tolerance (on
+   * barycentric coordinates).
+   *
+   */
+  double _tolerance = 0.02;
+
+  /**
+   * @brief The increment of the finite differences (on barycentric
+   * coordinates).
+   *
+   */
+  double _differenceStep = 0.001;
+
+  /**
+   * @brief The vertices of the triangle: map(0, 0), map(0, 1) and map(1, 0).
+   *
+   */
+  Point _Xi, _Xj, _Xnew;
+
+  /**
+   * @brief Set the triangle given by the segment proximal point, the
+   * connection segment distal point and the new segment distal point.
+   *
+   * @param segmentProximalPoint The proximal point of the segment.
+   * @param oldBifurcationPoint The current bifurcation point.
+   * @param connectionSegmentDistalPoint The distal point of the connection
+   * segment.
+   * @param newSegmentDistalPoint The distal point of the new segment.
+   */
+  void setTriangle(Point segmentProximalPoint, Point oldBifurcationPoint,
+                   Point connectionSegmentDistalPoint,
+                   Point newSegmentDistalPoint);
+
+  /**
+   * @brief Map the barycentric coordinates to the bifurcation point.
+   *
+   * @param a The coordinate towards the new segment distal point.
+   * @param b The coordinate towards the connection segment distal point.
+   * @return The bifurcation point.
+   */
+  Point map(double a, double b);
+
+  /**
+   * @brief Project the barycentric coordinates onto the triangle.
+   *
+   * @param a The coordinate towards the new segment distal point.
+   * @param b The coordinate towards the connection segment distal point.
+   */
+  void project(double *a, double *b);
+
+  /**
+   * @brief Move the bifurcation to the point and evaluate the target
+   * function.
+   *
+   * @param segment The bifurcation segment.
+   * @param a The coordinate towards the new segment distal point.
+   * @param b The coordinate towards the connection segment distal point.
+   * @param value The value of the target function (only if it passes the
+   * geometric restrictions).
+   * @return Returns true if the bifurcation passes the geometric
+   * restrictions. Returns false otherwise.
+   */
+  bool evalAt(Segment segment, double a, double b, double *value);
+
+  /**
+   * @brief Evaluate one partial derivative by finite differences: forward if
+   * the forward point is feasible, backward otherwise, or zero.
+   *
+   * @param segment The bifurcation segment.
+   * @param a The coordinate towards the new segment distal point.
+   * @param b The coordinate towards the connection segment distal point.
+   * @param value The value of the target function at (a, b).
+   * @param da The direction of the derivative on a.
+   * @param db The direction of the derivative on b.
+   * @return The partial derivative.
+   */
+  double derivative(Segment segment, double a, double b, double value,
+                    double da, double db);
+
+ public:
+  /**
+   * @brief Construct a new Gradient Optimization object.
+   *
+   * @param domain The domain where the tree grows.
+   * @param tree The tree.
+   * @param targetFunction The target function to be evaluated.
+   */
+  GradientOptimization(Domain *domain, TreeModel *tree,
+                       TargetFunction *targetFunction);
+
+  /**
+   * @brief Construct a new Gradient Optimization object.
+   *
+   * @param domain The domain where the tree grows.
+   * @param tree The tree.
+   * @param targetFunction The target function to be evaluated.
+   * @param degreeOfSymmetry The minimum degree of symmetry allowed on
+   * bifurcations.
+   */
+  GradientOptimization(Domain *domain, TreeModel *tree,
+                       TargetFunction *targetFunction,
+                       double degreeOfSymmetry);
+
+  /**
+   * @brief Destroy the Gradient Optimization object.
+   *
+   */
+  ~GradientOptimization();
+
+  /**
+   * @brief Get the connection that minimize the target function for the
+   * bifurcation segment.
+   *
+   * @param segment The bifurcation segment.
+   * @return Connection The information about the connection for the given
+   * segment.
+   */
+  virtual Connection bifurcation(Segment segment);
+
+  /**
+   * @brief Get the connection of the new segment to the segment.
+   *
+   * The connection is optimized on a trial of the tree, so the tree is never
+   * changed.
+   *
+   * @param segmentID The index of the segment to connect.
+   * @param newSegment The new segment.
+   * @return Connection The information about the connection.
+   */
+  virtual Connection bifurcation(int segmentID, Segment newSegment);
+
+  /**
+   * @brief Set the maximum number of descent steps.
+   *
+   * @param value The maximum number of descent steps.
+   */
+  void setMaximumNumberOfIterations(int value);
+
+  /**
+   * @brief Set the first step length (on barycentric coordinates).
+   *
+   * @param value The first step length.
+   */
+  void setInitialStep(double value);
+
+  /**
+   * @brief Set the tolerance of the step length (on barycentric
+   * coordinates).
+   *
+   * @param value The tolerance.
+   */
+  void setTolerance(double value);
+
+  /**
+   * @brief Set the increment of the finite differences (on barycentric
+   * coordinates).
+   *
+   * @param value The increment.
+   */
+  void setDifferenceStep(double value);
+
+  /**
+   * @brief Create a copy of the geometric optimization, with copies of the
+   * target function and of the geometric restrictions.
+   *
+   * @return The copy of the geometric optimization.
+   */
+  virtual GeometricOptimization *clone();
+};
+#endif  //_CCOLAB_CCO_GRADIENTOPTIMIZATION_H
@@ -0,0 +1,70 @@
+/**
+ * @file GridDistanceCriterion.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "GridDistanceCriterion.h"
+
+GridDistanceCriterion::GridDistanceCriterion(TreeModel *tree)
+    : ClassicDistanceCriterion(tree) {
+  setTree(tree);
+}
+
+GridDistanceCriterion::~GridDistanceCriterion() {
+  int i;
+  for (i = 0; i < _numberOfGrids; i++) {
+    delete _grids[i];
+  }
+  delete[] _grids;
+}
+
+void GridDistanceCriterion::setTree(TreeModel *tree) {
+  int i;
+  TreeSegmentGrid **grids;
+
+  ClassicDistanceCriterion::setTree(tree);
+
+  for (i = 0; i < _numberOfGrids; i++) {
+    if (_grids[i]->tree() == tree) {
+      _grid = _grids[i];
+      return;
+    }
+  }
+
+  grids = new TreeSegmentGrid *[_numberOfGrids + 1];
+  for (i = 0; i < _numberOfGrids; i++) {
+    grids[i] = _grids[i];
+  }
+  grids[_numberOfGrids] = new TreeSegmentGrid(tree);
+  delete[] _grids;
+  _grids = grids;
+  _grid = _grids[_numberOfGrids];
+  _numberOfGrids++;
+}
+
+bool GridDistanceCriterion::eval(Point point) {
+  return !_grid->hasSegmentCloser(point, minimumDistanceCriterion());
+}
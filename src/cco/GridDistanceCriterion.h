@@ -0,0 +1,95 @@
+/**
+ * @file GridDistanceCriterion.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "ClassicDistanceCriterion.h"
+#include "tree/TreeSegmentGrid.h"
+#include "tree/interface/TreeModel.h"
+
+#ifndef _CCOLAB_CCO_GRIDDISTANCECRITERION_H
+#define _CCOLAB_CCO_GRIDDISTANCECRITERION_H
+/**
+ * @brief The classic distance criterion evaluated on a uniform grid of the
+ * tree segments (TreeSegmentGrid), so each evaluation checks only the
+ * segments of the cells around the point instead of every segment.
+ * 
+ * The minimum distance, its relaxation and its update are the ones of
+ * ClassicDistanceCriterion, and so are the results. The grid follows the
+ * minimum distance, and it is rebuilt only when the distance changes too
+ * much. Each tree set (as the forests do for every tree) keeps its own grid.
+ */
+class GridDistanceCriterion : public ClassicDistanceCriterion {
+ private:
+  /**
+   * @brief The grid of each tree set so far.
+   * 
+   */
+  TreeSegmentGrid **_grids = nullptr;
+
+  /**
+   * @brief The number of grids.
+   * 
+   */
+  int _numberOfGrids = 0;
+
+  /**
+   * @brief The grid of the current tree.
+   * 
+   */
+  TreeSegmentGrid *_grid = nullptr;
+
+ public:
+  /**
+   * @brief Construct a new Grid Distance Criterion object.
+   * 
+   * @param tree The tree to evaluate distance.
+   */
+  explicit GridDistanceCriterion(TreeModel *tree);
+
+  /**
+   * @brief Destroy the Grid Distance Criterion object.
+   * 
+   */
+  ~GridDistanceCriterion();
+
+  /**
+   * @brief Set the tree (its grid is created the first time).
+   * 
+   * @param tree The tree to be set.
+   */
+  virtual void setTree(TreeModel *tree);
+
+  /**
+   * @brief Evaluate the distance from point to tree.
+   * 
+   * @param point The point to evaluate the distance to tree.
+   * @return Returns true if the distance from point to tree is greater
+   * than the minimum distance. Returns false otherwise. 
+   */
+  virtual bool eval(Point point);
+};
+#endif //_CCOLAB_CCO_GRIDDISTANCECRITERION_H
@@ -38,6 +38,8 @@ SimpleOptimization::SimpleOptimization(Domain *domain, TreeModel *tree,
   _geometry = new Geometry(domain->dimension());
   _intervalDivision = intervalDivision;
   _targetFunction = targetFunction;
+  _trial = new TreeTrial(tree);
+  allocateGrid();
   GeometricRestriction **_geometricRestrictions =
       new GeometricRestriction *[numberOfGeometricRestrictions];
   _geometricRestrictions[0] = new ValidSegment(tree);
@@ -56,6 +58,8 @@ SimpleOptimization::SimpleOptimization(Domain *domain, TreeModel *tree,
   _geometry = new Geometry(domain->dimension());
   _intervalDivision = intervalDivision;
   _targetFunction = targetFunction;
+  _trial = new TreeTrial(tree);
+  allocateGrid();
   GeometricRestriction **_geometricRestrictions =
       new GeometricRestriction *[numberOfGeometricRestrictions];
   _geometricRestrictions[0] = new ValidSegment(tree);
@@ -64,34 +68,52 @@ SimpleOptimization::SimpleOptimization(Domain *domain, TreeModel *tree,
                            numberOfGeometricRestrictions);
 }
 
-Connection SimpleOptimization::bifurcation(Segment segment) {
-  int i, j, newSegment = segment.right(), connectionSegment = segment.left(),
-            numberOfPoints = _intervalDivision + 1, line, column;
-  double a, b, step = 1.0 / _intervalDivision, offset = 0.3;
-  double evaluatedTargetFunction, minimumEvaluatedTargetFunction = 1e15;
-  bool hasMinimum = false;
-  Connection *minimumConnection;
-  Point segmentProximalPoint = tree()->proximalPoint(segment.ID());
-  Point oldBifurcationPoint = segment.point();
-  Point newSegmentDistalPoint = tree()->distalPoint(newSegment);
-  Point connectionSegmentDistalPoint = tree()->distalPoint(connectionSegment);
-  Point optimalBifurcationPoint, newBifurcationPoint, mapPointA, mapPointB,
-      mapPointC;
-  Point Xi = _geometry->add(
-      segmentProximalPoint,
-      _geometry->scalarProduct(offset,
-                               _geometry->subtract(connectionSegmentDistalPoint,
-                                                   segmentProximalPoint)));
-  Point Xj = _geometry->add(
-      segmentProximalPoint,
-      _geometry->scalarProduct(1.0 - offset,
-                               _geometry->subtract(connectionSegmentDistalPoint,
-                                                   segmentProximalPoint)));
-  Point Xnew = _geometry->add(
-      newSegmentDistalPoint,
-      _geometry->scalarProduct(
-          offset,
-          _geometry->subtract(oldBifurcationPoint, newSegmentDistalPoint)));
+SimpleOptimization::~SimpleOptimization() {
+  deallocateWorkers();
+  delete _geometry;
+  delete _trial;
+  delete[] _gridPoints;
+  delete[] _gridA;
+  delete[] _gridB;
+  delete[] _gridValues;
+  delete[] _gridPasses;
+}
+
+void SimpleOptimization::allocateGrid() {
+  delete[] _gridPoints;
+  delete[] _gridA;
+  delete[] _gridB;
+  delete[] _gridValues;
+  delete[] _gridPasses;
+
+  /**
+   *  Allocate all vectors once. It speed up the code because later it wont
+   *  need to create/destroy objects for each bifurcation.
+   **/
+  _numberOfGridPoints = (_intervalDivision + 1) * (_intervalDivision + 2) / 2;
+  _gridPoints = new Point[_numberOfGridPoints];
+  _gridA = new double[_numberOfGridPoints];
+  _gridB = new double[_numberOfGridPoints];
+  _gridValues = new double[_numberOfGridPoints];
+  _gridPasses = new bool[_numberOfGridPoints];
+  _currentNumberOfGridPoints = 0;
+}
+
+void SimpleOptimization::setTriangle(Point segmentProximalPoint,
+                                     Point oldBifurcationPoint,
+                                     Point connectionSegmentDistalPoint,
+                                     Point newSegmentDistalPoint) {
+  bifurcationTriangle(_geometry, segmentProximalPoint, oldBifurcationPoint,
+                      connectionSegmentDistalPoint, newSegmentDistalPoint, &_Xi,
+                      &_Xj, &_Xnew);
+}
+
+void SimpleOptimization::evalGrid(double originA, double originB, double size,
+                                  bool hasEvaluated, double evaluatedA,
+                                  double evaluatedB) {
+  int k = 0, numberOfPoints = _intervalDivision + 1, line, column;
+  double a, b, step = 1.0 / _intervalDivision, tolerance = 1e-12;
+  Point mapPointA, mapPointB, mapPointC;
 
   for (line = numberOfPoints; line >= 1; line--) {
     for (column = 1; column <= line; column++) {
@@ -105,46 +127,273 @@ Connection SimpleOptimization::bifurcation(Segment segment) {
        *    (1, 0), and (0, 1) in such a way that map(0, 0) = Xi,
        *    map(1, 0) = Xnew, and map(0, 1) = Xj.
        **/
-      a = (column - 1) * step;
-      b = (numberOfPoints - line) * step;
-      mapPointA = _geometry->scalarProduct(1 - a - b, Xi);
-      mapPointB = _geometry->scalarProduct(a, Xnew);
-      mapPointC = _geometry->scalarProduct(b, Xj);
-      newBifurcationPoint =
+      a = originA + size * ((column - 1) * step);
+      b = originB + size * ((numberOfPoints - line) * step);
+
+      /* Skip the points out of the triangle and the evaluated point. */
+      if (a < -tolerance || b < -tolerance || a + b > 1.0 + tolerance) {
+        continue;
+      }
+      if (hasEvaluated && fabs(a - evaluatedA) < tolerance &&
+          fabs(b - evaluatedB) < tolerance) {
+        continue;
+      }
+
+      mapPointA = _geometry->scalarProduct(1 - a - b, _Xi);
+      mapPointB = _geometry->scalarProduct(a, _Xnew);
+      mapPointC = _geometry->scalarProduct(b, _Xj);
+      _gridA[k] = a;
+      _gridB[k] = b;
+      _gridPoints[k++] =
           _geometry->add(_geometry->add(mapPointA, mapPointB), mapPointC);
+    }
+  }
+  _currentNumberOfGridPoints = k;
+}
+
+void SimpleOptimization::evalGridValues(Segment segment) {
+  int k;
+  for (k = 0; k < _currentNumberOfGridPoints; k++) {
+    /* Move the bifurcation to the new bifurcation point. */
+    tree()->moveDistalPoint(segment.ID(), _gridPoints[k]);
+
+    /* Check the geometric restrictions. */
+    _gridPasses[k] = passRestrictions(segment);
+    if (_gridPasses[k]) {
+      /* Evaluate the target function. */
+      _gridValues[k] = tree() == _trial ? evalTargetFunction(_trial)
+                                        : evalTargetFunction();
+    }
+  }
+}
 
-      /* Move the bifurcation to the new bifurcation point. */
-      tree()->moveDistalPoint(segment.ID(), newBifurcationPoint);
+void SimpleOptimization::evalGridValuesConcurrently(Segment segment,
+                                                    Segment newSegment) {
+  TreeModel *tree = GeometricOptimization::tree();
+  std::atomic<int> nextGridPoint(0);
 
-      /* Check the geometric restrictions. */
-      if (passRestrictions(segment)) {
-        /* Evaluate the target function. */
-        evaluatedTargetFunction = _targetFunction->eval();
+  if (_workers[0]->tree() != tree) {
+    allocateWorkers();
+  }
+
+  /* From now on the threads only read the tree. */
+  tree->refresh();
+
+  auto task = [=, &nextGridPoint](int t) {
+    int k;
+    while ((k = nextGridPoint++) < _currentNumberOfGridPoints) {
+      _gridPasses[k] = _workers[t]->evalGridPoint(
+          segment, newSegment, _gridPoints[k], &_gridValues[k]);
+    }
+  };
+  _pool->run(task);
+}
+
+bool SimpleOptimization::evalGridPoint(Segment segment, Segment newSegment,
+                                       Point bifurcationPoint,
+                                       double *value) {
+  bool pass;
+  TreeModel *tree = GeometricOptimization::tree();
+
+  if (_trial->tree() != tree) {
+    _trial->setTree(tree);
+  }
+
+  _trial->connect(segment.ID(), bifurcationPoint, newSegment);
+  setTree(_trial);
+  pass = passRestrictions(segment);
+  if (pass) {
+    *value = evalTargetFunction(_trial);
+  }
+  setTree(tree);
+  _trial->clear();
+
+  return pass;
+}
+
+Connection SimpleOptimization::optimize(Segment segment, Segment newSegment,
+                                        bool concurrently) {
+  int k, level;
+  double minimumEvaluatedTargetFunction = 1e15, originA = 0.0, originB = 0.0,
+         size = 1.0, optimalA = 0.0, optimalB = 0.0;
+  bool hasMinimum = false;
+  Point optimalBifurcationPoint;
+  TreeModel *tree = concurrently ? _trial : GeometricOptimization::tree();
+  Point oldBifurcationPoint = segment.point();
+  Connection connection;
+
+  setTriangle(tree->proximalPoint(segment.ID()), oldBifurcationPoint,
+              tree->distalPoint(segment.left()),
+              tree->distalPoint(segment.right()));
 
-        /* Store the connection with minimum target function value. */
-        if (evaluatedTargetFunction < minimumEvaluatedTargetFunction) {
-          minimumEvaluatedTargetFunction = evaluatedTargetFunction;
-          optimalBifurcationPoint = newBifurcationPoint;
-          hasMinimum = true;
-        }
+  for (level = 0; level < _numberOfLevels; level++) {
+    evalGrid(originA, originB, size, hasMinimum, optimalA, optimalB);
+    if (concurrently) {
+      evalGridValuesConcurrently(segment, newSegment);
+    } else {
+      evalGridValues(segment);
+    }
+
+    /**
+     *  Take the minimum in the order of the grid (and of the levels), so the
+     *  ties are broken in the same way by the serial and the parallel
+     *  evaluations.
+     **/
+    for (k = 0; k < _currentNumberOfGridPoints; k++) {
+      if (_gridPasses[k] && _gridValues[k] < minimumEvaluatedTargetFunction) {
+        minimumEvaluatedTargetFunction = _gridValues[k];
+        optimalBifurcationPoint = _gridPoints[k];
+        optimalA = _gridA[k];
+        optimalB = _gridB[k];
+        hasMinimum = true;
       }
     }
+
+    if (!hasMinimum) {
+      break;
+    }
+
+    /* Refine the triangle with half the size centered at the minimum. */
+    size *= 0.5;
+    originA = optimalA - size / 3.0;
+    originB = optimalB - size / 3.0;
   }
 
   if (hasMinimum) {
-    minimumConnection = new Connection(segment.ID(), optimalBifurcationPoint,
-                                       tree()->right(segment.ID()),
-                                       minimumEvaluatedTargetFunction);
-  } else {
-    minimumConnection = new Connection();
+    connection = Connection(segment.ID(), optimalBifurcationPoint,
+                            tree->right(segment.ID()),
+                            minimumEvaluatedTargetFunction);
   }
 
   /* Move back the bifurcation to the old bifurcation point. */
-  tree()->moveDistalPoint(segment.ID(), oldBifurcationPoint);
+  if (!concurrently) {
+    tree->moveDistalPoint(segment.ID(), oldBifurcationPoint);
+  }
+
+  return connection;
+}
+
+Connection SimpleOptimization::bifurcation(Segment segment) {
+  return optimize(segment, tree()->right(segment.ID()), false);
+}
+
+Connection SimpleOptimization::bifurcation(int segmentID, Segment newSegment) {
+  Connection connection;
+  TreeModel *tree = GeometricOptimization::tree();
+
+  if (_trial->tree() != tree) {
+    _trial->setTree(tree);
+  }
+
+  /* Connect the new segment to the middle of the segment on the trial. */
+  _trial->connect(segmentID,
+                  _geometry->middle(tree->proximalPoint(segmentID),
+                                    tree->distalPoint(segmentID)),
+                  newSegment);
+
+  if (_numberOfThreads > 1) {
+    connection = optimize(*_trial->segment(segmentID), newSegment, true);
+  } else {
+    /* Optimize on the trial, restrictions included. */
+    setTree(_trial);
+    connection = bifurcation(*_trial->segment(segmentID));
+    setTree(tree);
+  }
+  _trial->clear();
 
-  return *minimumConnection;
+  return connection;
 }
 
 void SimpleOptimization::setIntervalDivision(int value) {
+  int t;
   _intervalDivision = value;
+  allocateGrid();
+  for (t = 0; t < _numberOfThreads && _workers; t++) {
+    _workers[t]->setIntervalDivision(value);
+  }
+}
+
+void SimpleOptimization::allocateWorkers() {
+  int t;
+  deallocateWorkers();
+  if (_numberOfThreads > 1) {
+    _workers = new SimpleOptimization *[_numberOfThreads];
+    _pool = new WorkerPool(_numberOfThreads);
+    for (t = 0; t < _numberOfThreads; t++) {
+      _workers[t] = static_cast<SimpleOptimization *>(clone());
+    }
+  }
+}
+
+void SimpleOptimization::deallocateWorkers() {
+  int t;
+  if (_workers) {
+    for (t = 0; t < _numberOfThreads; t++) {
+      delete _workers[t];
+    }
+  }
+  delete[] _workers;
+  delete _pool;
+  _workers = nullptr;
+  _pool = nullptr;
+}
+
+long SimpleOptimization::numberOfEvaluations() {
+  int t;
+  long numberOfEvaluations = GeometricOptimization::numberOfEvaluations();
+  for (t = 0; t < _numberOfThreads && _workers; t++) {
+    numberOfEvaluations += _workers[t]->numberOfEvaluations();
+  }
+  return numberOfEvaluations;
+}
+
+void SimpleOptimization::resetNumberOfEvaluations() {
+  int t;
+  GeometricOptimization::resetNumberOfEvaluations();
+  for (t = 0; t < _numberOfThreads && _workers; t++) {
+    _workers[t]->resetNumberOfEvaluations();
+  }
+}
+
+int SimpleOptimization::numberOfLevels() { return _numberOfLevels; }
+
+void SimpleOptimization::setNumberOfLevels(int value) {
+  if (value < 1) {
+    throw invalid_argument("Oops! The number of levels must be positive.");
+  }
+  _numberOfLevels = value;
+}
+
+int SimpleOptimization::numberOfThreads() { return _numberOfThreads; }
+
+void SimpleOptimization::setNumberOfThreads(int value) {
+  if (value < 1) {
+    throw invalid_argument("Oops! The number of threads must be positive.");
+  }
+  deallocateWorkers();
+  _numberOfThreads = value;
+  allocateWorkers();
+}
+
+void SimpleOptimization::setGeometricRestrictions(
+    GeometricRestriction **geometricRestrictions,
+    int numberOfGeometricRestrictions) {
+  GeometricOptimization::setGeometricRestrictions(
+      geometricRestrictions, numberOfGeometricRestrictions);
+
+  /* The workers copy the restrictions. */
+  if (_workers) {
+    allocateWorkers();
+  }
+}
+
+GeometricOptimization *SimpleOptimization::clone() {
+  SimpleOptimization *simpleOptimization =
+      new SimpleOptimization(domain(), tree(), _targetFunction->clone(),
+                             _intervalDivision, _degreeOfSymmetry);
+
+  cloneRestrictionsInto(simpleOptimization);
+  simpleOptimization->_numberOfLevels = _numberOfLevels;
+
+  return simpleOptimization;
 }
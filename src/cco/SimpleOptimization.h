@@ -27,6 +27,7 @@
  * @date 2022-05-18
  */
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <string>
@@ -34,8 +35,10 @@
 #include "BifurcationSymmetry.h"
 #include "TargetVolume.h"
 #include "ValidSegment.h"
+#include "WorkerPool.h"
 #include "geometry/Geometry.h"
 #include "interface/GeometricOptimization.h"
+#include "tree/TreeTrial.h"
 using std::cout;
 using std::endl;
 
@@ -69,6 +72,174 @@ class SimpleOptimization : public GeometricOptimization {
    */
   double _degreeOfSymmetry = 0.0;
 
+  /**
+   * @brief The trial where the connections are optimized.
+   * 
+   */
+  TreeTrial *_trial;
+
+  /**
+   * @brief The number of levels of the grid search.
+   * 
+   */
+  int _numberOfLevels = 1;
+
+  /**
+   * @brief The vertices of the triangle: map(0, 0), map(0, 1) and map(1, 0).
+   * 
+   */
+  Point _Xi, _Xj, _Xnew;
+
+  /**
+   * @brief The points of the grid where the target function is evaluated.
+   * 
+   */
+  Point *_gridPoints = nullptr;
+
+  /**
+   * @brief The barycentric coordinates (a, b) of the grid points.
+   * 
+   */
+  double *_gridA = nullptr, *_gridB = nullptr;
+
+  /**
+   * @brief The target function value on each grid point.
+   * 
+   */
+  double *_gridValues = nullptr;
+
+  /**
+   * @brief Flag if each grid point pass the geometric restrictions.
+   * 
+   */
+  bool *_gridPasses = nullptr;
+
+  /**
+   * @brief The maximum number of grid points.
+   * 
+   */
+  int _numberOfGridPoints = 0;
+
+  /**
+   * @brief The number of grid points on the current level.
+   * 
+   */
+  int _currentNumberOfGridPoints = 0;
+
+  /**
+   * @brief The number of threads that evaluate the grid points.
+   * 
+   */
+  int _numberOfThreads = 1;
+
+  /**
+   * @brief The copies of the optimization used by each thread.
+   * 
+   */
+  SimpleOptimization **_workers = nullptr;
+
+  /**
+   * @brief The threads, created with the workers and reused by every
+   * evaluation of the grid.
+   * 
+   */
+  WorkerPool *_pool = nullptr;
+
+  /**
+   * @brief Allocate the grid vectors for the number of interval
+   * subdivisions.
+   * 
+   */
+  void allocateGrid();
+
+  /**
+   * @brief Set the triangle given by the segment proximal point, the
+   * connection segment distal point and the new segment distal point.
+   * 
+   * @param segmentProximalPoint The proximal point of the segment.
+   * @param oldBifurcationPoint The current bifurcation point.
+   * @param connectionSegmentDistalPoint The distal point of the connection
+   * segment.
+   * @param newSegmentDistalPoint The distal point of the new segment.
+   */
+  void setTriangle(Point segmentProximalPoint, Point oldBifurcationPoint,
+                   Point connectionSegmentDistalPoint,
+                   Point newSegmentDistalPoint);
+
+  /**
+   * @brief Evaluate the grid points on the sub-triangle with vertices
+   * (a, b) = origin, origin + (size, 0) and origin + (0, size). The points
+   * out of the triangle are skipped.
+   * 
+   * @param originA The coordinate a of the origin.
+   * @param originB The coordinate b of the origin.
+   * @param size The size of the sub-triangle.
+   * @param hasEvaluated Flag if there is a point already evaluated.
+   * @param evaluatedA The coordinate a of the point already evaluated.
+   * @param evaluatedB The coordinate b of the point already evaluated.
+   */
+  void evalGrid(double originA, double originB, double size,
+                bool hasEvaluated, double evaluatedA, double evaluatedB);
+
+  /**
+   * @brief Evaluate the target function on the grid points, moving the
+   * bifurcation on the tree.
+   * 
+   * @param segment The segment.
+   */
+  void evalGridValues(Segment segment);
+
+  /**
+   * @brief Evaluate the target function on the grid points with the
+   * threads.
+   * 
+   * @param segment The segment (as it was when connected at its middle
+   * point).
+   * @param newSegment The new segment.
+   */
+  void evalGridValuesConcurrently(Segment segment, Segment newSegment);
+
+  /**
+   * @brief Create the copies of the optimization used by each thread.
+   * 
+   */
+  void allocateWorkers();
+
+  /**
+   * @brief Destroy the copies of the optimization used by each thread.
+   * 
+   */
+  void deallocateWorkers();
+
+  /**
+   * @brief Connect the new segment to the segment at the bifurcation point
+   * on the trial, check the geometric restrictions and evaluate the target
+   * function.
+   * 
+   * @param segment The segment (as it was when connected at its middle
+   * point).
+   * @param newSegment The new segment.
+   * @param bifurcationPoint The bifurcation point.
+   * @param value The target function value (only if the restrictions pass).
+   * @return Returns true if the connection pass the geometric restrictions.
+   * Returns false otherwise.
+   */
+  bool evalGridPoint(Segment segment, Segment newSegment,
+                     Point bifurcationPoint, double *value);
+
+  /**
+   * @brief Find the connection that minimize the target function on the
+   * grid of each level.
+   * 
+   * @param segment The segment.
+   * @param newSegment The new segment.
+   * @param concurrently Flag if the grid points are evaluated by the
+   * threads (on the trial connected at the middle point). Otherwise, the
+   * bifurcation is moved on the tree.
+   * @return Connection The information about the connection.
+   */
+  Connection optimize(Segment segment, Segment newSegment, bool concurrently);
+
  public:
   /**
    * @brief Construct a new Simple Optimization object.
@@ -98,7 +269,7 @@ class SimpleOptimization : public GeometricOptimization {
    * @brief Destroy the Simple Optimization object.
    * 
    */
-  ~SimpleOptimization() {}
+  ~SimpleOptimization();
 
   /**
    * @brief Get the connection for the given segment.
@@ -109,11 +280,98 @@ class SimpleOptimization : public GeometricOptimization {
    */
   virtual Connection bifurcation(Segment segment);
 
+  /**
+   * @brief Get the connection of the new segment to the segment.
+   * 
+   * The connection is optimized on a trial of the tree, so the tree is never
+   * changed.
+   * 
+   * @param segmentID The index of the segment to connect.
+   * @param newSegment The new segment.
+   * @return Connection The information about the connection.
+   */
+  virtual Connection bifurcation(int segmentID, Segment newSegment);
+
   /**
    * @brief Set the number of interval subdivisions.
    * 
    * @param value The number of interval subdivisions.
    */
   void setIntervalDivision(int value);
+
+  /**
+   * @brief Get the number of levels of the grid search.
+   * 
+   * @return The number of levels.
+   */
+  int numberOfLevels();
+
+  /**
+   * @brief Set the number of levels of the grid search.
+   * 
+   * With one level (the default) the target function is evaluated on the
+   * uniform grid of the triangle. Each further level evaluates the same grid
+   * on a triangle with half the size, centered at the best point so far, so
+   * the resolution doubles per level at the cost of one coarse grid. For
+   * example, intervalDivision = 3 with 3 levels has a finer resolution than
+   * intervalDivision = 10.
+   * 
+   * @param value The number of levels.
+   */
+  void setNumberOfLevels(int value);
+
+  /**
+   * @brief Get the number of target function evaluations (the threads
+   * included).
+   * 
+   * @return The number of target function evaluations.
+   */
+  virtual long numberOfEvaluations();
+
+  /**
+   * @brief Set the number of target function evaluations to zero (the
+   * threads included).
+   * 
+   */
+  virtual void resetNumberOfEvaluations();
+
+  /**
+   * @brief Get the number of threads that evaluate the grid points.
+   * 
+   * @return The number of threads.
+   */
+  int numberOfThreads();
+
+  /**
+   * @brief Set the number of threads that evaluate the grid points of
+   * bifurcation(int, Segment).
+   * 
+   * Each thread evaluates the grid points on its own trial, with its own
+   * copies of the target function and the geometric restrictions. The
+   * minimum is taken in the order of the grid, so the connection is the same
+   * for any number of threads.
+   * 
+   * @param value The number of threads.
+   */
+  void setNumberOfThreads(int value);
+
+  /**
+   * @brief Set the Geometric Restrictions object.
+   * 
+   * @param geometricRestrictions The geometric restrictions.
+   * @param numberOfGeometricRestrictions The number of geometric restrictions.
+   */
+  virtual void setGeometricRestrictions(
+      GeometricRestriction **geometricRestrictions,
+      int numberOfGeometricRestrictions);
+
+  /**
+   * @brief Create a copy of the geometric optimization, with copies of the
+   * target function and of the geometric restrictions. The copy evaluates
+   * the grid points serially.
+   * 
+   * @return The copy of the geometric optimization.
+   */
+  virtual GeometricOptimization *clone();
 };
 #endif  //_CCOLAB_CCO_SIMPLEOPTIMIZATION_H
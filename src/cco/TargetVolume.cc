@@ -40,19 +40,170 @@ TargetVolume::TargetVolume(TreeModel *tree, double radiusExpoent,
     : TargetFunction(tree) {
   _radiusExpoent = radiusExpoent;
   _lengthExpoent = lengthExpoent;
+  allocate();
+  tree->attach(this);
 }
 
-double TargetVolume::eval() {
+TargetVolume::~TargetVolume() {
+  tree()->detach(this);
+  delete[] _subtreeSum;
+  delete[] _changedSegments;
+  delete[] _stack;
+  delete[] _trialSubtreeSum;
+  delete[] _trialSubtreeSumVersion;
+}
+
+void TargetVolume::allocate() {
+  int i;
+  delete[] _subtreeSum;
+  delete[] _changedSegments;
+  delete[] _stack;
+  delete[] _trialSubtreeSum;
+  delete[] _trialSubtreeSumVersion;
+
+  /**
+   *  Allocate all vectors once. It speed up the code because later it wont
+   *  need to create/destroy objects as the tree grows.
+   **/
+  _totalNumberOfSegments = tree()->totalNumberOfSegments();
+  _subtreeSum = new double[_totalNumberOfSegments];
+  _changedSegments = new int[_totalNumberOfSegments];
+  _stack = new int[_totalNumberOfSegments];
+  _trialSubtreeSum = new double[_totalNumberOfSegments];
+  _trialSubtreeSumVersion = new long[_totalNumberOfSegments];
+  for (i = 0; i < _totalNumberOfSegments; i++) {
+    _trialSubtreeSumVersion[i] = -1;
+  }
+  _numberOfChangedSegments = 0;
+  _isOutdated = true;
+}
+
+void TargetVolume::setTree(TreeModel *tree) {
+  TargetFunction::tree()->detach(this);
+  TargetFunction::setTree(tree);
+  allocate();
+  tree->attach(this);
+}
+
+void TargetVolume::changed(int segmentID) {
+  if (_numberOfChangedSegments < _totalNumberOfSegments) {
+    _changedSegments[_numberOfChangedSegments++] = segmentID;
+  } else {
+    /* Too many changes: it is cheaper to evaluate everything again. */
+    _isOutdated = true;
+  }
+}
+
+void TargetVolume::evalSubtreeSum(int segmentID) {
+  Segment *segment = tree()->segment(segmentID);
+  /*
+      The classic Target Function is proportional to the real
+      tree volume when _radiusExpoent = 2 and _lengthExpoent = 1.
+  */
+  double sum = pow(tree()->length(segmentID), _lengthExpoent);
+
+  if (!tree()->isTerminal(segmentID)) {
+    sum += pow(segment->bifurcationRatioLeft(), _radiusExpoent) *
+               _subtreeSum[segment->left()] +
+           pow(segment->bifurcationRatioRight(), _radiusExpoent) *
+               _subtreeSum[segment->right()];
+  }
+
+  _subtreeSum[segmentID] = sum;
+}
+
+void TargetVolume::evalAllSubtreeSums() {
+  int i, segmentID, numberOfSegments = 0, stackSize = 0;
+
+  /* Sort the segments so the descendents come after their ascendents. */
+  _stack[stackSize++] = tree()->rootID();
+  while (stackSize > 0) {
+    segmentID = _stack[--stackSize];
+    _changedSegments[numberOfSegments++] = segmentID;
+    if (!tree()->isTerminal(segmentID)) {
+      _stack[stackSize++] = tree()->segment(segmentID)->left();
+      _stack[stackSize++] = tree()->segment(segmentID)->right();
+    }
+  }
+
+  /* Evaluate from the terminals up to the root. */
+  for (i = numberOfSegments - 1; i >= 0; i--) {
+    evalSubtreeSum(_changedSegments[i]);
+  }
+}
+
+void TargetVolume::updateSubtreeSums() {
   int i;
-  double volume = 0.0;
-  for (i = tree()->begin(); i < tree()->end(); i++) {
-    /*
-        The classic Target Function is proportional to the real
-        tree volume when _radiusExpoent = 2 and _lengthExpoent = 1.
-    */
-    volume += pow(tree()->radius(i), _radiusExpoent) *
-              pow(tree()->length(i), _lengthExpoent);
+
+  if (_isOutdated) {
+    evalAllSubtreeSums();
+  } else {
+    for (i = 0; i < _numberOfChangedSegments; i++) {
+      /* The removed segments do not matter anymore. */
+      if (_changedSegments[i] < tree()->end()) {
+        evalSubtreeSum(_changedSegments[i]);
+      }
+    }
+  }
+  _numberOfChangedSegments = 0;
+  _isOutdated = false;
+}
+
+double TargetVolume::eval() {
+  if (tree()->begin() == tree()->end()) {
+    return 0.0;
+  }
+
+  updateSubtreeSums();
+
+  return pow(tree()->radius(tree()->rootID()), _radiusExpoent) *
+         _subtreeSum[tree()->rootID()];
+}
+
+double TargetVolume::trialSubtreeSum(int segmentID) {
+  return _trialSubtreeSumVersion[segmentID] == _trialVersion
+             ? _trialSubtreeSum[segmentID]
+             : _subtreeSum[segmentID];
+}
+
+double TargetVolume::eval(TreeTrial *trial) {
+  int i, segmentID;
+  double sum = 0.0;
+  Segment *segment;
+
+  /* The sums of the tree are useless here, so sum over all segments. */
+  if (trial->tree() != tree() || !trial->isConnected()) {
+    for (i = trial->begin(); i < trial->end(); i++) {
+      sum += pow(trial->radius(i), _radiusExpoent) *
+             pow(trial->length(i), _lengthExpoent);
+    }
+    return sum;
   }
 
-  return volume;
+  updateSubtreeSums();
+
+  /* The changed segments come from the new segment up to the root. */
+  _trialVersion++;
+  for (i = 0; i < trial->numberOfChangedSegments(); i++) {
+    segmentID = trial->changedSegments()[i];
+    segment = trial->segment(segmentID);
+    sum = pow(trial->length(segmentID), _lengthExpoent);
+
+    if (!trial->isTerminal(segmentID)) {
+      sum += pow(segment->bifurcationRatioLeft(), _radiusExpoent) *
+                 trialSubtreeSum(segment->left()) +
+             pow(segment->bifurcationRatioRight(), _radiusExpoent) *
+                 trialSubtreeSum(segment->right());
+    }
+
+    _trialSubtreeSum[segmentID] = sum;
+    _trialSubtreeSumVersion[segmentID] = _trialVersion;
+  }
+
+  return pow(trial->radius(trial->rootID()), _radiusExpoent) *
+         _trialSubtreeSum[trial->rootID()];
+}
+
+TargetFunction *TargetVolume::clone() {
+  return new TargetVolume(tree(), _radiusExpoent, _lengthExpoent);
 }
@@ -30,6 +30,19 @@
 
 #ifndef _CCOLAB_CCO_TARGETVOLUME_H
 #define _CCOLAB_CCO_TARGETVOLUME_H
+/**
+ * @brief The target function given by the sum of radius^a * length^b over
+ * all segments.
+ *
+ * The target function is evaluated incrementally. Let S(i) be the sum over
+ * the subtree of the segment i of (radius / radius(i))^a * length^b. Then
+ *
+ * S(i) = length(i)^b + ratioLeft(i)^a * S(left) + ratioRight(i)^a * S(right)
+ *
+ * and the target function is radius(root)^a * S(root). Every change on the
+ * tree is notified from the changed segment up to the root, so only S on
+ * that path is evaluated again.
+ */
 class TargetVolume : public TargetFunction {
  private:
   /**
@@ -44,6 +57,98 @@ class TargetVolume : public TargetFunction {
    */
   double _lengthExpoent;
 
+  /**
+   * @brief The maximum number of segments on the tree.
+   * 
+   */
+  int _totalNumberOfSegments = 0;
+
+  /**
+   * @brief The sum S of each segment subtree.
+   * 
+   */
+  double *_subtreeSum = nullptr;
+
+  /**
+   * @brief The segments changed since the last evaluation, in the order they
+   * were notified.
+   * 
+   */
+  int *_changedSegments = nullptr;
+
+  /**
+   * @brief The number of segments changed since the last evaluation.
+   * 
+   */
+  int _numberOfChangedSegments = 0;
+
+  /**
+   * @brief The segments waiting to be visited when all the sums are
+   * evaluated.
+   * 
+   */
+  int *_stack = nullptr;
+
+  /**
+   * @brief Flag if all the sums must be evaluated again.
+   * 
+   */
+  bool _isOutdated = true;
+
+  /**
+   * @brief The sum S of the subtrees changed by the trial.
+   * 
+   */
+  double *_trialSubtreeSum = nullptr;
+
+  /**
+   * @brief The trial evaluation when each sum on _trialSubtreeSum was
+   * evaluated.
+   * 
+   */
+  long *_trialSubtreeSumVersion = nullptr;
+
+  /**
+   * @brief The number of trial evaluations.
+   * 
+   */
+  long _trialVersion = 0;
+
+  /**
+   * @brief Allocate the vectors for the segments of the tree.
+   * 
+   */
+  void allocate();
+
+  /**
+   * @brief Evaluate the sum S of the segment subtree from the sums of its
+   * descendents.
+   * 
+   * @param segmentID The index of the segment.
+   */
+  void evalSubtreeSum(int segmentID);
+
+  /**
+   * @brief Evaluate the sum S of all segments subtree.
+   * 
+   */
+  void evalAllSubtreeSums();
+
+  /**
+   * @brief Evaluate the sum S of the segments changed since the last
+   * evaluation.
+   * 
+   */
+  void updateSubtreeSums();
+
+  /**
+   * @brief Get the sum S of the segment subtree on the trial.
+   * 
+   * @param segmentID The index of the segment.
+   * @return The sum S of the segment subtree.
+   */
+  double trialSubtreeSum(int segmentID);
+
  public:
   /**
    * @brief Construct a new Target Volume object.
@@ -61,7 +166,7 @@ class TargetVolume : public TargetFunction {
    * @brief Destroy the Target Volume object.
    * 
    */
-  ~TargetVolume() {}
+  ~TargetVolume();
 
   /**
    * @brief Evaluate the target function.
@@ -69,5 +174,37 @@ class TargetVolume : public TargetFunction {
    * @return The target function value. 
    */
   virtual double eval();
+
+  /**
+   * @brief Evaluate the target function on the trial of the tree.
+   * 
+   * Only the sums S of the segments changed by the trial are evaluated,
+   * the others come from the tree.
+   * 
+   * @param trial The trial.
+   * @return The target function value.
+   */
+  virtual double eval(TreeTrial *trial);
+
+  /**
+   * @brief Notify that the segment changed.
+   * 
+   * @param segmentID The index of the segment.
+   */
+  virtual void changed(int segmentID);
+
+  /**
+   * @brief Set the Tree object.
+   * 
+   * @param tree The tree.
+   */
+  virtual void setTree(TreeModel *tree);
+
+  /**
+   * @brief Create a copy of the target function.
+   * 
+   * @return The copy of the target function.
+   */
+  virtual TargetFunction *clone();
 };
 #endif //_CCOLAB_CCO_TARGETVOLUME_H
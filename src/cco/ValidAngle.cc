@@ -42,10 +42,10 @@ bool ValidAngle::pass(Segment segment) {
   bool passTheRestriciton = false;
 
   /* Compute the current angle defined by the segment descendents. */
-  leftSegmentVector =
-      _geometry->subtract(tree()->left(segment.ID()).point(), segment.point());
-  rightSegmentVector =
-      _geometry->subtract(tree()->right(segment.ID()).point(), segment.point());
+  leftSegmentVector = _geometry->subtract(
+      tree()->distalPoint(tree()->leftID(segment.ID())), segment.point());
+  rightSegmentVector = _geometry->subtract(
+      tree()->distalPoint(tree()->rightID(segment.ID())), segment.point());
   segmentAngle = _geometry->angle(leftSegmentVector, rightSegmentVector);
 
   /* Check if the angle is between minimum and maximum angles. */
@@ -56,3 +56,7 @@ bool ValidAngle::pass(Segment segment) {
   return passTheRestriciton;
 }
 
+
+GeometricRestriction *ValidAngle::clone() {
+  return new ValidAngle(tree(), _minumumAngle, _maximumAngle);
+}
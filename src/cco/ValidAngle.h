@@ -76,5 +76,12 @@ class ValidAngle : public GeometricRestriction {
    * otherwise.
    */
   virtual bool pass(Segment segment);
+
+  /**
+   * @brief Create a copy of the restriction.
+   * 
+   * @return The copy of the restriction.
+   */
+  virtual GeometricRestriction *clone();
 };
 #endif //_CCOLAB_CCO_VALIDANGLE_H
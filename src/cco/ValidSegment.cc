@@ -40,3 +40,5 @@ bool ValidSegment::pass(Segment segment) {
           leftLength >= 2 * parentRadius * segment.bifurcationRatioLeft() &&
           rightLength >= 2 * parentRadius * segment.bifurcationRatioRight());
 }
+
+GeometricRestriction *ValidSegment::clone() { return new ValidSegment(tree()); }
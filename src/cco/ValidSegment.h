@@ -53,5 +53,12 @@ class ValidSegment : public GeometricRestriction {
    * being at least twice their radius. Returns false otherwise.
    */
   virtual bool pass(Segment segment);
+
+  /**
+   * @brief Create a copy of the restriction.
+   * 
+   * @return The copy of the restriction.
+   */
+  virtual GeometricRestriction *clone();
 };
 #endif //_CCOLAB_CCO_VALIDSEGMENT_H
@@ -30,41 +30,96 @@
 
 WithoutIntersection::WithoutIntersection(TreeModel *tree)
     : GeometricRestriction(tree) {
-  _geometry = new Geometry(tree->dimension());
+  _nearbySegments = new int[tree->totalNumberOfSegments()];
+}
+
+WithoutIntersection::~WithoutIntersection() {
+  delete[] _nearbySegments;
 }
 
 bool WithoutIntersection::pass(Segment segment) {
   /* Search for intersection. */
-  int i, j;
-  Segment checkSegments[3] = {
-      segment,
-      tree()->left(segment.ID()),
-      tree()->right(segment.ID()),
+  int i, j, k, count, numberOfSegments;
+  double checkRadius, maximumRadius;
+  Point proximalPoint, distalPoint;
+  int checkSegments[3] = {
+      segment.ID(),
+      tree()->leftID(segment.ID()),
+      tree()->rightID(segment.ID()),
   };
 
-  for (i = tree()->begin(); i < tree()->end(); i++) {
-    for (j = 0; j < 3; j++) {
-      if (isRelative(*tree()->segment(i), checkSegments[j])) {
+  /* No segment is thicker than the root. */
+  maximumRadius = tree()->radius(tree()->rootID());
+
+  for (j = 0; j < 3; j++) {
+    proximalPoint = tree()->proximalPoint(checkSegments[j]);
+    distalPoint = tree()->distalPoint(checkSegments[j]);
+    checkRadius = tree()->radius(checkSegments[j]);
+
+    /**
+     * Only the segments close to the checked one may intersect it. In two
+     * dimensions the intersection may be up to the tolerance beyond the
+     * distal points of both segments, so we look twice as far.
+     */
+    numberOfSegments = tree()->nearbySegments(
+        proximalPoint, distalPoint, 2.0 * (checkRadius + maximumRadius),
+        _nearbySegments);
+
+    /* The segments are tested in batches by SegmentIntersectionKernel. */
+    count = 0;
+    for (k = 0; k < numberOfSegments; k++) {
+      i = _nearbySegments[k];
+      if (isRelative(i, checkSegments[j])) {
         continue;
       }
 
-      if (_geometry->hasIntersection(
-              tree()->proximalPoint(i), tree()->distalPoint(i),
-              tree()->proximalPoint(checkSegments[j].ID()),
-              tree()->distalPoint(checkSegments[j].ID()),
-              tree()->radius(i) + tree()->radius(checkSegments[j].ID()))) {
-        return false;
+      addCandidate(i, tree()->radius(i) + checkRadius, count++);
+      if (count == SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS) {
+        if (hasIntersection(proximalPoint, distalPoint, count)) {
+          return false;
+        }
+        count = 0;
       }
     }
+    if (hasIntersection(proximalPoint, distalPoint, count)) {
+      return false;
+    }
   }
 
   return true;
 }
 
-bool WithoutIntersection::isRelative(Segment segmentA,
-                                     Segment segmentB) {
-  return (segmentA.ID() == segmentB.ID() || segmentA.ID() == segmentB.left() ||
-          segmentA.ID() == segmentB.right() || segmentA.ID() == segmentB.up() ||
-          segmentB.ID() == segmentA.left() ||
-          segmentB.ID() == segmentA.right() || segmentB.ID() == segmentA.up());
+bool WithoutIntersection::isRelative(int segmentA, int segmentB) {
+  return (segmentA == segmentB || segmentA == tree()->leftID(segmentB) ||
+          segmentA == tree()->rightID(segmentB) ||
+          segmentA == tree()->parentID(segmentB) ||
+          segmentB == tree()->leftID(segmentA) ||
+          segmentB == tree()->rightID(segmentA) ||
+          segmentB == tree()->parentID(segmentA));
+}
+
+void WithoutIntersection::addCandidate(int segmentID, double tolerance,
+                                       int position) {
+  int k;
+  Point proximalPoint = tree()->proximalPoint(segmentID),
+        distalPoint = tree()->distalPoint(segmentID);
+
+  for (k = 0; k < 3; k++) {
+    _proximalPoints[3 * position + k] = proximalPoint.coordinates()[k];
+    _distalPoints[3 * position + k] = distalPoint.coordinates()[k];
+  }
+  _tolerances[position] = tolerance;
+}
+
+bool WithoutIntersection::hasIntersection(Point pointC, Point pointD,
+                                          int numberOfSegments) {
+  return numberOfSegments > 0 &&
+         SegmentIntersectionKernel::intersectionMask(
+             tree()->dimension(), pointC.coordinates(), pointD.coordinates(),
+             _proximalPoints, _distalPoints, _tolerances, numberOfSegments,
+             true) != 0;
+}
+
+GeometricRestriction *WithoutIntersection::clone() {
+  return new WithoutIntersection(tree());
 }
@@ -29,6 +29,7 @@
 #include <iostream>
 
 #include "geometry/Geometry.h"
+#include "geometry/SegmentIntersectionKernel.h"
 #include "interface/GeometricRestriction.h"
 
 #ifndef _CCOLAB_CCO_WITHOUTINTERSECTION_H
@@ -36,21 +37,62 @@
 class WithoutIntersection : public GeometricRestriction {
  private:
   /**
-   * @brief The Geometry object to do some geometric calculations.
+   * @brief The segments close to the checked segment.
    * 
    */
-  Geometry *_geometry;
+  int *_nearbySegments;
+
+  /**
+   * @brief The proximal points of the segments tested at once (3
+   * coordinates per segment).
+   * 
+   */
+  double
+      _proximalPoints[3 * SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS];
+
+  /**
+   * @brief The distal points of the segments tested at once.
+   * 
+   */
+  double _distalPoints[3 * SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS];
+
+  /**
+   * @brief The intersection tolerance of the segments tested at once.
+   * 
+   */
+  double _tolerances[SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS];
+
+  /**
+   * @brief Add the segment of the tree to the segments tested at once.
+   * 
+   * @param segmentID The segment index.
+   * @param tolerance The intersection tolerance.
+   * @param position The position on the segments tested at once.
+   */
+  void addCandidate(int segmentID, double tolerance, int position);
+
+  /**
+   * @brief Check if some of the segments tested at once intersects the
+   * segment CD.
+   * 
+   * @param pointC The point C.
+   * @param pointD The point D.
+   * @param numberOfSegments The number of segments.
+   * @return Returns true if some segment intersects CD. Returns false
+   * otherwise.
+   */
+  bool hasIntersection(Point pointC, Point pointD, int numberOfSegments);
 
   /**
    * @brief Check if two segments are relatives.
    * 
-   * @param segmentA The segment to be checked.
-   * @param segmentB The segment to be checked.
+   * @param segmentA The index of the segment to be checked.
+   * @param segmentB The index of the segment to be checked.
    * @return Returns true if the segments are relatives (ie, segment A is 
    * descendent of segment B or vice-versa). It also returns true if segment A
    * is equal to segment B. Returns false otherwise.
    */
-  bool isRelative(Segment segmentA, Segment segmentB);
+  bool isRelative(int segmentA, int segmentB);
 
  public:
   /**
@@ -64,7 +106,7 @@ class WithoutIntersection : public GeometricRestriction {
    * @brief Destroy the Without Intersection object.
    * 
    */
-  ~WithoutIntersection() {}
+  ~WithoutIntersection();
 
   /**
    * @brief Check if a given segment (or its descendents) intersects other
@@ -75,5 +117,12 @@ class WithoutIntersection : public GeometricRestriction {
    * intersects other segment on the tree. Returns false otherwise.
    */
   virtual bool pass(Segment segment);
+
+  /**
+   * @brief Create a copy of the restriction.
+   * 
+   * @return The copy of the restriction.
+   */
+  virtual GeometricRestriction *clone();
 };
 #endif //_CCOLAB_CCO_WITHOUTINTERSECTION_H
@@ -0,0 +1,96 @@
+/**
+ * @file WorkerPool.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ * 
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int numberOfThreads) {
+  int t;
+  _numberOfThreads = numberOfThreads;
+  if (_numberOfThreads > 1) {
+    _threads = new std::thread[_numberOfThreads - 1];
+    for (t = 1; t < _numberOfThreads; t++) {
+      _threads[t - 1] = std::thread(&WorkerPool::work, this, t);
+    }
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  int t;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isStopping = true;
+  }
+  _started.notify_all();
+  for (t = 1; t < _numberOfThreads; t++) {
+    _threads[t - 1].join();
+  }
+  delete[] _threads;
+}
+
+void WorkerPool::work(int thread) {
+  long generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _started.wait(lock, [&]() {
+        return _isStopping || _generation != generation;
+      });
+      if (_isStopping) {
+        return;
+      }
+      generation = _generation;
+    }
+
+    _call(_task, thread);
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (--_numberOfRunningThreads == 0) {
+        _finished.notify_one();
+      }
+    }
+  }
+}
+
+void WorkerPool::dispatch() {
+  if (_numberOfThreads > 1) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _numberOfRunningThreads = _numberOfThreads - 1;
+      _generation++;
+    }
+    _started.notify_all();
+  }
+
+  _call(_task, 0);
+
+  if (_numberOfThreads > 1) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.wait(lock, [&]() { return _numberOfRunningThreads == 0; });
+  }
+}
@@ -0,0 +1,142 @@
+/**
+ * @file WorkerPool.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ * 
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifndef _CCOLAB_CCO_WORKERPOOL_H
+#define _CCOLAB_CCO_WORKERPOOL_H
+/**
+ * @brief Threads created once and reused to run a task several times.
+ * 
+ * run() gives each thread its index and returns when every thread finished
+ * the task. The calling thread runs the index 0 itself, so a pool of one
+ * thread creates no threads. Nothing is allocated by run(), so the pool may
+ * be used inside the growth loops.
+ */
+class WorkerPool {
+ private:
+  /**
+   * @brief The number of threads (the calling thread included).
+   * 
+   */
+  int _numberOfThreads;
+
+  /**
+   * @brief The threads created by the pool (one less than the number of
+   * threads).
+   * 
+   */
+  std::thread *_threads = nullptr;
+
+  /**
+   * @brief The task being run and the function that calls it.
+   * 
+   */
+  void *_task = nullptr;
+  void (*_call)(void *task, int thread) = nullptr;
+
+  /**
+   * @brief The number of tasks started, so each thread knows when there is
+   * a new one.
+   * 
+   */
+  long _generation = 0;
+
+  /**
+   * @brief The number of threads still running the task.
+   * 
+   */
+  int _numberOfRunningThreads = 0;
+
+  /**
+   * @brief Flag if the threads must finish.
+   * 
+   */
+  bool _isStopping = false;
+
+  /**
+   * @brief Lock and conditions of the fields above.
+   * 
+   */
+  std::mutex _mutex;
+  std::condition_variable _started, _finished;
+
+  /**
+   * @brief The loop of each thread created by the pool.
+   * 
+   * @param thread The index of the thread.
+   */
+  void work(int thread);
+
+  /**
+   * @brief Run the task on every thread and wait for them.
+   * 
+   */
+  void dispatch();
+
+ public:
+  /**
+   * @brief Construct a new Worker Pool object.
+   * 
+   * @param numberOfThreads The number of threads (the calling thread
+   * included).
+   */
+  explicit WorkerPool(int numberOfThreads);
+
+  /**
+   * @brief Destroy the Worker Pool object (the threads are joined).
+   * 
+   */
+  ~WorkerPool();
+
+  /**
+   * @brief Get the number of threads (the calling thread included).
+   * 
+   * @return The number of threads.
+   */
+  int numberOfThreads() { return _numberOfThreads; }
+
+  /**
+   * @brief Run task(thread) on every thread, with thread from 0 to
+   * numberOfThreads() - 1, and wait for all of them.
+   * 
+   * @tparam Task The type of the task (usually a lambda).
+   * @param task The task.
+   */
+  template <typename Task>
+  void run(Task &task) {
+    _task = &task;
+    _call = [](void *task, int thread) {
+      (*static_cast<Task *>(task))(thread);
+    };
+    dispatch();
+  }
+};
+#endif  // _CCOLAB_CCO_WORKERPOOL_H
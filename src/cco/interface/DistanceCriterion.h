@@ -73,7 +73,7 @@ class DistanceCriterion {
    * @brief Destroy the Distance Criterion object
    *
    */
-  ~DistanceCriterion() {}
+  virtual ~DistanceCriterion() {}
 
   /**
    * @brief Set the Tree object
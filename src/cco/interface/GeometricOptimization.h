@@ -28,12 +28,14 @@
  *
  */
 
+#include <cmath>
 #include <string>
 
 #include "Connection.h"
 #include "GeometricRestriction.h"
 #include "TargetFunction.h"
 #include "domain/interface/Domain.h"
+#include "geometry/Geometry.h"
 #include "tree/interface/TreeModel.h"
 
 using std::cout;
@@ -73,6 +75,84 @@ class GeometricOptimization {
    */
   TreeModel *_tree;
 
+  /**
+   * @brief The number of target function evaluations.
+   *
+   */
+  long _numberOfEvaluations = 0;
+
+  /**
+   * @brief Flag if the object was created by clone(). A clone owns its
+   * target function and geometric restrictions.
+   *
+   */
+  bool _isClone = false;
+
+ protected:
+  /**
+   * @brief Give a new clone copies of the geometric restrictions of this
+   * object, in place of its default ones (which are deleted), and flag it as
+   * a clone. Each subclass copies only its own parameters.
+   *
+   * @param geometricOptimization The new clone.
+   */
+  void cloneRestrictionsInto(GeometricOptimization *geometricOptimization) {
+    int i;
+    GeometricRestriction **geometricRestrictions =
+        new GeometricRestriction *[_numberOfGeometricRestrictions];
+
+    for (i = 0; i < geometricOptimization->_numberOfGeometricRestrictions;
+         i++) {
+      delete geometricOptimization->_geometricRestrictions[i];
+    }
+    delete[] geometricOptimization->_geometricRestrictions;
+
+    for (i = 0; i < _numberOfGeometricRestrictions; i++) {
+      geometricRestrictions[i] = _geometricRestrictions[i]->clone();
+    }
+    geometricOptimization->setGeometricRestrictions(
+        geometricRestrictions, _numberOfGeometricRestrictions);
+    geometricOptimization->_isClone = true;
+  }
+
+  /**
+   * @brief Get the triangle where the bifurcation point is searched, given
+   * by the segment proximal point, the connection segment distal point and
+   * the new segment distal point (each moved 30% towards the others).
+   *
+   * @param geometry The geometry of the tree dimension.
+   * @param segmentProximalPoint The proximal point of the segment.
+   * @param oldBifurcationPoint The current bifurcation point.
+   * @param connectionSegmentDistalPoint The distal point of the connection
+   * segment.
+   * @param newSegmentDistalPoint The distal point of the new segment.
+   * @param Xi The vertex near the segment proximal point.
+   * @param Xj The vertex near the connection segment distal point.
+   * @param Xnew The vertex near the new segment distal point.
+   */
+  void bifurcationTriangle(Geometry *geometry, Point segmentProximalPoint,
+                           Point oldBifurcationPoint,
+                           Point connectionSegmentDistalPoint,
+                           Point newSegmentDistalPoint, Point *Xi, Point *Xj,
+                           Point *Xnew) {
+    double offset = 0.3;
+    *Xi = geometry->add(
+        segmentProximalPoint,
+        geometry->scalarProduct(
+            offset, geometry->subtract(connectionSegmentDistalPoint,
+                                       segmentProximalPoint)));
+    *Xj = geometry->add(
+        segmentProximalPoint,
+        geometry->scalarProduct(
+            1.0 - offset, geometry->subtract(connectionSegmentDistalPoint,
+                                             segmentProximalPoint)));
+    *Xnew = geometry->add(
+        newSegmentDistalPoint,
+        geometry->scalarProduct(
+            offset,
+            geometry->subtract(oldBifurcationPoint, newSegmentDistalPoint)));
+  }
+
  public:
   /**
    * @brief Construct a new Geometric Optimization object
@@ -92,14 +172,29 @@ class GeometricOptimization {
    * @brief Destroy the Geometric Optimization object
    *
    */
-  ~GeometricOptimization() {}
+  virtual ~GeometricOptimization() {
+    int i;
+    if (_isClone) {
+      for (i = 0; i < _numberOfGeometricRestrictions; i++) {
+        delete _geometricRestrictions[i];
+      }
+      delete[] _geometricRestrictions;
+      delete _targetFunction;
+    }
+  }
 
   /**
-   * @brief Set the Tree object.
+   * @brief Set the Tree object (also for the geometric restrictions).
    *
    * @param tree The tree.
    */
-  virtual void setTree(TreeModel *tree) { _tree = tree; }
+  virtual void setTree(TreeModel *tree) {
+    int i;
+    _tree = tree;
+    for (i = 0; i < _numberOfGeometricRestrictions; i++) {
+      _geometricRestrictions[i]->setTree(tree);
+    }
+  }
 
   /**
    * @brief Get the Tree object.
@@ -122,6 +217,59 @@ class GeometricOptimization {
    */
   virtual Domain *domain() { return _domain; }
 
+  /**
+   * @brief Get the target function.
+   *
+   * @return TargetFunction*
+   */
+  virtual TargetFunction *targetFunction() { return _targetFunction; }
+
+  /**
+   * @brief Evaluate the target function on the tree and count the
+   * evaluation.
+   *
+   * @return The value of the target function.
+   */
+  virtual double evalTargetFunction() {
+    _numberOfEvaluations++;
+    return _targetFunction->eval();
+  }
+
+  /**
+   * @brief Evaluate the target function on the trial and count the
+   * evaluation.
+   *
+   * @param trial The trial.
+   * @return The value of the target function.
+   */
+  virtual double evalTargetFunction(TreeTrial *trial) {
+    _numberOfEvaluations++;
+    return _targetFunction->eval(trial);
+  }
+
+  /**
+   * @brief Get the number of target function evaluations.
+   *
+   * @return The number of target function evaluations.
+   */
+  virtual long numberOfEvaluations() { return _numberOfEvaluations; }
+
+  /**
+   * @brief Set the number of target function evaluations to zero.
+   *
+   */
+  virtual void resetNumberOfEvaluations() { _numberOfEvaluations = 0; }
+
+  /**
+   * @brief Add target function evaluations counted elsewhere (e.g. by a
+   * clone that ran on another thread).
+   *
+   * @param numberOfEvaluations The number of target function evaluations.
+   */
+  virtual void addNumberOfEvaluations(long numberOfEvaluations) {
+    _numberOfEvaluations += numberOfEvaluations;
+  }
+
   /**
    * @brief Set the Geometric Restrictions object.
    *
@@ -135,6 +283,24 @@ class GeometricOptimization {
     _numberOfGeometricRestrictions = numberOfGeometricRestrictions;
   }
 
+  /**
+   * @brief Get the Geometric Restrictions object.
+   *
+   * @return GeometricRestriction**
+   */
+  virtual GeometricRestriction **geometricRestrictions() {
+    return _geometricRestrictions;
+  }
+
+  /**
+   * @brief Get the number of geometric restrictions.
+   *
+   * @return The number of geometric restrictions.
+   */
+  virtual int numberOfGeometricRestrictions() {
+    return _numberOfGeometricRestrictions;
+  }
+
   /**
    * @brief Check if the segment pass the geometric restrictions.
    *
@@ -145,14 +311,14 @@ class GeometricOptimization {
   virtual bool passRestrictions(Segment segment) {
     int i;
     bool pass = true;
-    Segment rightSegment = _tree->right(segment.ID()),
-                 leftSegment = _tree->left(segment.ID());
+    int rightID = _tree->rightID(segment.ID()),
+        leftID = _tree->leftID(segment.ID());
     if (_domain->isIn(_tree->proximalPoint(segment.ID()),
                       _tree->distalPoint(segment.ID())) &&
-        _domain->isIn(_tree->proximalPoint(rightSegment.ID()),
-                      _tree->distalPoint(rightSegment.ID())) &&
-        _domain->isIn(_tree->proximalPoint(leftSegment.ID()),
-                      _tree->distalPoint(leftSegment.ID()))) {
+        _domain->isIn(_tree->proximalPoint(rightID),
+                      _tree->distalPoint(rightID)) &&
+        _domain->isIn(_tree->proximalPoint(leftID),
+                      _tree->distalPoint(leftID))) {
       for (i = 0; i < _numberOfGeometricRestrictions; i++) {
         if (!_geometricRestrictions[i]->pass(segment)) {
           pass = false;
@@ -173,5 +339,43 @@ class GeometricOptimization {
    * @return Connection
    */
   virtual Connection bifurcation(Segment segment) = 0;
+
+  /**
+   * @brief Find the bifurcation connection of the new segment to the segment
+   * that minimize the target function. The tree is left unchanged.
+   *
+   * By default, the new segment is grown from the middle of the segment,
+   * optimized by bifurcation(Segment) and then removed.
+   *
+   * @param segmentID The index of the segment to connect.
+   * @param newSegment The new segment (only its distal point and flow are
+   * used).
+   * @return The connection.
+   */
+  virtual Connection bifurcation(int segmentID, Segment newSegment) {
+    Geometry geometry(_tree->dimension());
+    Connection connection;
+    Segment bifurcationSegment = _tree->growSegment(
+        geometry.middle(_tree->proximalPoint(segmentID),
+                        _tree->distalPoint(segmentID)),
+        *_tree->segment(segmentID), newSegment);
+
+    connection = bifurcation(bifurcationSegment);
+
+    /* Undo the connection. */
+    _tree->remove(_tree->right(bifurcationSegment.ID()));
+
+    return connection;
+  }
+
+  /**
+   * @brief Create a new geometric optimization equal to this one, for the
+   * same tree and domain, with its own copies of the target function and the
+   * geometric restrictions. Each copy may run bifurcation(int, Segment) on a
+   * different thread while the tree is not changed.
+   *
+   * @return The new geometric optimization.
+   */
+  virtual GeometricOptimization *clone() = 0;
 };
 #endif  //_CCOLAB_CCO_INTERFACE_GEOMETRIC_OPTIMIZATION_H
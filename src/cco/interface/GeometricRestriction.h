@@ -59,7 +59,7 @@ class GeometricRestriction {
    * @brief Destroy the Geometric Restriction object.
    *
    */
-  ~GeometricRestriction() {}
+  virtual ~GeometricRestriction() {}
 
   /**
    * @brief Set the Tree object.
@@ -83,5 +83,14 @@ class GeometricRestriction {
    * Returns false otherwise.
    */
   virtual bool pass(Segment segment) = 0;
+
+  /**
+   * @brief Create a new geometric restriction equal to this one that shares
+   * no working memory with it. Each copy may be checked by a different
+   * thread.
+   *
+   * @return The new geometric restriction.
+   */
+  virtual GeometricRestriction *clone() = 0;
 };
 #endif  //_CCOLAB_CCO_INTERFACE_GEOMETRIC_RESTRICTION_H
@@ -27,11 +27,21 @@
  * @date 2022-05-18
  *
  */
+#include "tree/TreeTrial.h"
 #include "tree/interface/TreeModel.h"
+#include "tree/interface/TreeObserver.h"
 
 #ifndef _CCOLAB_CCO_INTERFACE_TARGET_FUNCTION_CLASS_H
 #define _CCOLAB_CCO_INTERFACE_TARGET_FUNCTION_CLASS_H
-class TargetFunction {
+/**
+ * @brief Target function of the geometric optimization.
+ *
+ * A target function may be evaluated incrementally: once attached to the
+ * tree, it is notified of the changed segments and the next evaluation only
+ * needs to visit them. By default, the changes are ignored and every
+ * evaluation visits the whole tree.
+ */
+class TargetFunction : public TreeObserver {
  private:
   /**
    * @brief The tree.
@@ -51,7 +61,7 @@ class TargetFunction {
    * @brief Destroy the Target Function object.
    *
    */
-  ~TargetFunction() {}
+  virtual ~TargetFunction() {}
 
   /**
    * @brief Evaluate the target function.
@@ -60,6 +70,41 @@ class TargetFunction {
    */
   virtual double eval() = 0;
 
+  /**
+   * @brief Create a new target function equal to this one, for the same tree,
+   * but that shares no evaluation state with it. Each copy may be evaluated
+   * by a different thread.
+   *
+   * @return The new target function.
+   */
+  virtual TargetFunction *clone() = 0;
+
+  /**
+   * @brief Evaluate the target function on the trial of the tree (the tree
+   * plus one hypothetical bifurcation).
+   *
+   * By default, the target function is evaluated with the trial in place of
+   * the tree.
+   *
+   * @param trial The trial.
+   * @return The value of the target function.
+   */
+  virtual double eval(TreeTrial *trial) {
+    double value;
+    TreeModel *tree = _tree;
+    _tree = trial;
+    value = eval();
+    _tree = tree;
+    return value;
+  }
+
+  /**
+   * @brief Notify that the segment changed.
+   *
+   * @param segmentID The index of the segment.
+   */
+  virtual void changed(int /*segmentID*/) {}
+
   /**
    * @brief Set the Tree object.
    *
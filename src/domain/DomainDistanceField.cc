@@ -0,0 +1,483 @@
+/**
+ * @file DomainDistanceField.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "DomainDistanceField.h"
+
+#include <algorithm>
+#include <cmath>
+
+DomainDistanceField::DomainDistanceField(Domain *domain, TreeModel **trees,
+                                         int numberOfTrees,
+                                         DistanceCriterion *distanceCriterion)
+    : Domain(domain->dimension()) {
+  int i, capacity = 0;
+  Point point;
+
+  if (numberOfTrees < 1) {
+    throw invalid_argument("Oops! The domain needs at least one tree.");
+  }
+
+  _domain = domain;
+  _trees = trees;
+  _numberOfTrees = numberOfTrees;
+  _distanceCriterion = distanceCriterion;
+  setVolume(domain->volume());
+
+  /**
+   *  Allocate all vectors once. It speed up the code because later it wont
+   *  need to create/destroy objects as the trees grow.
+   * */
+  _points = new double[3 * domain->totalNumberOfPoints()];
+  _domain->reset();
+  while (_domain->hasAvailablePoint() &&
+         _totalNumberOfPoints < domain->totalNumberOfPoints()) {
+    point = _domain->point();
+    _points[3 * _totalNumberOfPoints] = point.x();
+    _points[3 * _totalNumberOfPoints + 1] = point.y();
+    _points[3 * _totalNumberOfPoints + 2] =
+        domain->dimension() == 3 ? point.z() : 0.0;
+    _totalNumberOfPoints++;
+  }
+  _domain->reset();
+
+  _numberOfLeaves = 1;
+  while (_numberOfLeaves < _totalNumberOfPoints) {
+    _numberOfLeaves *= 2;
+  }
+  _distance = new double[_totalNumberOfPoints];
+  _isStale = new bool[_totalNumberOfPoints];
+  _maximumDistance = new double[2 * _numberOfLeaves];
+  for (i = 0; i < 2 * _numberOfLeaves; i++) {
+    _maximumDistance[i] = -HUGE_VAL;
+  }
+
+  _changeLogs = new TreeChangeLog *[_numberOfTrees];
+  _grids = new TreeSegmentGrid *[_numberOfTrees];
+  for (i = 0; i < _numberOfTrees; i++) {
+    _changeLogs[i] = new TreeChangeLog(_trees[i]);
+    _grids[i] = new TreeSegmentGrid(_trees[i]);
+    capacity = std::max(capacity, _changeLogs[i]->capacity());
+  }
+  _changedSegments = new int[capacity];
+  _wasOnTree = new bool[capacity];
+  _oldProximalPoints = new Point[capacity];
+  _oldDistalPoints = new Point[capacity];
+
+  buildGrid();
+}
+
+DomainDistanceField::~DomainDistanceField() {
+  int i;
+  for (i = 0; i < _numberOfTrees; i++) {
+    delete _changeLogs[i];
+    delete _grids[i];
+  }
+  delete[] _changeLogs;
+  delete[] _grids;
+  delete[] _changedSegments;
+  delete[] _wasOnTree;
+  delete[] _oldProximalPoints;
+  delete[] _oldDistalPoints;
+  delete[] _points;
+  delete[] _distance;
+  delete[] _isStale;
+  delete[] _maximumDistance;
+  delete[] _cellStart;
+  delete[] _pointIDs;
+  delete[] _entries;
+}
+
+double DomainDistanceField::coordinate(Point point, int coordinate) {
+  return coordinate == 0 ? point.x()
+                         : (coordinate == 1 ? point.y() : point.z());
+}
+
+int DomainDistanceField::cell(double value, int axis) {
+  double c = floor((value - _lowerCorner[axis]) / _cellSize);
+
+  if (!(c > 0.0)) {
+    return 0;
+  }
+
+  return c < _numberOfCells[axis] ? static_cast<int>(c)
+                                  : _numberOfCells[axis] - 1;
+}
+
+void DomainDistanceField::buildGrid() {
+  int i, d, c, numberOfCells = 1, *cells;
+  double upperCorner[3], boxVolume = 1.0, *points;
+
+  for (d = 0; d < 3; d++) {
+    _lowerCorner[d] = _totalNumberOfPoints > 0 ? HUGE_VAL : 0.0;
+    upperCorner[d] = _totalNumberOfPoints > 0 ? -HUGE_VAL : 0.0;
+  }
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    for (d = 0; d < 3; d++) {
+      _lowerCorner[d] = std::min(_lowerCorner[d], _points[3 * i + d]);
+      upperCorner[d] = std::max(upperCorner[d], _points[3 * i + d]);
+    }
+  }
+  for (d = 0; d < dimension(); d++) {
+    boxVolume *= upperCorner[d] - _lowerCorner[d];
+  }
+
+  /* About four points per cell. */
+  _cellSize = pow(4.0 * boxVolume / std::max(1, _totalNumberOfPoints),
+                  1.0 / dimension());
+  if (!(_cellSize > 0.0)) {
+    _cellSize = 1.0;
+    for (d = 0; d < dimension(); d++) {
+      _cellSize = std::max(_cellSize, upperCorner[d] - _lowerCorner[d]);
+    }
+  }
+  for (d = 0; d < 3; d++) {
+    _numberOfCells[d] =
+        d < dimension()
+            ? std::max(1, static_cast<int>(ceil(
+                              (upperCorner[d] - _lowerCorner[d]) / _cellSize)))
+            : 1;
+    numberOfCells *= _numberOfCells[d];
+  }
+
+  /* The points are sorted by cell (counting sort). */
+  cells = new int[_totalNumberOfPoints];
+  _cellStart = new int[numberOfCells + 1];
+  _pointIDs = new int[_totalNumberOfPoints];
+  _entries = new int[_totalNumberOfPoints];
+  for (c = 0; c <= numberOfCells; c++) {
+    _cellStart[c] = 0;
+  }
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    cells[i] = (cell(_points[3 * i + 2], 2) * _numberOfCells[1] +
+                cell(_points[3 * i + 1], 1)) *
+                   _numberOfCells[0] +
+               cell(_points[3 * i], 0);
+    _cellStart[cells[i] + 1]++;
+  }
+  for (c = 0; c < numberOfCells; c++) {
+    _cellStart[c + 1] += _cellStart[c];
+  }
+  for (i = _totalNumberOfPoints - 1; i >= 0; i--) {
+    _pointIDs[--_cellStart[cells[i] + 1]] = i;
+  }
+  for (c = 0; c < numberOfCells; c++) {
+    _cellStart[c] = _cellStart[c + 1];
+  }
+  _cellStart[numberOfCells] = _totalNumberOfPoints;
+  delete[] cells;
+
+  /* The points are stored by cell, so the cells are read sequentially. */
+  points = new double[3 * _totalNumberOfPoints];
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    for (d = 0; d < 3; d++) {
+      points[3 * i + d] = _points[3 * _pointIDs[i] + d];
+    }
+    _entries[_pointIDs[i]] = i;
+  }
+  delete[] _points;
+  _points = points;
+}
+
+void DomainDistanceField::setKey(int pointID, double value) {
+  int node = _numberOfLeaves + pointID;
+  double maximum;
+
+  _maximumDistance[node] = value;
+  while (node > 1) {
+    node /= 2;
+    maximum =
+        std::max(_maximumDistance[2 * node], _maximumDistance[2 * node + 1]);
+    if (maximum == _maximumDistance[node]) {
+      break;
+    }
+    _maximumDistance[node] = maximum;
+  }
+}
+
+void DomainDistanceField::measure(int entry) {
+  int t;
+  double distance = _cap;
+
+  for (t = 0; t < _numberOfTrees; t++) {
+    distance = _grids[t]->distanceFromSegments(
+        Point(&_points[3 * entry], dimension()), distance);
+  }
+  _distance[entry] = distance;
+  _isStale[entry] = false;
+  setKey(_pointIDs[entry], distance);
+}
+
+double DomainDistanceField::distanceFromSegment(double *point,
+                                                double *proximalPoint,
+                                                double *direction,
+                                                double squaredLength) {
+  int d;
+  double t = 0.0, distance = 0.0, difference;
+
+  /* The closest point of the segment is the clamped projection. */
+  if (squaredLength > 0.0) {
+    for (d = 0; d < 3; d++) {
+      t += (point[d] - proximalPoint[d]) * direction[d];
+    }
+    t = std::min(1.0, std::max(0.0, t / squaredLength));
+  }
+  for (d = 0; d < 3; d++) {
+    difference = point[d] - proximalPoint[d] - t * direction[d];
+    distance += difference * difference;
+  }
+
+  return sqrt(distance);
+}
+
+void DomainDistanceField::updateDistance(Point proximalPoint,
+                                         Point distalPoint, bool isOnTree) {
+  int piece, numberOfPieces, d, i, j, k, c, entry, lower[3], upper[3],
+      previousLower[3], previousUpper[3];
+  double A[3], AB[3], center[3], squaredLength = 0.0, start, end, t0, t1,
+      distance, halfDiagonal = 0.5 * _cellSize * sqrt(dimension());
+
+  for (d = 0; d < 3; d++) {
+    A[d] = coordinate(proximalPoint, d);
+    AB[d] = coordinate(distalPoint, d) - A[d];
+    squaredLength += AB[d] * AB[d];
+  }
+  numberOfPieces = std::max(1, static_cast<int>(ceil(
+                                   sqrt(squaredLength) /
+                                   std::max(_cap, _cellSize))));
+
+  for (piece = 0; piece < numberOfPieces; piece++) {
+    t0 = static_cast<double>(piece) / numberOfPieces;
+    t1 = static_cast<double>(piece + 1) / numberOfPieces;
+    for (d = 0; d < 3; d++) {
+      start = A[d] + t0 * AB[d];
+      end = piece + 1 < numberOfPieces ? A[d] + t1 * AB[d] : A[d] + AB[d];
+      lower[d] = cell(std::min(start, end) - _cap, d);
+      upper[d] = cell(std::max(start, end) + _cap, d);
+    }
+
+    for (k = lower[2]; k <= upper[2]; k++) {
+      for (j = lower[1]; j <= upper[1]; j++) {
+        for (i = lower[0]; i <= upper[0]; i++) {
+          /* The cells of the previous piece were already visited. */
+          if (piece > 0 && i >= previousLower[0] && i <= previousUpper[0] &&
+              j >= previousLower[1] && j <= previousUpper[1] &&
+              k >= previousLower[2] && k <= previousUpper[2]) {
+            continue;
+          }
+
+          /* Skip the cells farther than the cap from the segment. */
+          center[0] = _lowerCorner[0] + (i + 0.5) * _cellSize;
+          center[1] = _lowerCorner[1] + (j + 0.5) * _cellSize;
+          center[2] = dimension() == 3 ? _lowerCorner[2] + (k + 0.5) * _cellSize
+                                       : _lowerCorner[2];
+          if (distanceFromSegment(center, A, AB, squaredLength) >=
+              _cap + halfDiagonal) {
+            continue;
+          }
+
+          c = (k * _numberOfCells[1] + j) * _numberOfCells[0] + i;
+          for (entry = _cellStart[c]; entry < _cellStart[c + 1]; entry++) {
+            distance = distanceFromSegment(&_points[3 * entry], A, AB,
+                                           squaredLength);
+            if (_isStale[entry]) {
+              /* The key of a stale point is an upper bound. */
+              if (isOnTree &&
+                  distance < _maximumDistance[_numberOfLeaves +
+                                              _pointIDs[entry]]) {
+                setKey(_pointIDs[entry], distance);
+              }
+            } else if (isOnTree && distance < _distance[entry]) {
+              _distance[entry] = distance;
+              setKey(_pointIDs[entry], distance);
+            } else if (!isOnTree && distance < _cap &&
+                       distance <= _distance[entry]) {
+              _isStale[entry] = true;
+              setKey(_pointIDs[entry], _cap);
+            }
+          }
+        }
+      }
+    }
+    for (d = 0; d < 3; d++) {
+      previousLower[d] = lower[d];
+      previousUpper[d] = upper[d];
+    }
+  }
+}
+
+void DomainDistanceField::rebuild(double cap) {
+  int i, t, segmentID;
+
+  _cap = cap;
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    _distance[i] = _cap;
+    _isStale[i] = false;
+    _maximumDistance[_numberOfLeaves + i] = _cap;
+  }
+  for (i = _numberOfLeaves - 1; i > 0; i--) {
+    _maximumDistance[i] =
+        std::max(_maximumDistance[2 * i], _maximumDistance[2 * i + 1]);
+  }
+
+  for (t = 0; t < _numberOfTrees; t++) {
+    _changeLogs[t]->update(_changedSegments, _wasOnTree, _oldProximalPoints,
+                           _oldDistalPoints);
+    for (segmentID = _trees[t]->begin(); segmentID < _trees[t]->end();
+         segmentID++) {
+      updateDistance(_trees[t]->proximalPoint(segmentID),
+                     _trees[t]->distalPoint(segmentID), true);
+    }
+  }
+}
+
+void DomainDistanceField::synchronize() {
+  int i, t, segmentID, numberOfChangedSegments;
+  double distance = _distanceCriterion->minimumDistanceCriterion();
+
+  if (_cap == 0.0 || distance > _cap) {
+    rebuild(distance);
+    return;
+  }
+
+  for (t = 0; t < _numberOfTrees; t++) {
+    numberOfChangedSegments = _changeLogs[t]->update(
+        _changedSegments, _wasOnTree, _oldProximalPoints, _oldDistalPoints);
+
+    /**
+     *  The criterion is lowered as the trees grow, so the cap follows it
+     *  when they change. Only the relaxation keeps the old cap.
+     **/
+    if (numberOfChangedSegments > 0 && distance < _cap) {
+      _cap = distance;
+    }
+
+    /**
+     *  The points whose closest segment was moved or removed become stale,
+     *  and they are measured again only if they are visited. The segments on
+     *  their new place can only lower the distances (and the upper bounds of
+     *  the stale points).
+     **/
+    for (i = 0; i < numberOfChangedSegments; i++) {
+      if (_wasOnTree[i]) {
+        updateDistance(_oldProximalPoints[i], _oldDistalPoints[i], false);
+      }
+    }
+    for (i = 0; i < numberOfChangedSegments; i++) {
+      segmentID = _changedSegments[i];
+      if (segmentID < _trees[t]->end()) {
+        updateDistance(_trees[t]->proximalPoint(segmentID),
+                       _trees[t]->distalPoint(segmentID), true);
+      }
+    }
+  }
+}
+
+int DomainDistanceField::find(int pointID, double distance) {
+  int node;
+
+  if (pointID >= _totalNumberOfPoints) {
+    return -1;
+  }
+
+  /* Go up until the right sibling has a large enough bound. */
+  node = _numberOfLeaves + pointID;
+  if (_maximumDistance[node] >= distance) {
+    return pointID;
+  }
+  while (node > 1) {
+    if (node % 2 == 0 && _maximumDistance[node + 1] >= distance) {
+      node++;
+      break;
+    }
+    node /= 2;
+  }
+  if (node == 1) {
+    return -1;
+  }
+
+  /* Go down to the first leaf with a large enough bound. */
+  while (node < _numberOfLeaves) {
+    node *= 2;
+    if (_maximumDistance[node] < distance) {
+      node++;
+    }
+  }
+
+  return node - _numberOfLeaves;
+}
+
+int DomainDistanceField::next(double distance) {
+  int pointID = find(_currentPoint, distance);
+
+  if (pointID < 0) {
+    pointID = find(0, distance);
+  }
+
+  return pointID;
+}
+
+Point DomainDistanceField::point() {
+  int pointID;
+  double distance;
+
+  synchronize();
+  distance = _distanceCriterion->minimumDistanceCriterion();
+  pointID = next(distance);
+  while (pointID < 0 || _isStale[_entries[pointID]]) {
+    if (pointID >= 0) {
+      measure(_entries[pointID]);
+    } else if (hasAvailablePoint()) {
+      distance = _distanceCriterion->relax();
+    } else {
+      throw invalid_argument("Oops! No more points on domain.");
+    }
+    pointID = next(distance);
+  }
+
+  _currentPoint = pointID + 1;
+
+  return Point(&_points[3 * _entries[pointID]], dimension());
+}
+
+Point DomainDistanceField::seed(int seedID) { return _domain->seed(seedID); }
+
+bool DomainDistanceField::isIn(Point pointA, Point pointB) {
+  return _domain->isIn(pointA, pointB);
+}
+
+int DomainDistanceField::totalNumberOfPoints() { return _totalNumberOfPoints; }
+
+int DomainDistanceField::numberOfSeeds() { return _domain->numberOfSeeds(); }
+
+bool DomainDistanceField::hasAvailablePoint() {
+  synchronize();
+
+  return _totalNumberOfPoints > 0 && _maximumDistance[1] > 0.0;
+}
+
+void DomainDistanceField::reset() { _currentPoint = 0; }
@@ -0,0 +1,393 @@
+/**
+ * @file DomainDistanceField.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <string>
+
+#include "cco/interface/DistanceCriterion.h"
+#include "interface/Domain.h"
+#include "tree/TreeChangeLog.h"
+#include "tree/TreeSegmentGrid.h"
+#include "tree/interface/TreeModel.h"
+using std::invalid_argument;
+
+#ifndef _CCOLAB_DOMAIN_DOMAINDISTANCEFIELD_H
+#define _CCOLAB_DOMAIN_DOMAINDISTANCEFIELD_H
+/**
+ * @brief Domain that gives only the points that pass the distance criterion.
+ *
+ * The points of the given domain are read once. For each point it is kept
+ * its distance to the segments of the trees (up to a cap not less than the
+ * minimum distance criterion), so a point passes the criterion if its
+ * distance is not less than the criterion. When the trees change, only the
+ * points closer than the cap to the changed segments are updated (they are
+ * found on a uniform grid of points). The points whose closest segment was
+ * moved or removed become stale, with an upper bound of their distance, and
+ * they are measured again on the grid of segments of each tree only when
+ * they are visited. The next point that may pass is found in logarithmic
+ * time on a binary tree of the maximum distances (or upper bounds), so the
+ * growing methods never reject a point.
+ *
+ * The points are visited in the order of the given domain, skipping the ones
+ * that do not pass. When no point passes, the distance criterion is relaxed
+ * here. So the accepted points are not the same of the given domain with the
+ * rejections and the relaxations of the growing method.
+ */
+class DomainDistanceField : public Domain {
+ private:
+  /**
+   * @brief The given domain.
+   *
+   */
+  Domain *_domain;
+
+  /**
+   * @brief The vector of trees.
+   *
+   */
+  TreeModel **_trees;
+
+  /**
+   * @brief The number of trees.
+   *
+   */
+  int _numberOfTrees;
+
+  /**
+   * @brief The log of the changed segments of each tree.
+   *
+   */
+  TreeChangeLog **_changeLogs;
+
+  /**
+   * @brief The grid of segments of each tree.
+   *
+   */
+  TreeSegmentGrid **_grids;
+
+  /**
+   * @brief The distance criterion.
+   *
+   */
+  DistanceCriterion *_distanceCriterion;
+
+  /**
+   * @brief Total number of points in the domain.
+   *
+   */
+  int _totalNumberOfPoints = 0;
+
+  /**
+   * @brief The domain points (three coordinates per point), sorted by the
+   * cell of the grid of points.
+   *
+   */
+  double *_points;
+
+  /**
+   * @brief The index of each stored point on the given domain.
+   *
+   */
+  int *_pointIDs;
+
+  /**
+   * @brief The stored entry of each point of the given domain.
+   *
+   */
+  int *_entries;
+
+  /**
+   * @brief The distance from each point to the trees.
+   *
+   * Only the distances less than the cap are kept up to date, so the
+   * distance is min(distance, cap) for the queries.
+   */
+  double *_distance;
+
+  /**
+   * @brief Flag if the distance of each point is stale (its closest segment
+   * was moved or removed).
+   *
+   */
+  bool *_isStale;
+
+  /**
+   * @brief The number of leaves of the binary tree (a power of two).
+   *
+   */
+  int _numberOfLeaves;
+
+  /**
+   * @brief The binary tree of the maximum distance (the node i has the
+   * children 2i and 2i + 1, and the leaf of the point j is the node
+   * _numberOfLeaves + j). The stale points have an upper bound of their
+   * distance on it.
+   *
+   */
+  double *_maximumDistance;
+
+  /**
+   * @brief The distance up to where the distances are kept (zero until the
+   * first query).
+   *
+   */
+  double _cap = 0.0;
+
+  /**
+   * @brief The index of the next point to visit.
+   *
+   */
+  int _currentPoint = 0;
+
+  /**
+   * @brief The lower corner of the grid of points.
+   *
+   */
+  double _lowerCorner[3];
+
+  /**
+   * @brief The cell size of the grid of points.
+   *
+   */
+  double _cellSize;
+
+  /**
+   * @brief The number of cells on each axis.
+   *
+   */
+  int _numberOfCells[3];
+
+  /**
+   * @brief The first entry of each cell (the cell c has the entries from
+   * _cellStart[c] to _cellStart[c + 1] - 1).
+   *
+   */
+  int *_cellStart;
+
+  /**
+   * @brief The changed segments of a tree.
+   *
+   */
+  int *_changedSegments;
+
+  /**
+   * @brief Flag if each changed segment was on the tree before.
+   *
+   */
+  bool *_wasOnTree;
+
+  /**
+   * @brief The proximal point of each changed segment before the change.
+   *
+   */
+  Point *_oldProximalPoints;
+
+  /**
+   * @brief The distal point of each changed segment before the change.
+   *
+   */
+  Point *_oldDistalPoints;
+
+  /**
+   * @brief Get the coordinate (x, y or z) of the point.
+   *
+   * @param point The point.
+   * @param coordinate The point coordinate (0 for x, 1 for y and 2 for z).
+   * @return The coordinate value.
+   */
+  double coordinate(Point point, int coordinate);
+
+  /**
+   * @brief Get the cell of the grid of points on the axis.
+   *
+   * @param value The coordinate value.
+   * @param axis The axis (0 for x, 1 for y and 2 for z).
+   * @return The cell index on the axis (clamped to the grid).
+   */
+  int cell(double value, int axis);
+
+  /**
+   * @brief Build the grid of points with about four points per cell, and
+   * sort the points by cell.
+   *
+   */
+  void buildGrid();
+
+  /**
+   * @brief Set the distance of the point on the binary tree.
+   *
+   * @param pointID The point index.
+   * @param value The distance.
+   */
+  void setKey(int pointID, double value);
+
+  /**
+   * @brief Measure the distance from the point to the trees on the grids of
+   * segments.
+   *
+   * @param entry The stored entry of the point.
+   */
+  void measure(int entry);
+
+  /**
+   * @brief Get the distance from the point to the segment (the same of
+   * Geometry::distanceFromSegment, up to rounding).
+   *
+   * @param point The point coordinates.
+   * @param proximalPoint The proximal point coordinates.
+   * @param direction The distal point minus the proximal point.
+   * @param squaredLength The squared length of the segment.
+   * @return The distance.
+   */
+  double distanceFromSegment(double *point, double *proximalPoint,
+                             double *direction, double squaredLength);
+
+  /**
+   * @brief Update the distance of the points closer than the cap to the
+   * segment.
+   *
+   * The segment is split in pieces not longer than the cap (or the cell
+   * size), so the points are searched on the cells around each piece.
+   *
+   * @param proximalPoint The proximal point of the segment.
+   * @param distalPoint The distal point of the segment.
+   * @param isOnTree Flag if the segment is on the trees. Otherwise, it was
+   * moved or removed, and the points whose closest segment it was become
+   * stale.
+   */
+  void updateDistance(Point proximalPoint, Point distalPoint, bool isOnTree);
+
+  /**
+   * @brief Compute all the distances again with the cap.
+   *
+   * @param cap The cap.
+   */
+  void rebuild(double cap);
+
+  /**
+   * @brief Update the distances for the segments changed since the last
+   * query.
+   *
+   * The cap follows the minimum distance criterion: it is raised by a
+   * rebuild and lowered (for free) when the trees change.
+   */
+  void synchronize();
+
+  /**
+   * @brief Find the first point from the index whose distance is not less
+   * than the given distance.
+   *
+   * @param pointID The first point index.
+   * @param distance The distance.
+   * @return The point index (or -1 if there is no such point).
+   */
+  int find(int pointID, double distance);
+
+  /**
+   * @brief Find the next point to visit whose distance is not less than the
+   * given distance (after the last point, it goes back to the first one).
+   *
+   * @param distance The distance.
+   * @return The point index (or -1 if there is no such point).
+   */
+  int next(double distance);
+
+ public:
+  /**
+   * @brief Construct a new Domain Distance Field object.
+   *
+   * @param domain The given domain (its points are read once).
+   * @param trees The vector of trees.
+   * @param numberOfTrees The number of trees.
+   * @param distanceCriterion The distance criterion used to grow the trees.
+   */
+  DomainDistanceField(Domain *domain, TreeModel **trees, int numberOfTrees,
+                      DistanceCriterion *distanceCriterion);
+
+  /**
+   * @brief Destroy the Domain Distance Field object (the logs and the grids
+   * are detached from the trees).
+   *
+   */
+  virtual ~DomainDistanceField();
+
+  /**
+   * @brief Get the next point in the domain that pass the distance
+   * criterion.
+   *
+   * @return A point in the domain.
+   */
+  virtual Point point();
+
+  /**
+   * @brief Get a seed in the domain.
+   *
+   * @param seedID The seed index.
+   * @return A seed in the domain.
+   */
+  virtual Point seed(int seedID);
+
+  /**
+   * @brief Check if the segment with endpoints A and B is in domain.
+   *
+   * @param pointA A given point in domain.
+   * @param pointB A given point in domain.
+   * @return Returns true if the segment with endpoints A and B is in domain.
+   * Returns false otherwise.
+   */
+  virtual bool isIn(Point pointA, Point pointB);
+
+  /**
+   * @brief Get the total number of points in domain.
+   *
+   * @return The total number of points.
+   */
+  virtual int totalNumberOfPoints();
+
+  /**
+   * @brief Get the number of seeds.
+   *
+   * @return The number of seeds.
+   */
+  virtual int numberOfSeeds();
+
+  /**
+   * @brief Check if the domain has available point to be visited, that is,
+   * some point is not on the trees.
+   *
+   * @return Returns true if the domain has available point to be visited.
+   * Returns false otherwise.
+   */
+  virtual bool hasAvailablePoint();
+
+  /**
+   * @brief Visit the points from the first one again.
+   *
+   */
+  virtual void reset();
+};
+#endif  //_CCOLAB_DOMAIN_DOMAINDISTANCEFIELD_H
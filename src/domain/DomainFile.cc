@@ -50,6 +50,7 @@ DomainFile::DomainFile(string filename, int totalNumberOfPoints,
 DomainFile::~DomainFile() { 
   delete[] _points; 
   delete[] _seeds;
+  delete[] _order;
 }
 
 double DomainFile::pointCoordinate(int pointID, int coordinate) {
@@ -61,17 +62,16 @@ double DomainFile::seedCoordinate(int seedID, int coordinate) {
 }
 
 Point DomainFile::seed(int seedID) {
-  Point *pt;
-  pt = new Point(dimension());
+  Point pt(dimension());
 
   if (seedID >= 0 && seedID < _numberOfSeeds) {
-    pt->setX(seedCoordinate(seedID, 0));
-    pt->setY(seedCoordinate(seedID, 1));
+    pt.setX(seedCoordinate(seedID, 0));
+    pt.setY(seedCoordinate(seedID, 1));
     if (dimension() == 3) {
-      pt->setZ(seedCoordinate(seedID, 2));
+      pt.setZ(seedCoordinate(seedID, 2));
     }
 
-    return *pt;
+    return pt;
   } else {
     throw invalid_argument("Oops! Invalid seed ID.");
   }
@@ -79,17 +79,17 @@ Point DomainFile::seed(int seedID) {
 
 Point DomainFile::point() {
   int i = 0;
-  Point *pt;
-  pt = new Point(dimension());
+  Point pt(dimension());
 
   if (hasAvailablePoint()) {
-    pt->setX(pointCoordinate(_currentPoint, 0));
-    pt->setY(pointCoordinate(_currentPoint, 1));
+    i = _order == nullptr ? _currentPoint : _order[_currentPoint];
+    pt.setX(pointCoordinate(i, 0));
+    pt.setY(pointCoordinate(i, 1));
     if (dimension() == 3) {
-      pt->setZ(pointCoordinate(_currentPoint, 2));
+      pt.setZ(pointCoordinate(i, 2));
     }
     _currentPoint++;
-    return *pt;
+    return pt;
   } else {
     throw invalid_argument("Oops! No more points on domain file.");
   }
@@ -113,6 +113,198 @@ void DomainFile::setDomainFunction(DomainFunction *domainFunction) {
 
 DomainFunction *DomainFile::domainFunction() { return _domainFunction; }
 
+int DomainFile::samplingOrder() { return _samplingOrder; }
+
+void DomainFile::setSamplingOrder(int samplingOrder,
+                                  unsigned long randomSeed) {
+  int i;
+
+  if (samplingOrder < FILEORDER || samplingOrder > STRATIFIED) {
+    throw invalid_argument("Oops! Invalid sampling order.");
+  }
+  _samplingOrder = samplingOrder;
+  _randomSeed = randomSeed;
+
+  delete[] _order;
+  _order = nullptr;
+  if (_samplingOrder != FILEORDER) {
+    std::mt19937_64 generator(_randomSeed);
+    _order = new int[_totalNumberOfPoints];
+    if (_samplingOrder == SHUFFLED) {
+      for (i = 0; i < _totalNumberOfPoints; i++) {
+        _order[i] = i;
+      }
+      shuffle(_order, _totalNumberOfPoints, generator);
+    } else if (_samplingOrder == LOWDISCREPANCY) {
+      orderLowDiscrepancy(generator);
+    } else {
+      orderStratified(generator);
+    }
+  }
+
+  reset();
+}
+
+double DomainFile::uniform(std::mt19937_64 &generator) {
+  return static_cast<double>(generator() >> 11) * 0x1.0p-53;
+}
+
+void DomainFile::shuffle(int *values, int numberOfValues,
+                         std::mt19937_64 &generator) {
+  int i, j;
+  for (i = numberOfValues - 1; i > 0; i--) {
+    j = static_cast<int>(uniform(generator) * (i + 1));
+    std::swap(values[i], values[j]);
+  }
+}
+
+void DomainFile::boundingBox(double *lowerCorner, double *size) {
+  int i, d;
+  double upperCorner[3];
+
+  for (d = 0; d < dimension(); d++) {
+    lowerCorner[d] = HUGE_VAL;
+    upperCorner[d] = -HUGE_VAL;
+  }
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    for (d = 0; d < dimension(); d++) {
+      lowerCorner[d] = std::min(lowerCorner[d], pointCoordinate(i, d));
+      upperCorner[d] = std::max(upperCorner[d], pointCoordinate(i, d));
+    }
+  }
+  for (d = 0; d < dimension(); d++) {
+    size[d] = upperCorner[d] - lowerCorner[d];
+  }
+}
+
+void DomainFile::orderLowDiscrepancy(std::mt19937_64 &generator) {
+  int i, d, b, k, bits, numberOfBits, *sorted;
+  unsigned long r, j, shift, cell, maximumCell, *codes;
+  double lowerCorner[3], size[3];
+
+  /* The Z-order code interleaves the bits of the cell coordinates. */
+  bits = dimension() == 2 ? 31 : 21;
+  maximumCell = (1UL << bits) - 1;
+  boundingBox(lowerCorner, size);
+  codes = new unsigned long[_totalNumberOfPoints];
+  sorted = new int[_totalNumberOfPoints];
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    codes[i] = 0;
+    for (b = bits - 1; b >= 0; b--) {
+      for (d = 0; d < dimension(); d++) {
+        cell = size[d] > 0.0
+                   ? static_cast<unsigned long>(std::min(
+                         static_cast<double>(maximumCell),
+                         (pointCoordinate(i, d) - lowerCorner[d]) / size[d] *
+                             (maximumCell + 1)))
+                   : 0;
+        codes[i] = (codes[i] << 1) | ((cell >> b) & 1);
+      }
+    }
+    sorted[i] = i;
+  }
+  std::sort(sorted, sorted + _totalNumberOfPoints, [codes](int p, int q) {
+    return codes[p] < codes[q] || (codes[p] == codes[q] && p < q);
+  });
+
+  /**
+   *  The position on the curve is the bit reversal of the counter. The
+   *  digital shift (exclusive or) keeps each 2^k consecutive positions on
+   *  different 1/2^k of the curve.
+   **/
+  numberOfBits = 0;
+  while ((1L << numberOfBits) < _totalNumberOfPoints) {
+    numberOfBits++;
+  }
+  shift = generator() & ((1UL << numberOfBits) - 1);
+  k = 0;
+  for (r = 0; r < (1UL << numberOfBits); r++) {
+    j = 0;
+    for (b = 0; b < numberOfBits; b++) {
+      j = (j << 1) | (((r ^ shift) >> b) & 1);
+    }
+    if (j < static_cast<unsigned long>(_totalNumberOfPoints)) {
+      _order[k++] = sorted[j];
+    }
+  }
+
+  delete[] codes;
+  delete[] sorted;
+}
+
+void DomainFile::orderStratified(std::mt19937_64 &generator) {
+  int i, d, c, j, k, cellsPerSide, numberOfCells, numberOfActiveCells, cell,
+      *cellStart, *cellPoints, *nextPoint, *activeCells;
+  double lowerCorner[3], size[3];
+
+  cellsPerSide = std::max(
+      1, static_cast<int>(pow(static_cast<double>(_totalNumberOfPoints) /
+                                  _POINTSPERSTRATUM,
+                              1.0 / dimension())));
+  numberOfCells = dimension() == 2 ? cellsPerSide * cellsPerSide
+                                   : cellsPerSide * cellsPerSide * cellsPerSide;
+  boundingBox(lowerCorner, size);
+
+  /* Sort the points by cell (counting sort). */
+  cellStart = new int[numberOfCells + 1];
+  cellPoints = new int[_totalNumberOfPoints];
+  nextPoint = new int[numberOfCells];
+  activeCells = new int[numberOfCells];
+  for (c = 0; c <= numberOfCells; c++) {
+    cellStart[c] = 0;
+  }
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    cell = 0;
+    for (d = dimension() - 1; d >= 0; d--) {
+      c = size[d] > 0.0 ? static_cast<int>((pointCoordinate(i, d) -
+                                            lowerCorner[d]) /
+                                           size[d] * cellsPerSide)
+                        : 0;
+      cell = cell * cellsPerSide + std::min(c, cellsPerSide - 1);
+    }
+    _order[i] = cell;
+    cellStart[cell + 1]++;
+  }
+  for (c = 0; c < numberOfCells; c++) {
+    cellStart[c + 1] += cellStart[c];
+    nextPoint[c] = cellStart[c];
+  }
+  for (i = 0; i < _totalNumberOfPoints; i++) {
+    cellPoints[nextPoint[_order[i]]++] = i;
+  }
+
+  /* The points of each cell are visited in random order. */
+  numberOfActiveCells = 0;
+  for (c = 0; c < numberOfCells; c++) {
+    shuffle(&cellPoints[cellStart[c]], cellStart[c + 1] - cellStart[c],
+            generator);
+    nextPoint[c] = cellStart[c];
+    if (cellStart[c + 1] > cellStart[c]) {
+      activeCells[numberOfActiveCells++] = c;
+    }
+  }
+
+  /* Each round takes one point of each cell with points left. */
+  k = 0;
+  while (numberOfActiveCells > 0) {
+    shuffle(activeCells, numberOfActiveCells, generator);
+    j = 0;
+    for (i = 0; i < numberOfActiveCells; i++) {
+      c = activeCells[i];
+      _order[k++] = cellPoints[nextPoint[c]++];
+      if (nextPoint[c] < cellStart[c + 1]) {
+        activeCells[j++] = c;
+      }
+    }
+    numberOfActiveCells = j;
+  }
+
+  delete[] cellStart;
+  delete[] cellPoints;
+  delete[] nextPoint;
+  delete[] activeCells;
+}
+
 bool DomainFile::open(string filename) {
   int i, j, pos, value, totalNumberOfPoints;
   double doubleValue;
@@ -26,8 +26,11 @@
  * @version 1.0
  * @date 2022-05-18
  */
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <string>
 
@@ -47,7 +50,41 @@ using std::endl;
 #ifndef _CCOLAB_DOMAIN_DOMAINFILE_H
 #define _CCOLAB_DOMAIN_DOMAINFILE_H
 class DomainFile : public Domain {
+ public:
+  /**
+   * @brief The points are visited in the file order.
+   *
+   */
+  static const int FILEORDER = 0;
+
+  /**
+   * @brief The points are visited in a seeded random order.
+   *
+   */
+  static const int SHUFFLED = 1;
+
+  /**
+   * @brief The points are visited along a space filling curve (Z-order) in
+   * the order of the van der Corput sequence, so every 2^k visits in a row
+   * take one point of each 1/2^k of the curve.
+   *
+   */
+  static const int LOWDISCREPANCY = 2;
+
+  /**
+   * @brief The points are visited in rounds over the cells of a uniform
+   * grid, taking a random point of each cell (in random order) per round.
+   *
+   */
+  static const int STRATIFIED = 3;
+
  private:
+  /**
+   * @brief The mean number of points per cell of the stratified order.
+   *
+   */
+  const int _POINTSPERSTRATUM = 8;
+
   /**
    * @brief The domain seeds.
    *
@@ -66,6 +103,25 @@ class DomainFile : public Domain {
    */
   int _currentPoint = 0;
 
+  /**
+   * @brief The sampling order of the points.
+   *
+   */
+  int _samplingOrder = FILEORDER;
+
+  /**
+   * @brief The seed of the generator of the sampling order.
+   *
+   */
+  unsigned long _randomSeed = 5489UL;
+
+  /**
+   * @brief The index of the point visited at each position (null on the file
+   * order).
+   *
+   */
+  int *_order = nullptr;
+
   /**
    * @brief Total number of points in the domain.
    *
@@ -132,6 +188,49 @@ class DomainFile : public Domain {
    */
   DomainFunction *_domainFunction;
 
+  /**
+   * @brief Get a uniform number in [0, 1) from the generator. The 53 bits
+   * are taken from the generator output, so the order does not depend on
+   * the standard library.
+   *
+   * @param generator The generator.
+   * @return The number.
+   */
+  double uniform(std::mt19937_64 &generator);
+
+  /**
+   * @brief Shuffle the values (Fisher-Yates).
+   *
+   * @param values The values.
+   * @param numberOfValues The number of values.
+   * @param generator The generator.
+   */
+  void shuffle(int *values, int numberOfValues, std::mt19937_64 &generator);
+
+  /**
+   * @brief Get the bounding box of the points.
+   *
+   * @param lowerCorner The lower corner (output).
+   * @param size The size of each side (output).
+   */
+  void boundingBox(double *lowerCorner, double *size);
+
+  /**
+   * @brief Set the low-discrepancy order. The position on the Z-order curve
+   * is visited by the bit reversal of a digitally shifted counter.
+   *
+   * @param generator The generator of the digital shift.
+   */
+  void orderLowDiscrepancy(std::mt19937_64 &generator);
+
+  /**
+   * @brief Set the stratified order, with about _POINTSPERSTRATUM points per
+   * cell.
+   *
+   * @param generator The generator.
+   */
+  void orderStratified(std::mt19937_64 &generator);
+
  public:
   /**
    * @brief Construct a new Domain File object.
@@ -230,6 +329,28 @@ class DomainFile : public Domain {
    */
   DomainFunction *domainFunction();
 
+  /**
+   * @brief Get the sampling order of the points.
+   * 
+   * @return The sampling order (FILEORDER, SHUFFLED, LOWDISCREPANCY or
+   * STRATIFIED).
+   */
+  int samplingOrder();
+
+  /**
+   * @brief Set the sampling order of the points (the domain is reset).
+   * 
+   * Clustered points in the file make the distance criterion reject many
+   * points in a row. The other orders spread the consecutive points over
+   * the domain. Every point is still visited once before a reset, and the
+   * order is the same on every run with the same seed.
+   * 
+   * @param samplingOrder The sampling order (FILEORDER, SHUFFLED,
+   * LOWDISCREPANCY or STRATIFIED).
+   * @param randomSeed The seed of the generator of the order.
+   */
+  void setSamplingOrder(int samplingOrder, unsigned long randomSeed = 5489UL);
+
   /**
    * @brief Open the domain VTK file.
    * 
@@ -0,0 +1,165 @@
+/**
+ * @file DomainProcedural.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "DomainProcedural.h"
+
+DomainProcedural::DomainProcedural(Point lowerCorner, Point upperCorner,
+                                   double volume, Point *seeds,
+                                   int numberOfSeeds, int totalNumberOfPoints,
+                                   DomainFunction *domainFunction,
+                                   unsigned long randomSeed)
+    : Domain(lowerCorner.dimension()) {
+  int i;
+
+  if (lowerCorner.dimension() != upperCorner.dimension()) {
+    throw invalid_argument("Oops! The corners have different dimensions.");
+  }
+  if (numberOfSeeds < 1) {
+    throw invalid_argument("Oops! The domain needs at least one seed.");
+  }
+
+  _lowerCorner[0] = lowerCorner.x();
+  _lowerCorner[1] = lowerCorner.y();
+  _lowerCorner[2] = dimension() == 3 ? lowerCorner.z() : 0.0;
+  _upperCorner[0] = upperCorner.x();
+  _upperCorner[1] = upperCorner.y();
+  _upperCorner[2] = dimension() == 3 ? upperCorner.z() : 0.0;
+  setVolume(volume);
+
+  _numberOfSeeds = numberOfSeeds;
+  _seeds = new double[3 * _numberOfSeeds];
+  for (i = 0; i < _numberOfSeeds; i++) {
+    _seeds[3 * i] = seeds[i].x();
+    _seeds[3 * i + 1] = seeds[i].y();
+    _seeds[3 * i + 2] = dimension() == 3 ? seeds[i].z() : 0.0;
+  }
+
+  _totalNumberOfPoints = totalNumberOfPoints;
+  _domainFunction = domainFunction;
+  setRandomSeed(randomSeed);
+}
+
+DomainProcedural::~DomainProcedural() { delete[] _seeds; }
+
+double DomainProcedural::uniform() {
+  return static_cast<double>(_generator() >> 11) * 0x1.0p-53;
+}
+
+double DomainProcedural::radicalInverse(int base, long index) {
+  double value = 0.0, scale = 1.0 / base;
+  for (; index > 0; index /= base) {
+    value += (index % base) * scale;
+    scale /= base;
+  }
+  return value;
+}
+
+Point DomainProcedural::point() {
+  int attempt, d;
+  double coordinates[3], u;
+  Point pt(dimension());
+
+  if (!hasAvailablePoint()) {
+    throw invalid_argument("Oops! No more points on domain.");
+  }
+
+  for (attempt = 0; attempt < _MAXIMUMNUMBEROFATTEMPTS; attempt++) {
+    if (_samplingOrder == HALTON) {
+      _sequenceIndex++;
+      for (d = 0; d < dimension(); d++) {
+        u = radicalInverse(_BASES[d], _sequenceIndex) + _shift[d];
+        coordinates[d] = _lowerCorner[d] + (u < 1.0 ? u : u - 1.0) *
+                                               (_upperCorner[d] -
+                                                _lowerCorner[d]);
+      }
+    } else {
+      for (d = 0; d < dimension(); d++) {
+        coordinates[d] =
+            _lowerCorner[d] + uniform() * (_upperCorner[d] - _lowerCorner[d]);
+      }
+    }
+    pt.set(coordinates);
+    if (_domainFunction->isIn(pt, pt)) {
+      _currentPoint++;
+      return pt;
+    }
+  }
+
+  throw invalid_argument("Oops! The box does not intersect the domain.");
+}
+
+Point DomainProcedural::seed(int seedID) {
+  if (seedID >= 0 && seedID < _numberOfSeeds) {
+    return Point(&_seeds[3 * seedID], dimension());
+  } else {
+    throw invalid_argument("Oops! Invalid seed ID.");
+  }
+}
+
+bool DomainProcedural::isIn(Point pointA, Point pointB) {
+  return _domainFunction->isIn(pointA, pointB);
+}
+
+int DomainProcedural::totalNumberOfPoints() { return _totalNumberOfPoints; }
+
+int DomainProcedural::numberOfSeeds() { return _numberOfSeeds; }
+
+bool DomainProcedural::hasAvailablePoint() {
+  return _currentPoint < _totalNumberOfPoints;
+}
+
+void DomainProcedural::reset() {
+  int d;
+  _generator.seed(_randomSeed);
+  _currentPoint = 0;
+  _sequenceIndex = 0;
+  if (_samplingOrder == HALTON) {
+    for (d = 0; d < 3; d++) {
+      _shift[d] = uniform();
+    }
+  }
+}
+
+unsigned long DomainProcedural::randomSeed() { return _randomSeed; }
+
+void DomainProcedural::setRandomSeed(unsigned long value) {
+  _randomSeed = value;
+  reset();
+}
+
+int DomainProcedural::samplingOrder() { return _samplingOrder; }
+
+void DomainProcedural::setSamplingOrder(int value) {
+  if (value != UNIFORM && value != HALTON) {
+    throw invalid_argument("Oops! Invalid sampling order.");
+  }
+  _samplingOrder = value;
+  reset();
+}
+
+DomainFunction *DomainProcedural::domainFunction() { return _domainFunction; }
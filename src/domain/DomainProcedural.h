@@ -0,0 +1,286 @@
+/**
+ * @file DomainProcedural.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <random>
+#include <string>
+
+#include "interface/Domain.h"
+#include "interface/DomainFunction.h"
+using std::invalid_argument;
+
+#ifndef _CCOLAB_DOMAIN_DOMAINPROCEDURAL_H
+#define _CCOLAB_DOMAIN_DOMAINPROCEDURAL_H
+/**
+ * @brief Domain whose points are generated when they are visited.
+ *
+ * The points are uniform on a box, and the ones out of the domain function
+ * (a point P is in the domain if the segment with endpoints P and P is) are
+ * discarded. The generator is seeded, so the points are the same on every
+ * run and after each reset(), as the points of a DomainFile. Nothing is
+ * stored but the seeds, so any number of points can be visited.
+ */
+class DomainProcedural : public Domain {
+ public:
+  /**
+   * @brief The points are uniform random on the box.
+   *
+   */
+  static const int UNIFORM = 0;
+
+  /**
+   * @brief The points follow the Halton sequence (bases 2, 3 and 5) on the
+   * box, shifted by a random vector (Cranley-Patterson rotation).
+   *
+   */
+  static const int HALTON = 1;
+
+ private:
+  /**
+   * @brief The maximum number of points generated out of the domain
+   * function in a row.
+   *
+   */
+  const int _MAXIMUMNUMBEROFATTEMPTS = 1000000;
+
+  /**
+   * @brief The bases of the Halton sequence on each axis.
+   *
+   */
+  const int _BASES[3] = {2, 3, 5};
+
+  /**
+   * @brief The lower corner of the box.
+   *
+   */
+  double _lowerCorner[3];
+
+  /**
+   * @brief The upper corner of the box.
+   *
+   */
+  double _upperCorner[3];
+
+  /**
+   * @brief The domain seeds.
+   *
+   */
+  double *_seeds;
+
+  /**
+   * @brief Total number of seeds in the domain.
+   *
+   */
+  int _numberOfSeeds = 0;
+
+  /**
+   * @brief The number of points visited since the last reset.
+   *
+   */
+  int _currentPoint = 0;
+
+  /**
+   * @brief Total number of points to visit (before a reset).
+   *
+   */
+  int _totalNumberOfPoints;
+
+  /**
+   * @brief The seed of the generator.
+   *
+   */
+  unsigned long _randomSeed;
+
+  /**
+   * @brief The generator of the points.
+   *
+   */
+  std::mt19937_64 _generator;
+
+  /**
+   * @brief The sampling order of the points.
+   *
+   */
+  int _samplingOrder = UNIFORM;
+
+  /**
+   * @brief The index of the next point of the Halton sequence.
+   *
+   */
+  long _sequenceIndex = 0;
+
+  /**
+   * @brief The random shift of the Halton sequence on each axis.
+   *
+   */
+  double _shift[3];
+
+  /**
+   * @brief The domain function.
+   *
+   */
+  DomainFunction *_domainFunction;
+
+  /**
+   * @brief Get a uniform number in [0, 1) from the generator. The 53 bits
+   * are taken from the generator output, so the sequence does not depend on
+   * the standard library.
+   *
+   * @return The number.
+   */
+  double uniform();
+
+  /**
+   * @brief Get the radical inverse of the index on the base (the van der
+   * Corput sequence).
+   *
+   * @param base The base.
+   * @param index The index.
+   * @return The radical inverse, in [0, 1).
+   */
+  double radicalInverse(int base, long index);
+
+ public:
+  /**
+   * @brief Construct a new Domain Procedural object.
+   *
+   * @param lowerCorner The lower corner of the box.
+   * @param upperCorner The upper corner of the box.
+   * @param volume The domain volume (in m^3), that is, the volume of the box
+   * inside the domain function.
+   * @param seeds The domain seeds.
+   * @param numberOfSeeds The number of seeds.
+   * @param totalNumberOfPoints The total number of points to visit (before a
+   * reset).
+   * @param domainFunction The domain function.
+   * @param randomSeed The seed of the generator.
+   */
+  DomainProcedural(Point lowerCorner, Point upperCorner, double volume,
+                   Point *seeds, int numberOfSeeds, int totalNumberOfPoints,
+                   DomainFunction *domainFunction,
+                   unsigned long randomSeed = 5489UL);
+
+  /**
+   * @brief Destroy the Domain Procedural object.
+   *
+   */
+  virtual ~DomainProcedural();
+
+  /**
+   * @brief Get a point in the domain.
+   *
+   * @return A point in the domain.
+   */
+  virtual Point point();
+
+  /**
+   * @brief Get a seed in the domain.
+   *
+   * @param seedID The seed index.
+   * @return A seed in the domain.
+   */
+  virtual Point seed(int seedID);
+
+  /**
+   * @brief Check if the segment with endpoints A and B is in domain.
+   *
+   * @param pointA A given point in domain.
+   * @param pointB A given point in domain.
+   * @return Returns true if the segment with endpoints A and B is in domain.
+   * Returns false otherwise.
+   */
+  virtual bool isIn(Point pointA, Point pointB);
+
+  /**
+   * @brief Get the total number of points in domain.
+   *
+   * @return The total number of points.
+   */
+  virtual int totalNumberOfPoints();
+
+  /**
+   * @brief Get the number of seeds.
+   *
+   * @return The number of seeds.
+   */
+  virtual int numberOfSeeds();
+
+  /**
+   * @brief Check if the domain has available point to be visited.
+   *
+   * @return Returns true if the domain has available point to be visited.
+   * Returns false otherwise.
+   */
+  virtual bool hasAvailablePoint();
+
+  /**
+   * @brief Reset the domain in a way that its points could be visited again
+   * (the generator is seeded again).
+   *
+   */
+  virtual void reset();
+
+  /**
+   * @brief Get the seed of the generator.
+   *
+   * @return The seed of the generator.
+   */
+  unsigned long randomSeed();
+
+  /**
+   * @brief Set the seed of the generator (the domain is reset).
+   *
+   * @param value The seed of the generator.
+   */
+  void setRandomSeed(unsigned long value);
+
+  /**
+   * @brief Get the sampling order of the points.
+   *
+   * @return The sampling order (UNIFORM or HALTON).
+   */
+  int samplingOrder();
+
+  /**
+   * @brief Set the sampling order of the points (the domain is reset).
+   *
+   * The Halton points fill the box evenly at every prefix of the sequence,
+   * so fewer points are rejected by the distance criterion than with the
+   * uniform points.
+   *
+   * @param value The sampling order (UNIFORM or HALTON).
+   */
+  void setSamplingOrder(int value);
+
+  /**
+   * @brief Get the domain function.
+   *
+   * @return The domain function.
+   */
+  DomainFunction *domainFunction();
+};
+#endif  //_CCOLAB_DOMAIN_DOMAINPROCEDURAL_H
@@ -35,18 +35,16 @@ DomainVoronoi::DomainVoronoi(Domain *domain, TreeModel **trees,
   _geometry = new Geometry(domain->dimension());
   _targetPerfusionFlow = targetPerfusionFlow;
   _territoryWeigth = territoryWeigth;
+  _distances = new double[numberOfTrees];
   setTrees(trees);
 }
 
 DomainVoronoi::~DomainVoronoi() {
-  int i;
   if (_totalPoints > 0) {
     delete[] _pointTreeID;
-    for (i = 0; i < _totalPoints; i++) {
-      delete _points[i];
-    }
     delete[] _points;
   }
+  delete[] _distances;
 }
 
 void DomainVoronoi::setTrees(TreeModel **trees) {
@@ -62,6 +60,10 @@ double DomainVoronoi::territoryWeigth() { return _territoryWeigth; }
 
 void DomainVoronoi::extractReferencePoints() {
   int t, i, n;
+  if (_totalPoints > 0) {
+    delete[] _pointTreeID;
+    delete[] _points;
+  }
   _totalPoints = 0;
   _currentNumberOfPoints = 0;
 
@@ -71,13 +73,12 @@ void DomainVoronoi::extractReferencePoints() {
   }
 
   if (_totalPoints > 0) {
-    _points = new Point *[_totalPoints];
+    _points = new Point[_totalPoints];
     _pointTreeID = new int[_totalPoints];
     for (t = 0; t < numberOfSubsets(); t++) {
       for (i = _trees[t]->begin(); i < _trees[t]->end(); i++) {
         //if(_trees[t]->isTerminal(i)) {
-          _points[_currentNumberOfPoints] = new Point(domain()->dimension());
-          *_points[_currentNumberOfPoints] = _trees[t]->distalPoint(i);
+          _points[_currentNumberOfPoints] = _trees[t]->distalPoint(i);
           _pointTreeID[_currentNumberOfPoints] = t;
           _currentNumberOfPoints++;
         //}
@@ -89,24 +90,22 @@ void DomainVoronoi::extractReferencePoints() {
   }
 }
 
-double *DomainVoronoi::distanceFromTrees(Point point){
+void DomainVoronoi::distanceFromTrees(Point point, double *distances) {
   int i;
-  double minDistance = 1e10, d, *dist = new double [numberOfSubsets()];
+  double d;
 
-  /* Initialize the distance vector dist. */
+  /* Initialize the distance vector. */
   for (i = 0; i < numberOfSubsets(); i++) {
-    dist[i] = 1e10;
+    distances[i] = 1e10;
   }
 
   /* Get the minimum distance from the given point to each tree. */
   for (i = 0; i < _currentNumberOfPoints; i++) {
-    d = _geometry->distance(point, *_points[i]);
-    if (d < dist[_pointTreeID[i]]) {
-      dist[_pointTreeID[i]] = d;
+    d = _geometry->distance(point, _points[i]);
+    if (d < distances[_pointTreeID[i]]) {
+      distances[_pointTreeID[i]] = d;
     }
   }
-
-  return dist;
 }
 
 void DomainVoronoi::territory(string filename) {
@@ -126,7 +125,8 @@ void DomainVoronoi::territory(string filename) {
     domain()->reset();
     while (domain()->hasAvailablePoint()) {
       point = domain()->point();
-      dist = distanceFromTrees(point);
+      distanceFromTrees(point, _distances);
+      dist = _distances;
       minDistTree = 0;
       for(j = 0; j < numberOfSubsets(); j++) {
         if(dist[j] < dist[minDistTree]){
@@ -137,7 +137,6 @@ void DomainVoronoi::territory(string filename) {
       subset[i] = minDistTree;
       territory[subset[i]] += 1;
       i++;
-      delete[] dist;
     }
 
     domain()->reset();
@@ -218,7 +217,7 @@ void DomainVoronoi::referencePoints(string filename, double unit) {
     file << "x" << delimiter << "y" << delimiter << "z" << delimiter << "SUBSET"
          << endl;
     for (i = 0; i < _currentNumberOfPoints; i++) {
-      point = *_points[i];
+      point = _points[i];
       z = domain()->dimension() == 2 ? 0.0 : point.z() * unit;
       file << point.x() * unit << delimiter << point.y() * unit << delimiter
            << z << delimiter << _pointTreeID[i] << endl;
@@ -235,7 +234,8 @@ int DomainVoronoi::inSubset(Point point) {
   double d, *dist, dMax = -1.e10;
   bool checkTargetFlow = true;
 
-  dist = distanceFromTrees(point);
+  distanceFromTrees(point, _distances);
+  dist = _distances;
 
   /* Get the maximum value in the vector dist. */
   for (i = 0; i < numberOfSubsets(); i++) {
@@ -270,7 +270,5 @@ int DomainVoronoi::inSubset(Point point) {
     }
   }
 
-  delete[] dist;
-
   return subset;
 }
@@ -58,7 +58,14 @@ class DomainVoronoi : public DomainSubsets {
    * @brief The vector of points.
    *
    */
-  Point **_points;
+  Point *_points = nullptr;
+
+  /**
+   * @brief The distances from the point to each tree, filled by
+   * distanceFromTrees (allocated once, so the queries do not allocate).
+   *
+   */
+  double *_distances;
 
   /**
    * @brief The vector of points ID.
@@ -70,7 +77,7 @@ class DomainVoronoi : public DomainSubsets {
    * @brief The total number of points.
    *
    */
-  int _totalPoints;
+  int _totalPoints = 0;
 
   /**
    * @brief The current number of points.
@@ -101,10 +108,10 @@ class DomainVoronoi : public DomainSubsets {
    * the trees on the forest.
    * 
    * @param point The given point
-   * @return vector of the distances between the given point and
-   * the trees on the forest.
+   * @param distances The vector of the distances between the given point and
+   * the trees on the forest (at least numberOfSubsets() positions).
    */
-  double *distanceFromTrees(Point point);
+  void distanceFromTrees(Point point, double *distances);
 
  public:
   /**
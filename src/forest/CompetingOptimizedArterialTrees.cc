@@ -50,7 +50,7 @@ CompetingOptimizedArterialTrees::CompetingOptimizedArterialTrees(
   _targetFunction = new TargetFunction *[_numberOfTrees];
   _geometricOptimization = new GeometricOptimization *[_numberOfTrees];
 
-  _distanceCriterion[0] = new ClassicDistanceCriterion(_trees[0]);
+  _distanceCriterion[0] = new GridDistanceCriterion(_trees[0]);
   for (t = 0; t < _numberOfTrees; t++) {
     _active[t] = true;
 
@@ -146,14 +146,15 @@ void CompetingOptimizedArterialTrees::grow() {
   int i, j, s, t, treeID, segmentID, Kterm, attempt, totalAttempts,
       *closestSegments;
   bool pass;
+  long allocations;
   double value, targetFunctionValue, factor;
   Progress progress(_numberOfTerminals, "Growing trees");
-  Point point(dimension), middle(dimension);
+  Point point(dimension);
   ForestIntersection forestIntersection(_numberOfTrees, _trees);
   ForestConnectionSearch vicinity(_numberOfConnections, _trees, _numberOfTrees,
-                                  _active, _totalNumberOfSegments, dimension);
+                                  _active);
   Segment newSegment(dimension);
-  Segment *bifurcationSegment, updatedBifurcationSegment(dimension);
+  Segment updatedBifurcationSegment(dimension);
   Geometry geometry(dimension);
   Connection connection, optimalConnection;
 
@@ -169,9 +170,12 @@ void CompetingOptimizedArterialTrees::grow() {
     progress.next();
   }
 
+  _numberOfAcceptedPoints = 0;
+  _numberOfRejectedPoints = 0;
   totalAttempts = 0;
   factor = 0.99;
-  /* Grow the first tree stage. */
+  /* Grow the first tree stage (counting the heap allocations). */
+  allocations = AllocationCounter::numberOfAllocations();
   while (Kterm < _numberOfTerminals) {
     /* Set the activity for each tree. */
     for (t = 0; t < _numberOfTrees; t++) {
@@ -199,9 +203,11 @@ void CompetingOptimizedArterialTrees::grow() {
       }
 
       if (pass) {
+        _numberOfAcceptedPoints++;
         break;
       }
 
+      _numberOfRejectedPoints++;
       attempt++;
       if (attempt > _maximumNumberOfAttempts) {
         /* Relax distance criterion. */
@@ -225,25 +231,15 @@ void CompetingOptimizedArterialTrees::grow() {
         continue;
       }
 
-      /* Do the connection. */
-      bifurcationSegment = _trees[treeID]->segment(segmentID);
-      middle = geometry.middle(_trees[treeID]->proximalPoint(segmentID),
-                               _trees[treeID]->distalPoint(segmentID));
       newSegment.setPoint(point);
       newSegment.setFlow(_terminalFlowFunction[treeID]->eval(newSegment));
-      updatedBifurcationSegment =
-          _trees[treeID]->growSegment(middle, *bifurcationSegment, newSegment);
-      newSegment = _trees[treeID]->right(updatedBifurcationSegment.ID());
 
-      /* Geometric optimization. */
-      connection = _geometricOptimization[treeID]->bifurcation(
-          updatedBifurcationSegment);
+      /* Geometric optimization (the tree is left unchanged). */
+      connection =
+          _geometricOptimization[treeID]->bifurcation(segmentID, newSegment);
       if (!connection.empty()) {
         connectionEvaluationTable[treeID]->add(connection);
       }
-
-      /* Undo the connection. */
-      _trees[treeID]->remove(newSegment);
     }
 
     treeID = -1;
@@ -329,11 +325,15 @@ void CompetingOptimizedArterialTrees::grow() {
     }
   }
 
+  _numberOfAllocations = AllocationCounter::numberOfAllocations() - allocations;
+
   /* Separate the subdomains. */
   _domainVoronoi = new DomainVoronoi(_domain, _trees, _targetPerfusionFlow,
                                     _numberOfTrees, 0.5);
 
-  /* Grow the second tree stage. */
+  /* Grow the second tree stage (the subdomains are not counted). */
+  allocations = AllocationCounter::numberOfAllocations();
+
   for (s = 0; s < _numberOfTrees; s++) {
     _domain->reset();
     factor = 0.9;
@@ -354,14 +354,17 @@ void CompetingOptimizedArterialTrees::grow() {
         treeID = _domainVoronoi->inSubset(point);
 
         if (treeID != s) {
+          _numberOfRejectedPoints++;
           continue;
         }
 
         /* Check distance criterion */
         if (_distanceCriterion[0]->eval(point)) {
+          _numberOfAcceptedPoints++;
           break;
         }
 
+        _numberOfRejectedPoints++;
         attempt++;
         if (attempt > _maximumNumberOfAttempts) {
           /* Relax distance criterion. */
@@ -380,26 +383,15 @@ void CompetingOptimizedArterialTrees::grow() {
       for (i = 0; i < vicinity.currentNumberOfConnections(); i++) {
         segmentID = closestSegments[2 * i + 1];
 
-        /* Do the connection. */
-        bifurcationSegment = _trees[treeID]->segment(segmentID);
-        middle = geometry.middle(_trees[treeID]->proximalPoint(segmentID),
-                                 _trees[treeID]->distalPoint(segmentID));
         newSegment.setPoint(point);
-
         newSegment.setFlow(_terminalFlowFunction[treeID]->eval(newSegment));
-        updatedBifurcationSegment = _trees[treeID]->growSegment(
-            middle, *bifurcationSegment, newSegment);
-        newSegment = _trees[treeID]->right(updatedBifurcationSegment.ID());
 
-        /* Geometric optimization. */
-        connection = _geometricOptimization[treeID]->bifurcation(
-            updatedBifurcationSegment);
+        /* Geometric optimization (the tree is left unchanged). */
+        connection =
+            _geometricOptimization[treeID]->bifurcation(segmentID, newSegment);
         if (!connection.empty()) {
           connectionEvaluationTable[treeID]->add(connection);
         }
-
-        /* Undo the connection. */
-        _trees[treeID]->remove(newSegment);
       }
 
       /* Reduce bifurcations to reasonable connections. */
@@ -454,4 +446,6 @@ void CompetingOptimizedArterialTrees::grow() {
       connectionEvaluationTable[s]->reset();
     }
   }
+  _numberOfAllocations +=
+      AllocationCounter::numberOfAllocations() - allocations;
 }
@@ -47,7 +47,7 @@ ForestCcoInvasion::ForestCcoInvasion(Domain *domain, TreeModel **trees,
   _maximumRootLength = new double[_numberOfTrees];
   _active = new bool[_numberOfTrees];
   _distanceCriterion = new DistanceCriterion *[1];
-  _distanceCriterion[0] = new ClassicDistanceCriterion(_trees[0]);
+  _distanceCriterion[0] = new GridDistanceCriterion(_trees[0]);
   _terminalFlowFunction = new TerminalFlowFunction *[_numberOfTrees];
   _targetFunction = new TargetFunction *[_numberOfTrees];
   _geometricOptimization = new GeometricOptimization *[_numberOfTrees];
@@ -148,14 +148,15 @@ void ForestCcoInvasion::grow() {
   int i, j, t, treeID, segmentID, Kterm, attempt, totalAttempts,
       *closestSegments;
   bool pass;
+  long allocations;
   double value, targetFunctionValue, factor;
   Progress progress(_numberOfTerminals, "Growing trees");
-  Point point(dimension), middle(dimension);
+  Point point(dimension);
   ForestIntersection forestIntersection(_numberOfTrees, _trees);
   ForestConnectionSearch vicinity(_numberOfConnections, _trees, _numberOfTrees,
-                                  _active, _totalNumberOfSegments, dimension);
+                                  _active);
   Segment newSegment(dimension);
-  Segment *bifurcationSegment, updatedBifurcationSegment(dimension);
+  Segment updatedBifurcationSegment(dimension);
   Geometry geometry(dimension);
   Connection connection, optimalConnection;
 
@@ -171,10 +172,13 @@ void ForestCcoInvasion::grow() {
     progress.next();
   }
 
+  _numberOfAcceptedPoints = 0;
+  _numberOfRejectedPoints = 0;
   totalAttempts = 0;
   factor = 0.9;
 
-  /* Grow the tree. */
+  /* Grow the tree (counting the heap allocations, see AllocationCounter). */
+  allocations = AllocationCounter::numberOfAllocations();
   while (Kterm < _numberOfTerminals) {
     /* Set the activity for each tree. */
     setActive();
@@ -195,9 +199,11 @@ void ForestCcoInvasion::grow() {
       }
 
       if (pass) {
+        _numberOfAcceptedPoints++;
         break;
       }
 
+      _numberOfRejectedPoints++;
       attempt += 1;
       if (attempt > _maximumNumberOfAttempts) {
         /* Relax distance criterion. */
@@ -223,25 +229,15 @@ void ForestCcoInvasion::grow() {
         continue;
       }
 
-      /* Do the connection. */
-      bifurcationSegment = _trees[treeID]->segment(segmentID);
-      middle = geometry.middle(_trees[treeID]->proximalPoint(segmentID),
-                               _trees[treeID]->distalPoint(segmentID));
       newSegment.setPoint(point);
       newSegment.setFlow(_terminalFlowFunction[treeID]->eval(newSegment));
-      updatedBifurcationSegment =
-          _trees[treeID]->growSegment(middle, *bifurcationSegment, newSegment);
-      newSegment = _trees[treeID]->right(updatedBifurcationSegment.ID());
 
-      /* Geometric optimization. */
-      connection = _geometricOptimization[treeID]->bifurcation(
-          updatedBifurcationSegment);
+      /* Geometric optimization (the tree is left unchanged). */
+      connection =
+          _geometricOptimization[treeID]->bifurcation(segmentID, newSegment);
       if (!connection.empty()) {
         connectionEvaluationTable[treeID]->add(connection);
       }
-
-      /* Undo the connection. */
-      _trees[treeID]->remove(newSegment);
     }
 
     treeID = -1;
@@ -318,4 +314,5 @@ void ForestCcoInvasion::grow() {
       connectionEvaluationTable[t]->reset();
     }
   }
+  _numberOfAllocations = AllocationCounter::numberOfAllocations() - allocations;
 }
@@ -30,9 +30,8 @@
 
 ForestConnectionSearch::ForestConnectionSearch(int numberOfConnections,
                                                TreeModel **trees,
-                                               int numberOfTrees, bool *active,
-                                               int totalNumberOfSegments,
-                                               int dimension) {
+                                               int numberOfTrees,
+                                               bool *active) {
   _trees = trees;
   _active = active;
   _numberOfConnections = numberOfConnections;
@@ -44,12 +43,10 @@ ForestConnectionSearch::ForestConnectionSearch(int numberOfConnections,
    *  Allocate all vectors once. It speed up the code because later it wont
    *  need to create/destroy objects as the tree grows.
    * */
-  _segmentDistance = new double[totalNumberOfSegments];
-  _segmentID = new int[totalNumberOfSegments];
-  _treeID = new int[totalNumberOfSegments];
+  _segmentDistance = new double[_numberOfTrees * _numberOfConnections];
+  _segmentID = new int[_numberOfTrees * _numberOfConnections];
+  _treeID = new int[_numberOfTrees * _numberOfConnections];
   _closestSegments = new int[2 * _numberOfConnections];
-
-  _geometry = new Geometry(dimension);
 }
 
 ForestConnectionSearch::~ForestConnectionSearch() {
@@ -68,27 +65,28 @@ int ForestConnectionSearch::currentNumberOfConnections() {
 }
 
 int *ForestConnectionSearch::atPoint(Point point) {
-  int t, i, j, k, oldSegmentID;
-  double d, oldDistance;
+  int t, i, j, numberOfSegments;
   _currentNumberOfSegments = 0;
 
-  /* Compute the distance of the point from each segment. */
+  /* Get the closest segments of each tree from its spatial index. */
   for (t = 0; t < _numberOfTrees; t++) {
     if (!_active[t]) {
       continue;
     }
 
-    for (i = _trees[t]->begin(); i < _trees[t]->end(); i++) {
-      d = _geometry->distanceFromSegment(point, _trees[t]->proximalPoint(i),
-                                         _trees[t]->distalPoint(i));
-      _segmentDistance[_currentNumberOfSegments] = d;
-      _segmentID[_currentNumberOfSegments] = i;
+    numberOfSegments = _trees[t]->nearestSegments(
+        point, _numberOfConnections, &_segmentID[_currentNumberOfSegments],
+        &_segmentDistance[_currentNumberOfSegments]);
+    for (i = 0; i < numberOfSegments; i++) {
       _treeID[_currentNumberOfSegments] = t;
       _currentNumberOfSegments++;
     }
   }
 
-  /* Sort the computed distances. */
+  /**
+   *  Merge the closest segments of the trees. The sort is stable, so the
+   *  ties keep sorted by tree and segment indexes.
+   */
   sort();
 
   /* Get the closest segments */
@@ -106,27 +104,12 @@ int *ForestConnectionSearch::atPoint(Point point) {
 }
 
 int *ForestConnectionSearch::atPoint(Point point, int treeID) {
-  int t, i, j, k, oldSegmentID;
-  double d, oldDistance;
-  _currentNumberOfSegments = 0;
+  int i, j;
 
-  /* Compute the distance of the point from the given tree. */
-  for (i = _trees[treeID]->begin(); i < _trees[treeID]->end(); i++) {
-    d = _geometry->distanceFromSegment(point, _trees[treeID]->proximalPoint(i),
-                                       _trees[treeID]->distalPoint(i));
-    _segmentDistance[_currentNumberOfSegments] = d;
-    _segmentID[_currentNumberOfSegments] = i;
-    _treeID[_currentNumberOfSegments] = treeID;
-    _currentNumberOfSegments++;
-  }
-
-  /* Sort the computed distances. */
-  sort();
-
-  /* Get the closest segments */
-  _currentNumberOfConnections = _currentNumberOfSegments < _numberOfConnections
-                                    ? _currentNumberOfSegments
-                                    : _numberOfConnections;
+  /* Get the closest segments of the given tree from its spatial index. */
+  _currentNumberOfSegments = _trees[treeID]->nearestSegments(
+      point, _numberOfConnections, _segmentID, _segmentDistance);
+  _currentNumberOfConnections = _currentNumberOfSegments;
 
   for (i = 0; i < _currentNumberOfConnections; i++) {
     j = 2 * i;
@@ -99,12 +99,6 @@ class ForestConnectionSearch {
    */
   int *_closestSegments;
 
-  /**
-   * @brief The Geometry object to do some geometric calcultions.
-   * 
-   */
-  Geometry *_geometry;
-
   /**
    * @brief Ascendent sort of the segment distance between the new point and
    * the segments on the trees.
@@ -120,12 +114,9 @@ class ForestConnectionSearch {
    * @param trees The vector of trees.
    * @param numberOfTrees The number of trees.
    * @param active The vector flaging the status of a tree.
-   * @param totalNumberOfSegments The total number of segments.
-   * @param dimension The dimension of the points in domain.
    */
   ForestConnectionSearch(int numberOfConnections, TreeModel **trees,
-                         int numberOfTrees, bool *active,
-                         int totalNumberOfSegments, int dimension);
+                         int numberOfTrees, bool *active);
 
   /**
    * @brief Destroy the Forest Connection Search object.
@@ -30,34 +30,62 @@
 
 ForestIntersection::ForestIntersection(int numberOfTress, TreeModel **trees)
     : GeometricRestriction() {
+  int t, totalNumberOfSegments = 0;
   _numberOfTrees = numberOfTress;
   _trees = trees;
-  _geometry = new Geometry(trees[0]->dimension());
+
+  for (t = 0; t < _numberOfTrees; t++) {
+    totalNumberOfSegments =
+        std::max(totalNumberOfSegments, trees[t]->totalNumberOfSegments());
+  }
+  _nearbySegments = new int[totalNumberOfSegments];
+}
+
+ForestIntersection::~ForestIntersection() {
+  delete[] _nearbySegments;
 }
 
 void ForestIntersection::setTreeID(int value) { _treeID = value; }
 
 bool ForestIntersection::pass(Segment segment) {
   /* Search for intersection. */
-  int t, i, j;
-  Segment checkSegments[3] = {
-      segment,
-      _trees[_treeID]->left(segment.ID()),
-      _trees[_treeID]->right(segment.ID()),
+  int t, i, j, k, count, numberOfSegments;
+  double checkRadius, maximumRadius;
+  Point proximalPoint, distalPoint;
+  int checkSegments[3] = {
+      segment.ID(),
+      _trees[_treeID]->leftID(segment.ID()),
+      _trees[_treeID]->rightID(segment.ID()),
   };
 
   for (t = 0; t < _numberOfTrees; t++) {
     if (t != _treeID) {
       setTree(_trees[t]);
-      for (i = tree()->begin(); i < tree()->end(); i++) {
-        for (j = 0; j < 3; j++) {
-          if (_geometry->hasIntersection(
-                  tree()->proximalPoint(i), tree()->distalPoint(i),
-                  _trees[_treeID]->proximalPoint(checkSegments[j].ID()),
-                  _trees[_treeID]->distalPoint(checkSegments[j].ID()),
-                  tree()->radius(i) +
-                      _trees[_treeID]->radius(checkSegments[j].ID()))) {
-            return false;
+
+      /* No segment is thicker than the root. */
+      maximumRadius = tree()->radius(tree()->rootID());
+
+      for (j = 0; j < 3; j++) {
+        proximalPoint = _trees[_treeID]->proximalPoint(checkSegments[j]);
+        distalPoint = _trees[_treeID]->distalPoint(checkSegments[j]);
+        checkRadius = _trees[_treeID]->radius(checkSegments[j]);
+
+        /* Only the segments close to the checked one may intersect it. */
+        numberOfSegments = tree()->nearbySegments(
+            proximalPoint, distalPoint, 2.0 * (checkRadius + maximumRadius),
+            _nearbySegments);
+
+        /* The segments are tested in batches by SegmentIntersectionKernel. */
+        count = 0;
+        for (k = 0; k < numberOfSegments; k++) {
+          i = _nearbySegments[k];
+          addCandidate(i, tree()->radius(i) + checkRadius, count++);
+          if (count == SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS ||
+              k == numberOfSegments - 1) {
+            if (hasIntersection(proximalPoint, distalPoint, count)) {
+              return false;
+            }
+            count = 0;
           }
         }
       }
@@ -66,3 +94,32 @@ bool ForestIntersection::pass(Segment segment) {
 
   return true;
 }
+
+void ForestIntersection::addCandidate(int segmentID, double tolerance,
+                                      int position) {
+  int k;
+  Point proximalPoint = tree()->proximalPoint(segmentID),
+        distalPoint = tree()->distalPoint(segmentID);
+
+  for (k = 0; k < 3; k++) {
+    _proximalPoints[3 * position + k] = proximalPoint.coordinates()[k];
+    _distalPoints[3 * position + k] = distalPoint.coordinates()[k];
+  }
+  _tolerances[position] = tolerance;
+}
+
+bool ForestIntersection::hasIntersection(Point pointC, Point pointD,
+                                         int numberOfSegments) {
+  return numberOfSegments > 0 &&
+         SegmentIntersectionKernel::intersectionMask(
+             tree()->dimension(), pointC.coordinates(), pointD.coordinates(),
+             _proximalPoints, _distalPoints, _tolerances, numberOfSegments,
+             true) != 0;
+}
+
+GeometricRestriction *ForestIntersection::clone() {
+  ForestIntersection *forestIntersection =
+      new ForestIntersection(_numberOfTrees, _trees);
+  forestIntersection->setTreeID(_treeID);
+  return forestIntersection;
+}
@@ -26,11 +26,13 @@
  * @version 1.0
  * @date 2022-05-18
  */
+#include <algorithm>
 #include <iostream>
 #include <string>
 
 #include "cco/interface/GeometricRestriction.h"
 #include "geometry/Geometry.h"
+#include "geometry/SegmentIntersectionKernel.h"
 using std::cout;
 using std::endl;
 
@@ -56,10 +58,51 @@ class ForestIntersection : public GeometricRestriction {
   TreeModel **_trees;
 
   /**
-   * @brief The Geometry object to do some geometric calculations.
+   * @brief The segments close to the checked segment.
    * 
    */
-  Geometry *_geometry;
+  int *_nearbySegments;
+
+  /**
+   * @brief The proximal points of the segments tested at once (3
+   * coordinates per segment).
+   * 
+   */
+  double
+      _proximalPoints[3 * SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS];
+
+  /**
+   * @brief The distal points of the segments tested at once.
+   * 
+   */
+  double _distalPoints[3 * SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS];
+
+  /**
+   * @brief The intersection tolerance of the segments tested at once.
+   * 
+   */
+  double _tolerances[SegmentIntersectionKernel::MAXIMUMNUMBEROFSEGMENTS];
+
+  /**
+   * @brief Add the segment of the tree to the segments tested at once.
+   * 
+   * @param segmentID The segment index.
+   * @param tolerance The intersection tolerance.
+   * @param position The position on the segments tested at once.
+   */
+  void addCandidate(int segmentID, double tolerance, int position);
+
+  /**
+   * @brief Check if some of the segments tested at once intersects the
+   * segment CD.
+   * 
+   * @param pointC The point C.
+   * @param pointD The point D.
+   * @param numberOfSegments The number of segments.
+   * @return Returns true if some segment intersects CD. Returns false
+   * otherwise.
+   */
+  bool hasIntersection(Point pointC, Point pointD, int numberOfSegments);
 
  public:
   /**
@@ -74,7 +117,7 @@ class ForestIntersection : public GeometricRestriction {
    * @brief Destroy the Forest Intersection object.
    * 
    */
-  ~ForestIntersection() {}
+  ~ForestIntersection();
 
   /**
    * @brief Check if a given segment (or its descendents) intersects other
@@ -92,5 +135,12 @@ class ForestIntersection : public GeometricRestriction {
    * @param value The tree index.
    */
   void setTreeID(int value);
+
+  /**
+   * @brief Create a copy of the restriction.
+   * 
+   * @return The copy of the restriction.
+   */
+  virtual GeometricRestriction *clone();
 };
 #endif //_CCOLAB_FOREST_FORESTINTERSECTION_H
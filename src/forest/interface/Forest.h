@@ -36,6 +36,7 @@
 #include "ForestConstantTerminalFlow.h"
 #include "ForestIntersection.h"
 #include "cco/ClassicDistanceCriterion.h"
+#include "cco/GridDistanceCriterion.h"
 #include "cco/Connection.h"
 #include "cco/ConnectionEvaluationTable.h"
 #include "cco/SimpleOptimization.h"
@@ -45,6 +46,7 @@
 #include "cco/interface/TerminalFlowFunction.h"
 #include "domain/interface/Domain.h"
 #include "geometry/Geometry.h"
+#include "progress/AllocationCounter.h"
 #include "progress/Progress.h"
 #include "tree/TreeConnectionSearch.h"
 #include "tree/TreeFile.h"
@@ -89,6 +91,26 @@ class Forest {
    */
   int _numberOfConnections;
 
+  /**
+   * @brief The number of domain points that passed the distance criterion
+   * on the last grow().
+   * 
+   */
+  long _numberOfAcceptedPoints;
+
+  /**
+   * @brief The number of domain points discarded on the last grow().
+   * 
+   */
+  long _numberOfRejectedPoints;
+
+  /**
+   * @brief The number of heap allocations while connecting the terminals on
+   * the last grow() (see AllocationCounter).
+   * 
+   */
+  long _numberOfAllocations;
+
   /**
    * @brief The index of the tree with largest perfusion flow.
    * 
@@ -205,6 +227,9 @@ class Forest {
     _lengthExpoent = lengthExpoent;
     _maximumNumberOfAttempts = 10;
     _numberOfConnections = 20;
+    _numberOfAcceptedPoints = 0;
+    _numberOfRejectedPoints = 0;
+    _numberOfAllocations = 0;
   }
 
   /**
@@ -223,7 +248,7 @@ class Forest {
     _trees = trees;
 
     for (i = 0; i < _numberOfTrees; i++) {
-      _distanceCriterion[i] = new ClassicDistanceCriterion(_trees[i]);
+      _distanceCriterion[i] = new GridDistanceCriterion(_trees[i]);
       /* Default functions */
       _terminalFlowFunction[i] = new ForestConstantTerminalFlow(
           _trees, _numberOfTrees, _numberOfTerminals);
@@ -372,6 +397,30 @@ class Forest {
     _numberOfConnections = value;
   }
 
+  /**
+   * @brief Get the number of domain points that passed the distance
+   * criterion on the last grow().
+   * 
+   * @return The number of accepted points.
+   */
+  virtual long numberOfAcceptedPoints() { return _numberOfAcceptedPoints; }
+
+  /**
+   * @brief Get the number of domain points discarded on the last grow().
+   * 
+   * @return The number of rejected points.
+   */
+  virtual long numberOfRejectedPoints() { return _numberOfRejectedPoints; }
+
+  /**
+   * @brief Get the number of heap allocations while connecting the
+   * terminals on the last grow(). It is zero unless the code is compiled
+   * with CCOLAB_COUNT_ALLOCATIONS.
+   * 
+   * @return The number of heap allocations.
+   */
+  virtual long numberOfAllocations() { return _numberOfAllocations; }
+
   /**
    * @brief Write the comma-separated values (CSV) file for the 
    * forest attained flow.
@@ -430,7 +479,7 @@ class Forest {
                    << setprecision(numeric_limits<double>::digits10)
                    << _trees[t]->volume() << delimiter
                    << setprecision(numeric_limits<double>::digits10)
-                   << _trees[t]->radius(_trees[t]->root().ID()) << endl;
+                   << _trees[t]->radius(_trees[t]->rootID()) << endl;
       }
 
       volumeFile.close();
@@ -0,0 +1,564 @@
+/**
+ * @file BoundingVolumeHierarchy.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "BoundingVolumeHierarchy.h"
+
+#include <cmath>
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(int capacity,
+                                                 int dimension) {
+  int i, numberOfNodes = 2 * capacity;
+  _capacity = capacity;
+  _dimension = dimension;
+  _root = _NULLNODE;
+  _numberOfSegments = 0;
+
+  /**
+   *  Allocate all vectors once. It speed up the code because later it wont
+   *  need to create/destroy objects as the tree grows.
+   * */
+  _lower = new double[3 * numberOfNodes];
+  _upper = new double[3 * numberOfNodes];
+  _parent = new int[numberOfNodes];
+  _left = new int[numberOfNodes];
+  _right = new int[numberOfNodes];
+  _height = new int[numberOfNodes];
+  _segment = new int[numberOfNodes];
+  _queue = new int[numberOfNodes];
+  _queueDistance = new double[numberOfNodes];
+  _leaf = new int[capacity];
+  _proximalPoint = new Point[capacity];
+  _distalPoint = new Point[capacity];
+
+  /* Link all nodes on the list of free nodes. */
+  for (i = 0; i < numberOfNodes; i++) {
+    _parent[i] = i + 1 < numberOfNodes ? i + 1 : _NULLNODE;
+    _left[i] = _NULLNODE;
+    _right[i] = _NULLNODE;
+    _height[i] = -1;
+    _segment[i] = -1;
+  }
+  _freeNode = 0;
+
+  for (i = 0; i < capacity; i++) {
+    _leaf[i] = _NULLNODE;
+  }
+
+  _geometry = new Geometry(dimension);
+}
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy() {
+  delete[] _lower;
+  delete[] _upper;
+  delete[] _parent;
+  delete[] _left;
+  delete[] _right;
+  delete[] _height;
+  delete[] _segment;
+  delete[] _queue;
+  delete[] _queueDistance;
+  delete[] _leaf;
+  delete[] _proximalPoint;
+  delete[] _distalPoint;
+  delete _geometry;
+}
+
+int BoundingVolumeHierarchy::allocateNode() {
+  int node = _freeNode;
+  _freeNode = _parent[node];
+  _parent[node] = _NULLNODE;
+  _left[node] = _NULLNODE;
+  _right[node] = _NULLNODE;
+  _height[node] = 0;
+  _segment[node] = -1;
+
+  return node;
+}
+
+void BoundingVolumeHierarchy::freeNode(int node) {
+  _parent[node] = _freeNode;
+  _height[node] = -1;
+  _freeNode = node;
+}
+
+void BoundingVolumeHierarchy::coordinates(Point point, double *value) {
+  value[0] = point.x();
+  value[1] = point.y();
+  value[2] = _dimension == 3 ? point.z() : 0.0;
+}
+
+bool BoundingVolumeHierarchy::contains(int segmentID) {
+  return _leaf[segmentID] != _NULLNODE;
+}
+
+void BoundingVolumeHierarchy::fitLeaf(int leaf, int segmentID) {
+  int k;
+  double a[3], b[3], margin;
+
+  coordinates(_proximalPoint[segmentID], a);
+  coordinates(_distalPoint[segmentID], b);
+  margin = _MARGIN * _geometry->distance(_proximalPoint[segmentID],
+                                         _distalPoint[segmentID]);
+
+  for (k = 0; k < 3; k++) {
+    _lower[3 * leaf + k] = fmin(a[k], b[k]) - margin;
+    _upper[3 * leaf + k] = fmax(a[k], b[k]) + margin;
+  }
+}
+
+void BoundingVolumeHierarchy::fit(int node) {
+  int k, left = _left[node], right = _right[node];
+  for (k = 0; k < 3; k++) {
+    _lower[3 * node + k] = fmin(_lower[3 * left + k], _lower[3 * right + k]);
+    _upper[3 * node + k] = fmax(_upper[3 * left + k], _upper[3 * right + k]);
+  }
+  _height[node] =
+      1 + (_height[left] > _height[right] ? _height[left] : _height[right]);
+}
+
+double BoundingVolumeHierarchy::area(int node) {
+  double dx = _upper[3 * node] - _lower[3 * node],
+         dy = _upper[3 * node + 1] - _lower[3 * node + 1],
+         dz = _upper[3 * node + 2] - _lower[3 * node + 2];
+  return dx * dy + dy * dz + dz * dx;
+}
+
+double BoundingVolumeHierarchy::mergedArea(int nodeA, int nodeB) {
+  int k;
+  double d[3];
+  for (k = 0; k < 3; k++) {
+    d[k] = fmax(_upper[3 * nodeA + k], _upper[3 * nodeB + k]) -
+           fmin(_lower[3 * nodeA + k], _lower[3 * nodeB + k]);
+  }
+  return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+}
+
+void BoundingVolumeHierarchy::insertLeaf(int leaf) {
+  int node, left, right, sibling, oldParent, newParent;
+  double nodeArea, combinedArea, cost, inheritanceCost, leftCost, rightCost;
+
+  if (_root == _NULLNODE) {
+    _root = leaf;
+    _parent[leaf] = _NULLNODE;
+    return;
+  }
+
+  /**
+   *  Find the best sibling for the leaf by descending the tree with the
+   *  surface area heuristic.
+   */
+  node = _root;
+  while (_left[node] != _NULLNODE) {
+    left = _left[node];
+    right = _right[node];
+    nodeArea = area(node);
+    combinedArea = mergedArea(node, leaf);
+
+    /* Cost of creating a new parent for this node and the new leaf. */
+    cost = 2.0 * combinedArea;
+
+    /* Minimum cost of pushing the leaf further down the tree. */
+    inheritanceCost = 2.0 * (combinedArea - nodeArea);
+    leftCost = mergedArea(leaf, left) + inheritanceCost;
+    if (_left[left] != _NULLNODE) {
+      leftCost -= area(left);
+    }
+    rightCost = mergedArea(leaf, right) + inheritanceCost;
+    if (_left[right] != _NULLNODE) {
+      rightCost -= area(right);
+    }
+
+    if (cost < leftCost && cost < rightCost) {
+      break;
+    }
+
+    node = leftCost < rightCost ? left : right;
+  }
+  sibling = node;
+
+  /* Create a new parent for the sibling and the leaf. */
+  oldParent = _parent[sibling];
+  newParent = allocateNode();
+  _parent[newParent] = oldParent;
+  if (oldParent != _NULLNODE) {
+    if (_left[oldParent] == sibling) {
+      _left[oldParent] = newParent;
+    } else {
+      _right[oldParent] = newParent;
+    }
+  } else {
+    _root = newParent;
+  }
+  _left[newParent] = sibling;
+  _right[newParent] = leaf;
+  _parent[sibling] = newParent;
+  _parent[leaf] = newParent;
+  fit(newParent);
+
+  /* Walk back up the tree fixing heights and boxes. */
+  node = newParent;
+  while (node != _NULLNODE) {
+    node = balance(node);
+    fit(node);
+    node = _parent[node];
+  }
+}
+
+void BoundingVolumeHierarchy::removeLeaf(int leaf) {
+  int node, parent, grandParent, sibling;
+
+  if (leaf == _root) {
+    _root = _NULLNODE;
+    return;
+  }
+
+  parent = _parent[leaf];
+  grandParent = _parent[parent];
+  sibling = _left[parent] == leaf ? _right[parent] : _left[parent];
+
+  if (grandParent != _NULLNODE) {
+    /* Destroy the parent and connect the sibling to the grand parent. */
+    if (_left[grandParent] == parent) {
+      _left[grandParent] = sibling;
+    } else {
+      _right[grandParent] = sibling;
+    }
+    _parent[sibling] = grandParent;
+    freeNode(parent);
+
+    /* Adjust the ancestor boxes. */
+    node = grandParent;
+    while (node != _NULLNODE) {
+      node = balance(node);
+      fit(node);
+      node = _parent[node];
+    }
+  } else {
+    _root = sibling;
+    _parent[sibling] = _NULLNODE;
+    freeNode(parent);
+  }
+  _parent[leaf] = _NULLNODE;
+}
+
+int BoundingVolumeHierarchy::balance(int nodeA) {
+  int nodeB, nodeC, nodeD, nodeE, nodeF, nodeG, difference;
+
+  if (_left[nodeA] == _NULLNODE || _height[nodeA] < 2) {
+    return nodeA;
+  }
+
+  nodeB = _left[nodeA];
+  nodeC = _right[nodeA];
+  difference = _height[nodeC] - _height[nodeB];
+
+  /* Rotate C up. */
+  if (difference > 1) {
+    nodeF = _left[nodeC];
+    nodeG = _right[nodeC];
+
+    _left[nodeC] = nodeA;
+    _parent[nodeC] = _parent[nodeA];
+    _parent[nodeA] = nodeC;
+    if (_parent[nodeC] != _NULLNODE) {
+      if (_left[_parent[nodeC]] == nodeA) {
+        _left[_parent[nodeC]] = nodeC;
+      } else {
+        _right[_parent[nodeC]] = nodeC;
+      }
+    } else {
+      _root = nodeC;
+    }
+
+    if (_height[nodeF] > _height[nodeG]) {
+      _right[nodeC] = nodeF;
+      _right[nodeA] = nodeG;
+      _parent[nodeG] = nodeA;
+    } else {
+      _right[nodeC] = nodeG;
+      _right[nodeA] = nodeF;
+      _parent[nodeF] = nodeA;
+    }
+    fit(nodeA);
+    fit(nodeC);
+
+    return nodeC;
+  }
+
+  /* Rotate B up. */
+  if (difference < -1) {
+    nodeD = _left[nodeB];
+    nodeE = _right[nodeB];
+
+    _left[nodeB] = nodeA;
+    _parent[nodeB] = _parent[nodeA];
+    _parent[nodeA] = nodeB;
+    if (_parent[nodeB] != _NULLNODE) {
+      if (_left[_parent[nodeB]] == nodeA) {
+        _left[_parent[nodeB]] = nodeB;
+      } else {
+        _right[_parent[nodeB]] = nodeB;
+      }
+    } else {
+      _root = nodeB;
+    }
+
+    if (_height[nodeD] > _height[nodeE]) {
+      _right[nodeB] = nodeD;
+      _left[nodeA] = nodeE;
+      _parent[nodeE] = nodeA;
+    } else {
+      _right[nodeB] = nodeE;
+      _left[nodeA] = nodeD;
+      _parent[nodeD] = nodeA;
+    }
+    fit(nodeA);
+    fit(nodeB);
+
+    return nodeB;
+  }
+
+  return nodeA;
+}
+
+void BoundingVolumeHierarchy::update(int segmentID, Point proximalPoint,
+                                     Point distalPoint) {
+  int k, leaf = _leaf[segmentID];
+  bool isInside = true, isLoose = false;
+  double a[3], b[3], margin;
+
+  _proximalPoint[segmentID] = proximalPoint;
+  _distalPoint[segmentID] = distalPoint;
+
+  if (leaf == _NULLNODE) {
+    leaf = allocateNode();
+    _segment[leaf] = segmentID;
+    _leaf[segmentID] = leaf;
+    fitLeaf(leaf, segmentID);
+    insertLeaf(leaf);
+    _numberOfSegments++;
+    return;
+  }
+
+  /**
+   *  Keep the leaf where it is while the segment is inside its enlarged box
+   *  and that box is not too large for the segment.
+   */
+  margin = _MARGIN * _geometry->distance(proximalPoint, distalPoint);
+  coordinates(proximalPoint, a);
+  coordinates(distalPoint, b);
+  for (k = 0; k < 3; k++) {
+    isInside = isInside && _lower[3 * leaf + k] <= fmin(a[k], b[k]) &&
+               fmax(a[k], b[k]) <= _upper[3 * leaf + k];
+    isLoose = isLoose || (_upper[3 * leaf + k] - _lower[3 * leaf + k] >
+                          fabs(b[k] - a[k]) + 4.0 * margin);
+  }
+
+  if (isInside && !isLoose) {
+    return;
+  }
+
+  removeLeaf(leaf);
+  fitLeaf(leaf, segmentID);
+  insertLeaf(leaf);
+}
+
+void BoundingVolumeHierarchy::remove(int segmentID) {
+  int leaf = _leaf[segmentID];
+
+  if (leaf == _NULLNODE) {
+    return;
+  }
+
+  removeLeaf(leaf);
+  freeNode(leaf);
+  _leaf[segmentID] = _NULLNODE;
+  _numberOfSegments--;
+}
+
+double BoundingVolumeHierarchy::distanceFromBox(double *point, int node) {
+  int k;
+  double d, squaredDistance = 0.0;
+  for (k = 0; k < 3; k++) {
+    d = fmax(fmax(_lower[3 * node + k] - point[k], 0.0),
+             point[k] - _upper[3 * node + k]);
+    squaredDistance += d * d;
+  }
+
+  return sqrt(squaredDistance);
+}
+
+void BoundingVolumeHierarchy::push(int &size, int node, double distance) {
+  int i = size++, parent;
+
+  /* Sift up on the binary heap. */
+  while (i > 0) {
+    parent = (i - 1) / 2;
+    if (_queueDistance[parent] <= distance) {
+      break;
+    }
+    _queue[i] = _queue[parent];
+    _queueDistance[i] = _queueDistance[parent];
+    i = parent;
+  }
+  _queue[i] = node;
+  _queueDistance[i] = distance;
+}
+
+int BoundingVolumeHierarchy::pop(int &size) {
+  int i = 0, child, node = _queue[0], lastNode;
+  double lastDistance;
+
+  size--;
+  lastNode = _queue[size];
+  lastDistance = _queueDistance[size];
+
+  /* Sift down on the binary heap. */
+  while ((child = 2 * i + 1) < size) {
+    if (child + 1 < size && _queueDistance[child + 1] < _queueDistance[child]) {
+      child++;
+    }
+    if (lastDistance <= _queueDistance[child]) {
+      break;
+    }
+    _queue[i] = _queue[child];
+    _queueDistance[i] = _queueDistance[child];
+    i = child;
+  }
+  _queue[i] = lastNode;
+  _queueDistance[i] = lastDistance;
+
+  return node;
+}
+
+int BoundingVolumeHierarchy::nearest(Point point, int numberOfSegments,
+                                     int *segmentIDs, double *distances) {
+  int i, k, node, child, segmentID, size = 0, count = 0;
+  double p[3], d, nodeDistance, diagonal = 0.0, tolerance;
+
+  if (_root == _NULLNODE || numberOfSegments <= 0) {
+    return 0;
+  }
+
+  coordinates(point, p);
+
+  /**
+   *  The box distance is a lower bound for the segment distance, but both
+   *  are rounded. The tolerance (far above the rounding error) keeps every
+   *  segment that could tie with the farthest segment found.
+   */
+  for (k = 0; k < 3; k++) {
+    d = _upper[3 * _root + k] - _lower[3 * _root + k];
+    diagonal += d * d;
+  }
+  tolerance = 1e-9 * (sqrt(diagonal) + distanceFromBox(p, _root));
+
+  push(size, _root, distanceFromBox(p, _root));
+  while (size > 0) {
+    nodeDistance = _queueDistance[0];
+    if (count == numberOfSegments &&
+        nodeDistance > distances[count - 1] + tolerance) {
+      break;
+    }
+    node = pop(size);
+
+    if (_left[node] == _NULLNODE) {
+      segmentID = _segment[node];
+      d = _geometry->distanceFromSegment(point, _proximalPoint[segmentID],
+                                         _distalPoint[segmentID]);
+
+      /* Keep the closest segments sorted by distance and index. */
+      if (count == numberOfSegments &&
+          !(d < distances[count - 1] ||
+            (d == distances[count - 1] && segmentID < segmentIDs[count - 1]))) {
+        continue;
+      }
+      i = count < numberOfSegments ? count++ : count - 1;
+      while (i > 0 && (distances[i - 1] > d || (distances[i - 1] == d &&
+                                                segmentIDs[i - 1] > segmentID))) {
+        distances[i] = distances[i - 1];
+        segmentIDs[i] = segmentIDs[i - 1];
+        i--;
+      }
+      distances[i] = d;
+      segmentIDs[i] = segmentID;
+    } else {
+      for (k = 0; k < 2; k++) {
+        child = k == 0 ? _left[node] : _right[node];
+        d = distanceFromBox(p, child);
+        if (count < numberOfSegments || d <= distances[count - 1] + tolerance) {
+          push(size, child, d);
+        }
+      }
+    }
+  }
+
+  return count;
+}
+
+int BoundingVolumeHierarchy::overlap(Point pointA, Point pointB,
+                                     double distance, int *segmentIDs) {
+  int k, node, size = 0, count = 0;
+  double a[3], b[3], lower[3], upper[3];
+  bool isOverlapping;
+
+  if (_root == _NULLNODE) {
+    return 0;
+  }
+
+  coordinates(pointA, a);
+  coordinates(pointB, b);
+  for (k = 0; k < 3; k++) {
+    lower[k] = fmin(a[k], b[k]) - distance;
+    upper[k] = fmax(a[k], b[k]) + distance;
+  }
+
+  /* Depth-first traversal using the queue as a stack. */
+  _queue[size++] = _root;
+  while (size > 0) {
+    node = _queue[--size];
+
+    isOverlapping = true;
+    for (k = 0; k < 3; k++) {
+      isOverlapping = isOverlapping && _lower[3 * node + k] <= upper[k] &&
+                      lower[k] <= _upper[3 * node + k];
+    }
+    if (!isOverlapping) {
+      continue;
+    }
+
+    if (_left[node] == _NULLNODE) {
+      segmentIDs[count++] = _segment[node];
+    } else {
+      _queue[size++] = _left[node];
+      _queue[size++] = _right[node];
+    }
+  }
+
+  return count;
+}
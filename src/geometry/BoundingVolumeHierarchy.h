@@ -0,0 +1,358 @@
+/**
+ * @file BoundingVolumeHierarchy.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "Geometry.h"
+#include "Point.h"
+
+#ifndef _CCOLAB_GEOMETRY_BOUNDINGVOLUMEHIERARCHY_H
+#define _CCOLAB_GEOMETRY_BOUNDINGVOLUMEHIERARCHY_H
+/**
+ * @brief Dynamic bounding volume hierarchy of segments.
+ *
+ * Each segment is a leaf with an axis-aligned bounding box enlarged by a
+ * margin proportional to its length, so small moves of its endpoints do not
+ * change the hierarchy. The internal nodes are kept balanced by rotations as
+ * the leaves are inserted and removed.
+ *
+ * The segments are identified by integer indexes in [0, capacity).
+ */
+class BoundingVolumeHierarchy {
+ private:
+  /**
+   * @brief The null node index.
+   *
+   */
+  const int _NULLNODE = -1;
+
+  /**
+   * @brief The margin of the leaves boxes relative to the segment length.
+   *
+   */
+  const double _MARGIN = 0.1;
+
+  /**
+   * @brief The maximum number of segments.
+   *
+   */
+  int _capacity;
+
+  /**
+   * @brief The dimension of the points.
+   *
+   */
+  int _dimension;
+
+  /**
+   * @brief The root node.
+   *
+   */
+  int _root;
+
+  /**
+   * @brief The first node of the list of free nodes.
+   *
+   */
+  int _freeNode;
+
+  /**
+   * @brief The number of segments on the hierarchy.
+   *
+   */
+  int _numberOfSegments;
+
+  /**
+   * @brief The lower corner of the box of each node (three coordinates per
+   * node).
+   *
+   */
+  double *_lower;
+
+  /**
+   * @brief The upper corner of the box of each node (three coordinates per
+   * node).
+   *
+   */
+  double *_upper;
+
+  /**
+   * @brief The parent of each node. For free nodes it is the next free node.
+   *
+   */
+  int *_parent;
+
+  /**
+   * @brief The left child of each node.
+   *
+   */
+  int *_left;
+
+  /**
+   * @brief The right child of each node.
+   *
+   */
+  int *_right;
+
+  /**
+   * @brief The height of each node (leaves have height 0).
+   *
+   */
+  int *_height;
+
+  /**
+   * @brief The segment stored on each leaf node.
+   *
+   */
+  int *_segment;
+
+  /**
+   * @brief The leaf node of each segment (or _NULLNODE).
+   *
+   */
+  int *_leaf;
+
+  /**
+   * @brief The proximal point of each segment.
+   *
+   */
+  Point *_proximalPoint;
+
+  /**
+   * @brief The distal point of each segment.
+   *
+   */
+  Point *_distalPoint;
+
+  /**
+   * @brief The nodes waiting to be visited by the queries.
+   *
+   */
+  int *_queue;
+
+  /**
+   * @brief The distance from the query to the nodes waiting to be visited.
+   *
+   */
+  double *_queueDistance;
+
+  /**
+   * @brief Geometry object to do some geometric calculations.
+   *
+   */
+  Geometry *_geometry;
+
+  /**
+   * @brief Get a node from the list of free nodes.
+   *
+   * @return The node index.
+   */
+  int allocateNode();
+
+  /**
+   * @brief Give back the node to the list of free nodes.
+   *
+   * @param node The node index.
+   */
+  void freeNode(int node);
+
+  /**
+   * @brief Insert the leaf on the hierarchy.
+   *
+   * @param leaf The leaf node.
+   */
+  void insertLeaf(int leaf);
+
+  /**
+   * @brief Remove the leaf from the hierarchy.
+   *
+   * @param leaf The leaf node.
+   */
+  void removeLeaf(int leaf);
+
+  /**
+   * @brief Rotate the subtree rooted at the node if it is unbalanced.
+   *
+   * @param node The node index.
+   * @return The root of the balanced subtree.
+   */
+  int balance(int node);
+
+  /**
+   * @brief Recompute the box and the height of the node from its children.
+   *
+   * @param node The node index.
+   */
+  void fit(int node);
+
+  /**
+   * @brief Get the three coordinates of the point (the z-coordinate is zero
+   * for two dimensional points).
+   *
+   * @param point The point.
+   * @param value The coordinates (three positions).
+   */
+  void coordinates(Point point, double *value);
+
+  /**
+   * @brief Set the box of the leaf from the segment endpoints.
+   *
+   * @param leaf The leaf node.
+   * @param segmentID The segment index.
+   */
+  void fitLeaf(int leaf, int segmentID);
+
+  /**
+   * @brief Evaluate half of the surface area of the box that encloses the
+   * boxes of nodes A and B.
+   *
+   * @param nodeA The node A.
+   * @param nodeB The node B.
+   * @return Half of the surface area of the enclosing box.
+   */
+  double mergedArea(int nodeA, int nodeB);
+
+  /**
+   * @brief Evaluate half of the surface area of the node box.
+   *
+   * @param node The node index.
+   * @return Half of the surface area of the node box.
+   */
+  double area(int node);
+
+  /**
+   * @brief Evaluate the distance between the point and the node box.
+   *
+   * @param point The point coordinates.
+   * @param node The node index.
+   * @return The distance between the point and the node box.
+   */
+  double distanceFromBox(double *point, int node);
+
+  /**
+   * @brief Push the node to the queue ordered by distance.
+   *
+   * @param size The current size of the queue.
+   * @param node The node index.
+   * @param distance The distance from the query to the node.
+   */
+  void push(int &size, int node, double distance);
+
+  /**
+   * @brief Pop the closest node from the queue ordered by distance.
+   *
+   * @param size The current size of the queue.
+   * @return The node index.
+   */
+  int pop(int &size);
+
+ public:
+  /**
+   * @brief Construct a new Bounding Volume Hierarchy object.
+   *
+   * @param capacity The maximum number of segments.
+   * @param dimension The dimension of the points.
+   */
+  BoundingVolumeHierarchy(int capacity, int dimension);
+
+  /**
+   * @brief Destroy the Bounding Volume Hierarchy object.
+   *
+   */
+  ~BoundingVolumeHierarchy();
+
+  /**
+   * @brief Get the number of segments on the hierarchy.
+   *
+   * @return The number of segments on the hierarchy.
+   */
+  int numberOfSegments() { return _numberOfSegments; }
+
+  /**
+   * @brief Check if the segment is on the hierarchy.
+   *
+   * @param segmentID The segment index.
+   * @return Returns true if the segment is on the hierarchy. Returns false
+   * otherwise.
+   */
+  bool contains(int segmentID);
+
+  /**
+   * @brief Insert the segment on the hierarchy or update its endpoints if it
+   * is already there.
+   *
+   * The leaf is only moved when the segment leaves its enlarged box or the
+   * box became too large for it.
+   *
+   * @param segmentID The segment index.
+   * @param proximalPoint The proximal point of the segment.
+   * @param distalPoint The distal point of the segment.
+   */
+  void update(int segmentID, Point proximalPoint, Point distalPoint);
+
+  /**
+   * @brief Remove the segment from the hierarchy (nothing happens if it is
+   * not there).
+   *
+   * @param segmentID The segment index.
+   */
+  void remove(int segmentID);
+
+  /**
+   * @brief Find the segments closest to the point.
+   *
+   * The distance is the same critic distance of
+   * Geometry::distanceFromSegment. The segments are sorted by distance and
+   * the ties are sorted by the segment index, so the result is the same of
+   * sorting all the segments with a stable sort.
+   *
+   * @param point The point.
+   * @param numberOfSegments The maximum number of segments to find.
+   * @param segmentIDs The closest segments (at least numberOfSegments
+   * positions).
+   * @param distances The distance of the closest segments (at least
+   * numberOfSegments positions).
+   * @return The number of segments found.
+   */
+  int nearest(Point point, int numberOfSegments, int *segmentIDs,
+              double *distances);
+
+  /**
+   * @brief Find the segments whose boxes overlap the box of the segment AB
+   * enlarged by the given distance.
+   *
+   * Every segment closer than the distance from the segment AB is found
+   * (some farther segments may be found too).
+   *
+   * @param pointA The proximal point of the segment AB.
+   * @param pointB The distal point of the segment AB.
+   * @param distance The distance.
+   * @param segmentIDs The segments found (at least capacity positions).
+   * @return The number of segments found.
+   */
+  int overlap(Point pointA, Point pointB, double distance, int *segmentIDs);
+};
+#endif //_CCOLAB_GEOMETRY_BOUNDINGVOLUMEHIERARCHY_H
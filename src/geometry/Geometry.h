@@ -26,10 +26,18 @@
  * @version 1.0
  * @date 2022-05-18
  */
+#include "GeometryKernel.h"
 #include "Point.h"
 
 #ifndef _CCOLAB_GEOMETRY_GEOMETRY_H
 #define _CCOLAB_GEOMETRY_GEOMETRY_H
+/**
+ * @brief Geometric calculations on points of a given dimension.
+ *
+ * The calculations on the inner loops (distances, dot product and
+ * intersection) are defined here, so they are inlined, and they call the
+ * kernel of the dimension (GeometryKernel<2> or GeometryKernel<3>).
+ */
 class Geometry {
  private:
   /**
@@ -56,7 +64,7 @@ class Geometry {
    * @brief The tolerance constant.
    * 
    */
-  const double _TOLERANCE = 1e-6;
+  const double _TOLERANCE = GeometryKernel<3>::_TOLERANCE;
 
   /**
    * @brief Evaluate the Euclidian distance between points A and B.
@@ -65,7 +73,12 @@ class Geometry {
    * @param pointB The point B.
    * @return The Euclidian distance between points A and B. 
    */
-  double distance(Point pointA, Point pointB);
+  double distance(Point pointA, Point pointB) {
+    return _dimension == 2 ? GeometryKernel<2>::distance(pointA.coordinates(),
+                                                         pointB.coordinates())
+                           : GeometryKernel<3>::distance(pointA.coordinates(),
+                                                         pointB.coordinates());
+  }
 
   /**
    * @brief Evaluate the critic distance between a point and a segment.
@@ -76,7 +89,11 @@ class Geometry {
    * @return The critic distance between a point and a segment.
    */
   double distanceFromSegment(Point point, Point proximalPoint,
-                             Point distalPoint);
+                             Point distalPoint) {
+    return _dimension == 2
+               ? distanceFromSegment2D(point, proximalPoint, distalPoint)
+               : distanceFromSegment3D(point, proximalPoint, distalPoint);
+  }
 
   /**
    * @brief Evaluate the critic distance between a point and a segment for
@@ -88,7 +105,11 @@ class Geometry {
    * @return The critic distance between a point and a segment.
    */
   double distanceFromSegment2D(Point point, Point proximalPoint,
-                               Point distalPoint);
+                               Point distalPoint) {
+    return GeometryKernel<2>::distanceFromSegment(point.coordinates(),
+                                                  proximalPoint.coordinates(),
+                                                  distalPoint.coordinates());
+  }
 
   /**
    * @brief Evaluate the critic distance between a point and a segment for
@@ -100,7 +121,11 @@ class Geometry {
    * @return The critic distance between a point and a segment.
    */
   double distanceFromSegment3D(Point point, Point proximalPoint,
-                               Point distalPoint);
+                               Point distalPoint) {
+    return GeometryKernel<3>::distanceFromSegment(point.coordinates(),
+                                                  proximalPoint.coordinates(),
+                                                  distalPoint.coordinates());
+  }
 
   /**
    * @brief Add two points.
@@ -127,7 +152,11 @@ class Geometry {
    * @param v The vector v.
    * @return The dot product between two vectors.
    */
-  double dot(Point u, Point v);
+  double dot(Point u, Point v) {
+    return _dimension == 2
+               ? GeometryKernel<2>::dot(u.coordinates(), v.coordinates())
+               : GeometryKernel<3>::dot(u.coordinates(), v.coordinates());
+  }
 
   /**
    * @brief Evaluate the norm of the vector.
@@ -196,7 +225,11 @@ class Geometry {
    * false othewise.
    */
   bool hasIntersection(Point pointA, Point pointB, Point pointC, Point pointD,
-                       double tolerance);
+                       double tolerance) {
+    return _dimension == 2
+               ? hasIntersection2D(pointA, pointB, pointC, pointD, tolerance)
+               : hasIntersection3D(pointA, pointB, pointC, pointD, tolerance);
+  }
 
   /**
    * @brief Check if the segment AB intersects the segment CD for two
@@ -211,7 +244,11 @@ class Geometry {
    * false othewise.
    */
   bool hasIntersection2D(Point pointA, Point pointB, Point pointC, Point pointD,
-                         double tolerance);
+                         double tolerance) {
+    return GeometryKernel<2>::hasIntersection(
+        pointA.coordinates(), pointB.coordinates(), pointC.coordinates(),
+        pointD.coordinates(), tolerance);
+  }
 
   /**
    * @brief Check if the segment AB intersects the segment CD for three
@@ -226,6 +263,10 @@ class Geometry {
    * false othewise.
    */
   bool hasIntersection3D(Point pointA, Point pointB, Point pointC, Point pointD,
-                         double tolerance);
+                         double tolerance) {
+    return GeometryKernel<3>::hasIntersection(
+        pointA.coordinates(), pointB.coordinates(), pointC.coordinates(),
+        pointD.coordinates(), tolerance);
+  }
 };
 #endif //_CCOLAB_GEOMETRY_GEOMETRY_H
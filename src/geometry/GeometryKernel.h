@@ -0,0 +1,187 @@
+/**
+ * @file GeometryKernel.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ * 
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <cmath>
+
+#ifndef _CCOLAB_GEOMETRY_GEOMETRYKERNEL_H
+#define _CCOLAB_GEOMETRY_GEOMETRYKERNEL_H
+/**
+ * @brief The geometric kernels for the dimension D (2 or 3), on vectors of
+ * coordinates (see Point::coordinates()).
+ *
+ * The dimension is a template parameter, so the loops over the coordinates
+ * are fully unrolled and there is no branch on the dimension. Geometry picks
+ * the kernel once per call. The operations are done in the same order as
+ * in Geometry, so the results are the same.
+ *
+ * @tparam D The dimension.
+ */
+template <int D>
+class GeometryKernel {
+ public:
+  /**
+   * @brief The tolerance of the intersection tests.
+   *
+   */
+  static constexpr double _TOLERANCE = 1e-6;
+
+  /**
+   * @brief Get the dot product of the vectors.
+   *
+   * @param u The first vector.
+   * @param v The second vector.
+   * @return The dot product.
+   */
+  static inline double dot(const double *u, const double *v) {
+    int d;
+    double value = u[0] * v[0];
+    for (d = 1; d < D; d++) {
+      value += u[d] * v[d];
+    }
+    return value;
+  }
+
+  /**
+   * @brief Get the distance between the points.
+   *
+   * @param pointA The point A.
+   * @param pointB The point B.
+   * @return The distance.
+   */
+  static inline double distance(const double *pointA, const double *pointB) {
+    int d;
+    double AB[3];
+    for (d = 0; d < D; d++) {
+      AB[d] = pointA[d] - pointB[d];
+    }
+    return sqrt(dot(AB, AB));
+  }
+
+  /**
+   * @brief Get the distance from the point to the segment AB.
+   *
+   * @param point The point.
+   * @param proximalPoint The point A.
+   * @param distalPoint The point B.
+   * @return The distance.
+   */
+  static inline double distanceFromSegment(const double *point,
+                                           const double *proximalPoint,
+                                           const double *distalPoint) {
+    int d;
+    double AB[3], AP[3], w[3], innerProduct;
+
+    for (d = 0; d < D; d++) {
+      AB[d] = distalPoint[d] - proximalPoint[d];
+      AP[d] = point[d] - proximalPoint[d];
+    }
+
+    /* Inner product: (AP·AB)/(AB·AB) */
+    innerProduct = dot(AP, AB) / dot(AB, AB);
+    if (!(0.0 <= innerProduct && innerProduct <= 1.0)) {
+      return fmin(distance(point, proximalPoint),
+                  distance(point, distalPoint));
+    }
+
+    /* The projection is on the segment: |AP x AB|/|AB|. */
+    if constexpr (D == 2) {
+      return fabs(AB[1] * AP[0] - AB[0] * AP[1]) / sqrt(dot(AB, AB));
+    }
+    w[0] = AP[2] * AB[1] - AP[1] * AB[2];
+    w[1] = AP[0] * AB[2] - AP[2] * AB[0];
+    w[2] = AP[1] * AB[0] - AP[0] * AB[1];
+    return sqrt(GeometryKernel<3>::dot(w, w)) / sqrt(dot(AB, AB));
+  }
+
+  /**
+   * @brief Check if the segments AB and CD intersect (see
+   * Geometry::hasIntersection2D and Geometry::hasIntersection3D).
+   *
+   * @param pointA The point A.
+   * @param pointB The point B.
+   * @param pointC The point C.
+   * @param pointD The point D.
+   * @param tolerance The tolerance.
+   * @return Returns true if the segments intersect. Returns false otherwise.
+   */
+  static inline bool hasIntersection(const double *pointA,
+                                     const double *pointB,
+                                     const double *pointC,
+                                     const double *pointD,
+                                     double tolerance) {
+    int k;
+    double AB[3], CD[3], AC[3], PQ[3], squaredNormAB, squaredNormCD, dotABCD,
+        dotACAB, dotACCD, det, r, s;
+
+    for (k = 0; k < D; k++) {
+      AB[k] = pointB[k] - pointA[k];
+      CD[k] = pointD[k] - pointC[k];
+      AC[k] = pointC[k] - pointA[k];
+    }
+
+    if constexpr (D == 2) {
+      /* Cramer's rule for A + r(B - A) = C + s(D - C). */
+      det = AB[0] * (-CD[1]) - (-CD[0]) * (AB[1]);
+      if (fabs(det) < _TOLERANCE * _TOLERANCE) {
+        return false;
+      }
+      r = (AC[0] * (-CD[1]) - (-CD[0]) * (AC[1])) / det;
+      s = (AB[0] * (AC[1]) - (AC[0]) * (AB[1])) / det;
+
+      return ((0.0 < r && r < 1.0 + tolerance / sqrt(dot(AB, AB))) &&
+              (0.0 < s && s < 1.0 + tolerance / sqrt(dot(CD, CD))));
+    }
+
+    /**
+     *  The shortest segment PQ between AB and CD, with P = A + r(B - A) and
+     *  Q = C + s(D - C), is perpendicular to both:
+     *
+     *  [ <AB, AB>  - <CD, AB> ][ r ]  =  [<AC, AB>]
+     *  [ <AB, CD>  - <CD, CD> ][ s ]  =  [<AC, CD>]
+     **/
+    squaredNormAB = dot(AB, AB);
+    squaredNormCD = dot(CD, CD);
+    dotABCD = dot(AB, CD);
+    det = dotABCD * dotABCD - squaredNormAB * squaredNormCD;
+    if (fabs(det) < _TOLERANCE) {
+      return false;
+    }
+
+    dotACAB = dot(AC, AB);
+    dotACCD = dot(AC, CD);
+    r = (dotABCD * dotACCD - dotACAB * squaredNormCD) / det;
+    s = (dotACCD * squaredNormAB - dotACAB * dotABCD) / det;
+    for (k = 0; k < D; k++) {
+      PQ[k] = (pointC[k] + s * CD[k]) - (pointA[k] + r * AB[k]);
+    }
+
+    return (0.0 < r && r < 1.0 && 0.0 < s && s < 1.0 &&
+            dot(PQ, PQ) < tolerance * tolerance);
+  }
+};
+#endif  //_CCOLAB_GEOMETRY_GEOMETRYKERNEL_H
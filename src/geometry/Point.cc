@@ -35,43 +35,10 @@
 using std::cout;
 using std::endl;
 
-Point::Point() { _dimension = 2; }
-
-Point::Point(int dimension) { _dimension = dimension; }
-
-Point::Point(double *point, int dimension) {
-  _dimension = dimension;
-  _x = point[0];
-  _y = point[1];
-  _z = _dimension == 3 ? point[2] : 0.0;
-}
-
-double Point::x() { return _x; }
-
-double Point::y() { return _y; }
-
-double Point::z() { return _z; }
-
-int Point::dimension() { return _dimension; }
-
-void Point::setX(double value) { _x = value; }
-
-void Point::setY(double value) { _y = value; }
-
-void Point::setZ(double value) { _z = value; }
-
-void Point::set(double *point) {
-  _x = point[0];
-  _y = point[1];
-  _z = _dimension == 3 ? point[2] : 0.0;
-}
-
-void Point::setDimension(int value) { _dimension = value; }
-
 void Point::print() {
-  cout << "(" << _x << ", " << _y;
+  cout << "(" << _coordinates[0] << ", " << _coordinates[1];
   if (_dimension == 3) {
-    cout << ", " << _z;
+    cout << ", " << _coordinates[2];
   }
   cout << ")" << endl;
 }
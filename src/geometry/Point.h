@@ -28,6 +28,13 @@
  */
 #ifndef _CCOLAB_GEOMETRY_POINT_H
 #define _CCOLAB_GEOMETRY_POINT_H
+/**
+ * @brief Point with 2 or 3 coordinates.
+ *
+ * The coordinates are stored contiguously, so the geometric kernels (see
+ * GeometryKernel) read them as a vector. The accessors are defined here to
+ * be inlined on the inner loops.
+ */
 class Point {
  private:
   /**
@@ -37,36 +44,24 @@ class Point {
   int _dimension;
 
   /**
-   * @brief The x coordinate.
-   * 
-   */
-  double _x = 0.0;
-
-  /**
-   * @brief The y coordinate.
+   * @brief The x, y and z coordinates (z is zero in 2D).
    * 
    */
-  double _y = 0.0;
-
-  /**
-   * @brief The z coordinate.
-   * 
-   */
-  double _z = 0.0;
+  double _coordinates[3] = {0.0, 0.0, 0.0};
 
  public:
   /**
    * @brief Construct a new Point object.
    * 
    */
-  Point();
+  Point() { _dimension = 2; }
 
   /**
    * @brief Construct a new Point object.
    * 
    * @param dimension The point dimension.
    */
-  explicit Point(int dimension);
+  explicit Point(int dimension) { _dimension = dimension; }
 
   /**
    * @brief Construct a new Point object.
@@ -74,7 +69,10 @@ class Point {
    * @param point Vector of the point coordinates.
    * @param dimension The point dimension.
    */
-  Point(double *point, int dimension);
+  Point(const double *point, int dimension) {
+    _dimension = dimension;
+    set(point);
+  }
 
   /**
    * @brief Destroy the Point object.
@@ -87,63 +85,74 @@ class Point {
    * 
    * @return The x coordinate. 
    */
-  double x();
+  double x() { return _coordinates[0]; }
 
   /**
    * @brief Get the y coordinate.
    * 
    * @return The y coordinate. 
    */
-  double y();
+  double y() { return _coordinates[1]; }
 
   /**
    * @brief Get the z coordinate.
    * 
    * @return The z coordinate. 
    */
-  double z();
+  double z() { return _coordinates[2]; }
+
+  /**
+   * @brief Get the vector of point coordinates (x, y and z).
+   * 
+   * @return The vector of point coordinates.
+   */
+  const double *coordinates() const { return _coordinates; }
 
   /**
    * @brief Get the point dimension.
    * 
    * @return The point dimension.
    */
-  int dimension();
+  int dimension() { return _dimension; }
 
   /**
    * @brief Set the x coordinate.
    * 
    * @param value The x coordinate.
    */
-  void setX(double value);
+  void setX(double value) { _coordinates[0] = value; }
 
   /**
    * @brief Set the y coordinate.
    * 
    * @param value The y coordinate.
    */
-  void setY(double value);
+  void setY(double value) { _coordinates[1] = value; }
 
   /**
    * @brief Set the z coordinate.
    * 
    * @param value The z coordinate.
    */
-  void setZ(double value);
+  void setZ(double value) { _coordinates[2] = value; }
 
   /**
    * @brief Set the point coordinates.
    * 
    * @param The vector of point coordinates.
    */
-  void set(double *point);
+  void set(const double *point) {
+    _coordinates[0] = point[0];
+    _coordinates[1] = point[1];
+    _coordinates[2] = _dimension == 3 ? point[2] : 0.0;
+  }
 
   /**
    * @brief Set the point dimension.
    * 
    * @param value The point dimension.
    */
-  void setDimension(int value);
+  void setDimension(int value) { _dimension = value; }
   
   /**
    * @brief Print the point coordinates for debugging.
@@ -0,0 +1,286 @@
+/**
+ * @file SegmentDistanceKernel.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "SegmentDistanceKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define _CCOLAB_SEGMENTDISTANCEKERNEL_X86
+#endif
+
+int SegmentDistanceKernel::_instructionSet = -1;
+
+/**
+ *  The compiler must not fuse the multiplications and additions (the
+ *  AVX-512 code could use FMA), so the distances are rounded as the scalar
+ *  ones.
+ **/
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+template <int D>
+static void distancesScalar(const double *point, const double *proximalPoints,
+                            const double *distalPoints, const int *segmentIDs,
+                            int begin, int end, double *distances) {
+  int i, s;
+  for (i = begin; i < end; i++) {
+    s = segmentIDs == nullptr ? i : segmentIDs[i];
+    distances[i] = GeometryKernel<D>::distanceFromSegment(
+        point, &proximalPoints[3 * s], &distalPoints[3 * s]);
+  }
+}
+
+#ifdef _CCOLAB_SEGMENTDISTANCEKERNEL_X86
+template <int D>
+__attribute__((target("avx2"))) static void distancesAVX2(
+    const double *point, const double *proximalPoints,
+    const double *distalPoints, const int *segmentIDs, int numberOfSegments,
+    double *distances) {
+  int i, d;
+  __m128i index;
+  __m256d P[3], AB[3], AP[3], BP[3], squaredNormAB, t, inside, w[3],
+      insideDistance, outsideDistance, zero = _mm256_setzero_pd(),
+                                       one = _mm256_set1_pd(1.0),
+                                       signBit = _mm256_set1_pd(-0.0);
+
+  for (d = 0; d < D; d++) {
+    P[d] = _mm256_set1_pd(point[d]);
+  }
+
+  for (i = 0; i + 4 <= numberOfSegments; i += 4) {
+    index = segmentIDs == nullptr
+                ? _mm_add_epi32(_mm_set1_epi32(i), _mm_setr_epi32(0, 1, 2, 3))
+                : _mm_loadu_si128(
+                      reinterpret_cast<const __m128i *>(&segmentIDs[i]));
+    index = _mm_mullo_epi32(index, _mm_set1_epi32(3));
+    for (d = 0; d < D; d++) {
+      AP[d] = _mm256_i32gather_pd(&proximalPoints[d], index, 8);
+      BP[d] = _mm256_i32gather_pd(&distalPoints[d], index, 8);
+      AB[d] = _mm256_sub_pd(BP[d], AP[d]);
+      AP[d] = _mm256_sub_pd(P[d], AP[d]);
+      BP[d] = _mm256_sub_pd(P[d], BP[d]);
+    }
+
+    /* Inner product: (AP·AB)/(AB·AB) */
+    squaredNormAB = _mm256_mul_pd(AB[0], AB[0]);
+    t = _mm256_mul_pd(AP[0], AB[0]);
+    for (d = 1; d < D; d++) {
+      squaredNormAB =
+          _mm256_add_pd(squaredNormAB, _mm256_mul_pd(AB[d], AB[d]));
+      t = _mm256_add_pd(t, _mm256_mul_pd(AP[d], AB[d]));
+    }
+    t = _mm256_div_pd(t, squaredNormAB);
+    inside = _mm256_and_pd(_mm256_cmp_pd(zero, t, _CMP_LE_OQ),
+                           _mm256_cmp_pd(t, one, _CMP_LE_OQ));
+
+    /* The projection is on the segment: |AP x AB|/|AB|. */
+    if constexpr (D == 2) {
+      insideDistance = _mm256_andnot_pd(
+          signBit, _mm256_sub_pd(_mm256_mul_pd(AB[1], AP[0]),
+                                 _mm256_mul_pd(AB[0], AP[1])));
+    } else {
+      w[0] = _mm256_sub_pd(_mm256_mul_pd(AP[2], AB[1]),
+                           _mm256_mul_pd(AP[1], AB[2]));
+      w[1] = _mm256_sub_pd(_mm256_mul_pd(AP[0], AB[2]),
+                           _mm256_mul_pd(AP[2], AB[0]));
+      w[2] = _mm256_sub_pd(_mm256_mul_pd(AP[1], AB[0]),
+                           _mm256_mul_pd(AP[0], AB[1]));
+      insideDistance = _mm256_sqrt_pd(_mm256_add_pd(
+          _mm256_add_pd(_mm256_mul_pd(w[0], w[0]), _mm256_mul_pd(w[1], w[1])),
+          _mm256_mul_pd(w[2], w[2])));
+    }
+    insideDistance =
+        _mm256_div_pd(insideDistance, _mm256_sqrt_pd(squaredNormAB));
+
+    /* Otherwise, the distance to the closest endpoint. */
+    t = _mm256_mul_pd(AP[0], AP[0]);
+    squaredNormAB = _mm256_mul_pd(BP[0], BP[0]);
+    for (d = 1; d < D; d++) {
+      t = _mm256_add_pd(t, _mm256_mul_pd(AP[d], AP[d]));
+      squaredNormAB =
+          _mm256_add_pd(squaredNormAB, _mm256_mul_pd(BP[d], BP[d]));
+    }
+    outsideDistance =
+        _mm256_min_pd(_mm256_sqrt_pd(t), _mm256_sqrt_pd(squaredNormAB));
+
+    _mm256_storeu_pd(&distances[i], _mm256_blendv_pd(outsideDistance,
+                                                     insideDistance, inside));
+  }
+
+  distancesScalar<D>(point, proximalPoints, distalPoints, segmentIDs, i,
+                     numberOfSegments, distances);
+}
+
+template <int D>
+__attribute__((target("avx512f"))) static void distancesAVX512(
+    const double *point, const double *proximalPoints,
+    const double *distalPoints, const int *segmentIDs, int numberOfSegments,
+    double *distances) {
+  int i, d;
+  __m256i index;
+  __mmask8 inside;
+  __m512d P[3], AB[3], AP[3], BP[3], squaredNormAB, t, w[3], insideDistance,
+      outsideDistance, zero = _mm512_setzero_pd(), one = _mm512_set1_pd(1.0);
+
+  for (d = 0; d < D; d++) {
+    P[d] = _mm512_set1_pd(point[d]);
+  }
+
+  for (i = 0; i + 8 <= numberOfSegments; i += 8) {
+    index = segmentIDs == nullptr
+                ? _mm256_add_epi32(_mm256_set1_epi32(i),
+                                   _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))
+                : _mm256_loadu_si256(
+                      reinterpret_cast<const __m256i *>(&segmentIDs[i]));
+    index = _mm256_mullo_epi32(index, _mm256_set1_epi32(3));
+    for (d = 0; d < D; d++) {
+      AP[d] = _mm512_i32gather_pd(index, &proximalPoints[d], 8);
+      BP[d] = _mm512_i32gather_pd(index, &distalPoints[d], 8);
+      AB[d] = _mm512_sub_pd(BP[d], AP[d]);
+      AP[d] = _mm512_sub_pd(P[d], AP[d]);
+      BP[d] = _mm512_sub_pd(P[d], BP[d]);
+    }
+
+    /* Inner product: (AP·AB)/(AB·AB) */
+    squaredNormAB = _mm512_mul_pd(AB[0], AB[0]);
+    t = _mm512_mul_pd(AP[0], AB[0]);
+    for (d = 1; d < D; d++) {
+      squaredNormAB =
+          _mm512_add_pd(squaredNormAB, _mm512_mul_pd(AB[d], AB[d]));
+      t = _mm512_add_pd(t, _mm512_mul_pd(AP[d], AB[d]));
+    }
+    t = _mm512_div_pd(t, squaredNormAB);
+    inside = _mm512_cmp_pd_mask(zero, t, _CMP_LE_OQ) &
+             _mm512_cmp_pd_mask(t, one, _CMP_LE_OQ);
+
+    /* The projection is on the segment: |AP x AB|/|AB|. */
+    if constexpr (D == 2) {
+      insideDistance = _mm512_abs_pd(_mm512_sub_pd(
+          _mm512_mul_pd(AB[1], AP[0]), _mm512_mul_pd(AB[0], AP[1])));
+    } else {
+      w[0] = _mm512_sub_pd(_mm512_mul_pd(AP[2], AB[1]),
+                           _mm512_mul_pd(AP[1], AB[2]));
+      w[1] = _mm512_sub_pd(_mm512_mul_pd(AP[0], AB[2]),
+                           _mm512_mul_pd(AP[2], AB[0]));
+      w[2] = _mm512_sub_pd(_mm512_mul_pd(AP[1], AB[0]),
+                           _mm512_mul_pd(AP[0], AB[1]));
+      insideDistance = _mm512_sqrt_pd(_mm512_add_pd(
+          _mm512_add_pd(_mm512_mul_pd(w[0], w[0]), _mm512_mul_pd(w[1], w[1])),
+          _mm512_mul_pd(w[2], w[2])));
+    }
+    insideDistance =
+        _mm512_div_pd(insideDistance, _mm512_sqrt_pd(squaredNormAB));
+
+    /* Otherwise, the distance to the closest endpoint. */
+    t = _mm512_mul_pd(AP[0], AP[0]);
+    squaredNormAB = _mm512_mul_pd(BP[0], BP[0]);
+    for (d = 1; d < D; d++) {
+      t = _mm512_add_pd(t, _mm512_mul_pd(AP[d], AP[d]));
+      squaredNormAB =
+          _mm512_add_pd(squaredNormAB, _mm512_mul_pd(BP[d], BP[d]));
+    }
+    outsideDistance =
+        _mm512_min_pd(_mm512_sqrt_pd(t), _mm512_sqrt_pd(squaredNormAB));
+
+    _mm512_storeu_pd(&distances[i], _mm512_mask_blend_pd(
+                                        inside, outsideDistance,
+                                        insideDistance));
+  }
+
+  distancesScalar<D>(point, proximalPoints, distalPoints, segmentIDs, i,
+                     numberOfSegments, distances);
+}
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+int SegmentDistanceKernel::supportedInstructionSet() {
+#ifdef _CCOLAB_SEGMENTDISTANCEKERNEL_X86
+  if (__builtin_cpu_supports("avx512f")) {
+    return AVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return AVX2;
+  }
+#endif
+  return SCALAR;
+}
+
+int SegmentDistanceKernel::instructionSet() {
+  if (_instructionSet < 0) {
+    _instructionSet = supportedInstructionSet();
+  }
+  return _instructionSet;
+}
+
+void SegmentDistanceKernel::setInstructionSet(int value) {
+  if (value < SCALAR || value > supportedInstructionSet()) {
+    throw invalid_argument("Oops! The instruction set is not supported.");
+  }
+  _instructionSet = value;
+}
+
+void SegmentDistanceKernel::distancesFromSegments(
+    int dimension, const double *point, const double *proximalPoints,
+    const double *distalPoints, const int *segmentIDs, int numberOfSegments,
+    double *distances) {
+  switch (instructionSet()) {
+#ifdef _CCOLAB_SEGMENTDISTANCEKERNEL_X86
+    case AVX512:
+      if (dimension == 2) {
+        distancesAVX512<2>(point, proximalPoints, distalPoints, segmentIDs,
+                           numberOfSegments, distances);
+      } else {
+        distancesAVX512<3>(point, proximalPoints, distalPoints, segmentIDs,
+                           numberOfSegments, distances);
+      }
+      break;
+    case AVX2:
+      if (dimension == 2) {
+        distancesAVX2<2>(point, proximalPoints, distalPoints, segmentIDs,
+                         numberOfSegments, distances);
+      } else {
+        distancesAVX2<3>(point, proximalPoints, distalPoints, segmentIDs,
+                         numberOfSegments, distances);
+      }
+      break;
+#endif
+    default:
+      if (dimension == 2) {
+        distancesScalar<2>(point, proximalPoints, distalPoints, segmentIDs, 0,
+                           numberOfSegments, distances);
+      } else {
+        distancesScalar<3>(point, proximalPoints, distalPoints, segmentIDs, 0,
+                           numberOfSegments, distances);
+      }
+  }
+}
@@ -0,0 +1,118 @@
+/**
+ * @file SegmentDistanceKernel.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ * 
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <stdexcept>
+
+#include "GeometryKernel.h"
+using std::invalid_argument;
+
+#ifndef _CCOLAB_GEOMETRY_SEGMENTDISTANCEKERNEL_H
+#define _CCOLAB_GEOMETRY_SEGMENTDISTANCEKERNEL_H
+/**
+ * @brief Distances from one point to many segments (the distance of
+ * Geometry::distanceFromSegment).
+ *
+ * The segments are processed 4 (AVX2) or 8 (AVX-512) at a time, with the
+ * instruction set picked at run time from the processor, and one at a time
+ * on other processors. Every instruction set does the operations of
+ * GeometryKernel in the same order, without fused multiply-add, so the
+ * distances are the same on all of them.
+ */
+class SegmentDistanceKernel {
+ public:
+  /**
+   * @brief One segment at a time.
+   *
+   */
+  static const int SCALAR = 0;
+
+  /**
+   * @brief Four segments at a time with AVX2.
+   *
+   */
+  static const int AVX2 = 1;
+
+  /**
+   * @brief Eight segments at a time with AVX-512.
+   *
+   */
+  static const int AVX512 = 2;
+
+ private:
+  /**
+   * @brief The instruction set in use (negative until the first use).
+   *
+   */
+  static int _instructionSet;
+
+ public:
+  /**
+   * @brief Get the best instruction set of the processor.
+   *
+   * @return The instruction set (SCALAR, AVX2 or AVX512).
+   */
+  static int supportedInstructionSet();
+
+  /**
+   * @brief Get the instruction set in use (the best one of the processor,
+   * unless it was set).
+   *
+   * @return The instruction set (SCALAR, AVX2 or AVX512).
+   */
+  static int instructionSet();
+
+  /**
+   * @brief Set the instruction set in use.
+   *
+   * @param value The instruction set (SCALAR, AVX2 or AVX512). It must be
+   * supported by the processor.
+   */
+  static void setInstructionSet(int value);
+
+  /**
+   * @brief Get the distances from the point to the segments.
+   *
+   * The points are stored with 3 coordinates each (z is zero in 2D), so the
+   * segment i has the proximal point proximalPoints[3 * i, ..., 3 * i + 2].
+   *
+   * @param dimension The dimension (2 or 3).
+   * @param point The point (3 coordinates).
+   * @param proximalPoints The proximal points of the segments.
+   * @param distalPoints The distal points of the segments.
+   * @param segmentIDs The indices of the segments (null for the first
+   * numberOfSegments segments).
+   * @param numberOfSegments The number of segments.
+   * @param distances The distance to each segment (output).
+   */
+  static void distancesFromSegments(int dimension, const double *point,
+                                    const double *proximalPoints,
+                                    const double *distalPoints,
+                                    const int *segmentIDs,
+                                    int numberOfSegments, double *distances);
+};
+#endif  //_CCOLAB_GEOMETRY_SEGMENTDISTANCEKERNEL_H
@@ -0,0 +1,370 @@
+/**
+ * @file SegmentIntersectionKernel.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "SegmentIntersectionKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define _CCOLAB_SEGMENTINTERSECTIONKERNEL_X86
+#endif
+
+int SegmentIntersectionKernel::_instructionSet = -1;
+
+/**
+ *  The compiler must not fuse the multiplications and additions, so the
+ *  tests are rounded as the scalar ones.
+ **/
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+template <int D>
+static unsigned long intersectionMaskScalar(
+    const double *pointC, const double *pointD, const double *proximalPoints,
+    const double *distalPoints, const double *tolerances, int begin,
+    int numberOfSegments, bool stopOnHit, unsigned long mask) {
+  int i;
+  for (i = begin; i < numberOfSegments && !(stopOnHit && mask != 0); i++) {
+    if (GeometryKernel<D>::hasIntersection(&proximalPoints[3 * i],
+                                           &distalPoints[3 * i], pointC,
+                                           pointD, tolerances[i])) {
+      mask |= 1UL << i;
+    }
+  }
+  return mask;
+}
+
+#ifdef _CCOLAB_SEGMENTINTERSECTIONKERNEL_X86
+template <int D>
+__attribute__((target("avx2"))) static unsigned long intersectionMaskAVX2(
+    const double *pointC, const double *pointD, const double *proximalPoints,
+    const double *distalPoints, const double *tolerances,
+    int numberOfSegments, bool stopOnHit) {
+  int i, k;
+  unsigned long mask = 0;
+  __m128i index;
+  __m256d A[3], AB[3], AC[3], C[3], CD[3], squaredNormAB, squaredNormCD,
+      dotABCD, dotACAB, dotACCD, det, r, s, PQ, squaredNormPQ, tolerance, hit,
+      zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0),
+      signBit = _mm256_set1_pd(-0.0);
+
+  for (k = 0; k < D; k++) {
+    C[k] = _mm256_set1_pd(pointC[k]);
+    CD[k] = _mm256_sub_pd(_mm256_set1_pd(pointD[k]), C[k]);
+  }
+
+  for (i = 0; i + 4 <= numberOfSegments; i += 4) {
+    index = _mm_mullo_epi32(
+        _mm_add_epi32(_mm_set1_epi32(i), _mm_setr_epi32(0, 1, 2, 3)),
+        _mm_set1_epi32(3));
+    for (k = 0; k < D; k++) {
+      A[k] = _mm256_i32gather_pd(&proximalPoints[k], index, 8);
+      AB[k] = _mm256_sub_pd(_mm256_i32gather_pd(&distalPoints[k], index, 8),
+                            A[k]);
+      AC[k] = _mm256_sub_pd(C[k], A[k]);
+    }
+    tolerance = _mm256_loadu_pd(&tolerances[i]);
+
+    if constexpr (D == 2) {
+      /* Cramer's rule for A + r(B - A) = C + s(D - C). */
+      det = _mm256_sub_pd(
+          _mm256_mul_pd(AB[0], _mm256_xor_pd(CD[1], signBit)),
+          _mm256_mul_pd(_mm256_xor_pd(CD[0], signBit), AB[1]));
+      r = _mm256_div_pd(
+          _mm256_sub_pd(_mm256_mul_pd(AC[0], _mm256_xor_pd(CD[1], signBit)),
+                        _mm256_mul_pd(_mm256_xor_pd(CD[0], signBit), AC[1])),
+          det);
+      s = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(AB[0], AC[1]),
+                                      _mm256_mul_pd(AC[0], AB[1])),
+                        det);
+      squaredNormAB = _mm256_add_pd(_mm256_mul_pd(AB[0], AB[0]),
+                                    _mm256_mul_pd(AB[1], AB[1]));
+      squaredNormCD = _mm256_add_pd(_mm256_mul_pd(CD[0], CD[0]),
+                                    _mm256_mul_pd(CD[1], CD[1]));
+      hit = _mm256_cmp_pd(
+          _mm256_andnot_pd(signBit, det),
+          _mm256_set1_pd(GeometryKernel<D>::_TOLERANCE *
+                         GeometryKernel<D>::_TOLERANCE),
+          _CMP_NLT_UQ);
+      hit = _mm256_and_pd(hit, _mm256_cmp_pd(zero, r, _CMP_LT_OQ));
+      hit = _mm256_and_pd(
+          hit, _mm256_cmp_pd(r,
+                             _mm256_add_pd(one, _mm256_div_pd(
+                                                    tolerance,
+                                                    _mm256_sqrt_pd(
+                                                        squaredNormAB))),
+                             _CMP_LT_OQ));
+      hit = _mm256_and_pd(hit, _mm256_cmp_pd(zero, s, _CMP_LT_OQ));
+      hit = _mm256_and_pd(
+          hit, _mm256_cmp_pd(s,
+                             _mm256_add_pd(one, _mm256_div_pd(
+                                                    tolerance,
+                                                    _mm256_sqrt_pd(
+                                                        squaredNormCD))),
+                             _CMP_LT_OQ));
+    } else {
+      /* The shortest segment PQ between AB and CD. */
+      squaredNormAB = _mm256_mul_pd(AB[0], AB[0]);
+      squaredNormCD = _mm256_mul_pd(CD[0], CD[0]);
+      dotABCD = _mm256_mul_pd(AB[0], CD[0]);
+      dotACAB = _mm256_mul_pd(AC[0], AB[0]);
+      dotACCD = _mm256_mul_pd(AC[0], CD[0]);
+      for (k = 1; k < 3; k++) {
+        squaredNormAB =
+            _mm256_add_pd(squaredNormAB, _mm256_mul_pd(AB[k], AB[k]));
+        squaredNormCD =
+            _mm256_add_pd(squaredNormCD, _mm256_mul_pd(CD[k], CD[k]));
+        dotABCD = _mm256_add_pd(dotABCD, _mm256_mul_pd(AB[k], CD[k]));
+        dotACAB = _mm256_add_pd(dotACAB, _mm256_mul_pd(AC[k], AB[k]));
+        dotACCD = _mm256_add_pd(dotACCD, _mm256_mul_pd(AC[k], CD[k]));
+      }
+      det = _mm256_sub_pd(_mm256_mul_pd(dotABCD, dotABCD),
+                          _mm256_mul_pd(squaredNormAB, squaredNormCD));
+      r = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(dotABCD, dotACCD),
+                                      _mm256_mul_pd(dotACAB, squaredNormCD)),
+                        det);
+      s = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(dotACCD, squaredNormAB),
+                                      _mm256_mul_pd(dotACAB, dotABCD)),
+                        det);
+      squaredNormPQ = zero;
+      for (k = 0; k < 3; k++) {
+        PQ = _mm256_sub_pd(
+            _mm256_add_pd(C[k], _mm256_mul_pd(s, CD[k])),
+            _mm256_add_pd(A[k], _mm256_mul_pd(r, AB[k])));
+        squaredNormPQ = k == 0 ? _mm256_mul_pd(PQ, PQ)
+                               : _mm256_add_pd(squaredNormPQ,
+                                               _mm256_mul_pd(PQ, PQ));
+      }
+      hit = _mm256_cmp_pd(_mm256_andnot_pd(signBit, det),
+                          _mm256_set1_pd(GeometryKernel<D>::_TOLERANCE),
+                          _CMP_NLT_UQ);
+      hit = _mm256_and_pd(hit, _mm256_cmp_pd(zero, r, _CMP_LT_OQ));
+      hit = _mm256_and_pd(hit, _mm256_cmp_pd(r, one, _CMP_LT_OQ));
+      hit = _mm256_and_pd(hit, _mm256_cmp_pd(zero, s, _CMP_LT_OQ));
+      hit = _mm256_and_pd(hit, _mm256_cmp_pd(s, one, _CMP_LT_OQ));
+      hit = _mm256_and_pd(
+          hit, _mm256_cmp_pd(squaredNormPQ,
+                             _mm256_mul_pd(tolerance, tolerance),
+                             _CMP_LT_OQ));
+    }
+
+    mask |= static_cast<unsigned long>(_mm256_movemask_pd(hit)) << i;
+    if (stopOnHit && mask != 0) {
+      return mask;
+    }
+  }
+
+  return intersectionMaskScalar<D>(pointC, pointD, proximalPoints,
+                                   distalPoints, tolerances, i,
+                                   numberOfSegments, stopOnHit, mask);
+}
+
+template <int D>
+__attribute__((target("avx512f"))) static unsigned long intersectionMaskAVX512(
+    const double *pointC, const double *pointD, const double *proximalPoints,
+    const double *distalPoints, const double *tolerances,
+    int numberOfSegments, bool stopOnHit) {
+  int i, k;
+  unsigned long mask = 0;
+  __m256i index;
+  __mmask8 hit;
+  __m512d A[3], AB[3], AC[3], C[3], CD[3], minusCD[2], squaredNormAB,
+      squaredNormCD, dotABCD, dotACAB, dotACCD, det, r, s, PQ, squaredNormPQ,
+      tolerance, zero = _mm512_setzero_pd(), one = _mm512_set1_pd(1.0);
+
+  for (k = 0; k < D; k++) {
+    C[k] = _mm512_set1_pd(pointC[k]);
+    CD[k] = _mm512_sub_pd(_mm512_set1_pd(pointD[k]), C[k]);
+  }
+  if constexpr (D == 2) {
+    minusCD[0] = _mm512_set1_pd(-(pointD[0] - pointC[0]));
+    minusCD[1] = _mm512_set1_pd(-(pointD[1] - pointC[1]));
+  }
+
+  for (i = 0; i + 8 <= numberOfSegments; i += 8) {
+    index = _mm256_mullo_epi32(
+        _mm256_add_epi32(_mm256_set1_epi32(i),
+                         _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)),
+        _mm256_set1_epi32(3));
+    for (k = 0; k < D; k++) {
+      A[k] = _mm512_i32gather_pd(index, &proximalPoints[k], 8);
+      AB[k] = _mm512_sub_pd(_mm512_i32gather_pd(index, &distalPoints[k], 8),
+                            A[k]);
+      AC[k] = _mm512_sub_pd(C[k], A[k]);
+    }
+    tolerance = _mm512_loadu_pd(&tolerances[i]);
+
+    if constexpr (D == 2) {
+      /* Cramer's rule for A + r(B - A) = C + s(D - C). */
+      det = _mm512_sub_pd(_mm512_mul_pd(AB[0], minusCD[1]),
+                          _mm512_mul_pd(minusCD[0], AB[1]));
+      r = _mm512_div_pd(_mm512_sub_pd(_mm512_mul_pd(AC[0], minusCD[1]),
+                                      _mm512_mul_pd(minusCD[0], AC[1])),
+                        det);
+      s = _mm512_div_pd(_mm512_sub_pd(_mm512_mul_pd(AB[0], AC[1]),
+                                      _mm512_mul_pd(AC[0], AB[1])),
+                        det);
+      squaredNormAB = _mm512_add_pd(_mm512_mul_pd(AB[0], AB[0]),
+                                    _mm512_mul_pd(AB[1], AB[1]));
+      squaredNormCD = _mm512_add_pd(_mm512_mul_pd(CD[0], CD[0]),
+                                    _mm512_mul_pd(CD[1], CD[1]));
+      hit = _mm512_cmp_pd_mask(
+          _mm512_abs_pd(det),
+          _mm512_set1_pd(GeometryKernel<D>::_TOLERANCE *
+                         GeometryKernel<D>::_TOLERANCE),
+          _CMP_NLT_UQ);
+      hit &= _mm512_cmp_pd_mask(zero, r, _CMP_LT_OQ);
+      hit &= _mm512_cmp_pd_mask(
+          r,
+          _mm512_add_pd(one, _mm512_div_pd(tolerance,
+                                           _mm512_sqrt_pd(squaredNormAB))),
+          _CMP_LT_OQ);
+      hit &= _mm512_cmp_pd_mask(zero, s, _CMP_LT_OQ);
+      hit &= _mm512_cmp_pd_mask(
+          s,
+          _mm512_add_pd(one, _mm512_div_pd(tolerance,
+                                           _mm512_sqrt_pd(squaredNormCD))),
+          _CMP_LT_OQ);
+    } else {
+      /* The shortest segment PQ between AB and CD. */
+      squaredNormAB = _mm512_mul_pd(AB[0], AB[0]);
+      squaredNormCD = _mm512_mul_pd(CD[0], CD[0]);
+      dotABCD = _mm512_mul_pd(AB[0], CD[0]);
+      dotACAB = _mm512_mul_pd(AC[0], AB[0]);
+      dotACCD = _mm512_mul_pd(AC[0], CD[0]);
+      for (k = 1; k < 3; k++) {
+        squaredNormAB =
+            _mm512_add_pd(squaredNormAB, _mm512_mul_pd(AB[k], AB[k]));
+        squaredNormCD =
+            _mm512_add_pd(squaredNormCD, _mm512_mul_pd(CD[k], CD[k]));
+        dotABCD = _mm512_add_pd(dotABCD, _mm512_mul_pd(AB[k], CD[k]));
+        dotACAB = _mm512_add_pd(dotACAB, _mm512_mul_pd(AC[k], AB[k]));
+        dotACCD = _mm512_add_pd(dotACCD, _mm512_mul_pd(AC[k], CD[k]));
+      }
+      det = _mm512_sub_pd(_mm512_mul_pd(dotABCD, dotABCD),
+                          _mm512_mul_pd(squaredNormAB, squaredNormCD));
+      r = _mm512_div_pd(_mm512_sub_pd(_mm512_mul_pd(dotABCD, dotACCD),
+                                      _mm512_mul_pd(dotACAB, squaredNormCD)),
+                        det);
+      s = _mm512_div_pd(_mm512_sub_pd(_mm512_mul_pd(dotACCD, squaredNormAB),
+                                      _mm512_mul_pd(dotACAB, dotABCD)),
+                        det);
+      squaredNormPQ = zero;
+      for (k = 0; k < 3; k++) {
+        PQ = _mm512_sub_pd(
+            _mm512_add_pd(C[k], _mm512_mul_pd(s, CD[k])),
+            _mm512_add_pd(A[k], _mm512_mul_pd(r, AB[k])));
+        squaredNormPQ = k == 0 ? _mm512_mul_pd(PQ, PQ)
+                               : _mm512_add_pd(squaredNormPQ,
+                                               _mm512_mul_pd(PQ, PQ));
+      }
+      hit = _mm512_cmp_pd_mask(_mm512_abs_pd(det),
+                               _mm512_set1_pd(GeometryKernel<D>::_TOLERANCE),
+                               _CMP_NLT_UQ);
+      hit &= _mm512_cmp_pd_mask(zero, r, _CMP_LT_OQ);
+      hit &= _mm512_cmp_pd_mask(r, one, _CMP_LT_OQ);
+      hit &= _mm512_cmp_pd_mask(zero, s, _CMP_LT_OQ);
+      hit &= _mm512_cmp_pd_mask(s, one, _CMP_LT_OQ);
+      hit &= _mm512_cmp_pd_mask(squaredNormPQ,
+                                _mm512_mul_pd(tolerance, tolerance),
+                                _CMP_LT_OQ);
+    }
+
+    mask |= static_cast<unsigned long>(hit) << i;
+    if (stopOnHit && mask != 0) {
+      return mask;
+    }
+  }
+
+  return intersectionMaskScalar<D>(pointC, pointD, proximalPoints,
+                                   distalPoints, tolerances, i,
+                                   numberOfSegments, stopOnHit, mask);
+}
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+int SegmentIntersectionKernel::supportedInstructionSet() {
+  return SegmentDistanceKernel::supportedInstructionSet();
+}
+
+int SegmentIntersectionKernel::instructionSet() {
+  if (_instructionSet < 0) {
+    _instructionSet = supportedInstructionSet();
+  }
+  return _instructionSet;
+}
+
+void SegmentIntersectionKernel::setInstructionSet(int value) {
+  if (value < SegmentDistanceKernel::SCALAR ||
+      value > supportedInstructionSet()) {
+    throw invalid_argument("Oops! The instruction set is not supported.");
+  }
+  _instructionSet = value;
+}
+
+unsigned long SegmentIntersectionKernel::intersectionMask(
+    int dimension, const double *pointC, const double *pointD,
+    const double *proximalPoints, const double *distalPoints,
+    const double *tolerances, int numberOfSegments, bool stopOnHit) {
+  if (numberOfSegments > MAXIMUMNUMBEROFSEGMENTS) {
+    throw invalid_argument("Oops! Too many segments to test at once.");
+  }
+
+  switch (instructionSet()) {
+#ifdef _CCOLAB_SEGMENTINTERSECTIONKERNEL_X86
+    case SegmentDistanceKernel::AVX512:
+      return dimension == 2
+                 ? intersectionMaskAVX512<2>(pointC, pointD, proximalPoints,
+                                             distalPoints, tolerances,
+                                             numberOfSegments, stopOnHit)
+                 : intersectionMaskAVX512<3>(pointC, pointD, proximalPoints,
+                                             distalPoints, tolerances,
+                                             numberOfSegments, stopOnHit);
+    case SegmentDistanceKernel::AVX2:
+      return dimension == 2
+                 ? intersectionMaskAVX2<2>(pointC, pointD, proximalPoints,
+                                           distalPoints, tolerances,
+                                           numberOfSegments, stopOnHit)
+                 : intersectionMaskAVX2<3>(pointC, pointD, proximalPoints,
+                                           distalPoints, tolerances,
+                                           numberOfSegments, stopOnHit);
+#endif
+    default:
+      return dimension == 2
+                 ? intersectionMaskScalar<2>(pointC, pointD, proximalPoints,
+                                             distalPoints, tolerances, 0,
+                                             numberOfSegments, stopOnHit, 0)
+                 : intersectionMaskScalar<3>(pointC, pointD, proximalPoints,
+                                             distalPoints, tolerances, 0,
+                                             numberOfSegments, stopOnHit, 0);
+  }
+}
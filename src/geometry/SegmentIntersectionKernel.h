@@ -0,0 +1,114 @@
+/**
+ * @file SegmentIntersectionKernel.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ * 
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <stdexcept>
+
+#include "GeometryKernel.h"
+#include "SegmentDistanceKernel.h"
+using std::invalid_argument;
+
+#ifndef _CCOLAB_GEOMETRY_SEGMENTINTERSECTIONKERNEL_H
+#define _CCOLAB_GEOMETRY_SEGMENTINTERSECTIONKERNEL_H
+/**
+ * @brief Intersection tests of one segment against many segments (the test
+ * of Geometry::hasIntersection).
+ *
+ * The segments are tested 4 (AVX2) or 8 (AVX-512) at a time, with the
+ * instruction set picked at run time as in SegmentDistanceKernel, and one at
+ * a time on other processors. The operations are those of GeometryKernel,
+ * in the same order and without fused multiply-add, so the answer is the
+ * same on every instruction set.
+ */
+class SegmentIntersectionKernel {
+ public:
+  /**
+   * @brief The maximum number of segments tested at once.
+   *
+   */
+  static constexpr int MAXIMUMNUMBEROFSEGMENTS = 64;
+
+ private:
+  /**
+   * @brief The instruction set in use (negative until the first use).
+   *
+   */
+  static int _instructionSet;
+
+ public:
+  /**
+   * @brief Get the best instruction set of the processor.
+   *
+   * @return The instruction set (SegmentDistanceKernel::SCALAR, AVX2 or
+   * AVX512).
+   */
+  static int supportedInstructionSet();
+
+  /**
+   * @brief Get the instruction set in use (the best one of the processor,
+   * unless it was set).
+   *
+   * @return The instruction set.
+   */
+  static int instructionSet();
+
+  /**
+   * @brief Set the instruction set in use.
+   *
+   * @param value The instruction set. It must be supported by the processor.
+   */
+  static void setInstructionSet(int value);
+
+  /**
+   * @brief Test the segments against the segment CD.
+   *
+   * The bit i of the answer is set if the segment i intersects CD, that is,
+   * if Geometry::hasIntersection(proximal point i, distal point i, C, D,
+   * tolerance i) is true. The points are stored with 3 coordinates each (z
+   * is zero in 2D).
+   *
+   * @param dimension The dimension (2 or 3).
+   * @param pointC The point C (3 coordinates).
+   * @param pointD The point D (3 coordinates).
+   * @param proximalPoints The proximal points of the segments.
+   * @param distalPoints The distal points of the segments.
+   * @param tolerances The tolerance of each segment.
+   * @param numberOfSegments The number of segments (at most
+   * MAXIMUMNUMBEROFSEGMENTS).
+   * @param stopOnHit Flag if the test stops on the first group of segments
+   * (tested at once) with a hit. The bits of the segments not tested are
+   * zero.
+   * @return The mask of the segments that intersect CD.
+   */
+  static unsigned long intersectionMask(int dimension, const double *pointC,
+                                        const double *pointD,
+                                        const double *proximalPoints,
+                                        const double *distalPoints,
+                                        const double *tolerances,
+                                        int numberOfSegments, bool stopOnHit);
+};
+#endif  //_CCOLAB_GEOMETRY_SEGMENTINTERSECTIONKERNEL_H
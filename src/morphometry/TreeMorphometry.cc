@@ -28,18 +28,78 @@
  */
 #include "TreeMorphometry.h"
 
+void TreeMorphometry::allocate() {
+  deallocate();
+  _numberOfSegments = _tree->totalNumberOfSegments();
+  _length = new double[_numberOfSegments];
+  _radius = new double[_numberOfSegments];
+  _level = new int[_numberOfSegments];
+  _strahlerOrder = new int[_numberOfSegments];
+  _subtreeVolume = new double[_numberOfSegments];
+  _numberOfTerminals = new int[_numberOfSegments];
+  _order = new int[_numberOfSegments];
+  _stack = new int[_numberOfSegments];
+}
+
+void TreeMorphometry::deallocate() {
+  delete[] _length;
+  delete[] _radius;
+  delete[] _level;
+  delete[] _strahlerOrder;
+  delete[] _subtreeVolume;
+  delete[] _numberOfTerminals;
+  delete[] _order;
+  delete[] _stack;
+  _numberOfSegments = 0;
+}
+
 void TreeMorphometry::analytics() {
-  int i, totalNumberOfSegments = _tree->totalNumberOfSegments();
-  _length = new double[totalNumberOfSegments];
-  _radius = new double[totalNumberOfSegments];
-  _level = new int[totalNumberOfSegments];
-  _strahlerOrder = new int[totalNumberOfSegments];
+  int i, segmentID, leftID, rightID, numberOfSegments = 0, stackSize = 0;
+  if (_numberOfSegments != _tree->totalNumberOfSegments()) {
+    allocate();
+  }
+  if (_tree->begin() == _tree->end()) {
+    return;
+  }
 
-  for (i = _tree->begin(); i < _tree->end(); i++) {
-    _length[i] = _tree->length(i);
-    _radius[i] = _tree->radius(i);
-    _level[i] = _tree->level(i);
-    _strahlerOrder[i] = _tree->strahlerOrder(i);
+  /* From the root down: each parent is evaluated before its descendents. */
+  _stack[stackSize++] = _tree->rootID();
+  while (stackSize > 0) {
+    segmentID = _stack[--stackSize];
+    _order[numberOfSegments++] = segmentID;
+    _length[segmentID] = _tree->length(segmentID);
+    _radius[segmentID] = _tree->radius(segmentID);
+    _level[segmentID] = _tree->isRoot(segmentID)
+                            ? 0
+                            : _level[_tree->parentID(segmentID)] + 1;
+    if (!_tree->isTerminal(segmentID)) {
+      _stack[stackSize++] = _tree->rightID(segmentID);
+      _stack[stackSize++] = _tree->leftID(segmentID);
+    }
+  }
+
+  /* From the terminals up: each segment after its descendents. */
+  for (i = numberOfSegments - 1; i >= 0; i--) {
+    segmentID = _order[i];
+    _subtreeVolume[segmentID] = M_PI * _radius[segmentID] *
+                                _radius[segmentID] * _length[segmentID];
+    if (_tree->isTerminal(segmentID)) {
+      _strahlerOrder[segmentID] = 1;
+      _numberOfTerminals[segmentID] = 1;
+    } else {
+      leftID = _tree->leftID(segmentID);
+      rightID = _tree->rightID(segmentID);
+      if (_strahlerOrder[leftID] == _strahlerOrder[rightID]) {
+        _strahlerOrder[segmentID] = _strahlerOrder[leftID] + 1;
+      } else {
+        _strahlerOrder[segmentID] =
+            std::max(_strahlerOrder[leftID], _strahlerOrder[rightID]);
+      }
+      _subtreeVolume[segmentID] +=
+          _subtreeVolume[leftID] + _subtreeVolume[rightID];
+      _numberOfTerminals[segmentID] =
+          _numberOfTerminals[leftID] + _numberOfTerminals[rightID];
+    }
   }
 }
 
@@ -50,10 +110,13 @@ void TreeMorphometry::save(string filename, string delimiter) {
   analytics();
   if (treefile.is_open()) {
     treefile << "LENGTH" << delimiter << "RADIUS" << delimiter << "LEVEL"
-             << delimiter << "STRAHLER_ORDER" << endl;
+             << delimiter << "STRAHLER_ORDER" << delimiter << "SUBTREE_VOLUME"
+             << delimiter << "TERMINALS" << endl;
     for (i = _tree->begin(); i < _tree->end(); i++) {
       treefile << _length[i] << delimiter << _radius[i] << delimiter
-               << _level[i] << delimiter << _strahlerOrder[i] << endl;
+               << _level[i] << delimiter << _strahlerOrder[i] << delimiter
+               << _subtreeVolume[i] << delimiter << _numberOfTerminals[i]
+               << endl;
     }
     treefile.close();
   } else {
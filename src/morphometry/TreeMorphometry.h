@@ -26,6 +26,7 @@
  * @version 1.0
  * @date 2022-05-18
  */
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -50,31 +51,75 @@ class TreeMorphometry {
    * @brief The vector of trees.
    * 
    */
-  TreeModel *_tree;
+  TreeModel *_tree = nullptr;
+
+  /**
+   * @brief The number of segments of the vectors.
+   * 
+   */
+  int _numberOfSegments = 0;
 
   /**
    * @brief The vector of length for each segment. 
    * 
    */
-  double *_length;
+  double *_length = nullptr;
 
   /**
    * @brief The vector of radius for each segment.
    * 
    */
-  double *_radius;
+  double *_radius = nullptr;
   
   /**
    * @brief The vector of bifurcation level for each segment.
    * 
    */
-  int *_level;
+  int *_level = nullptr;
 
   /**
    * @brief The vector of Strahler order for each segment.
    * 
    */
-  int *_strahlerOrder;
+  int *_strahlerOrder = nullptr;
+
+  /**
+   * @brief The vector of the volume of the subtree of each segment (the
+   * segment included).
+   * 
+   */
+  double *_subtreeVolume = nullptr;
+
+  /**
+   * @brief The vector of the number of terminals on the subtree of each
+   * segment.
+   * 
+   */
+  int *_numberOfTerminals = nullptr;
+
+  /**
+   * @brief The segments in preorder (each segment after its ascendents).
+   * 
+   */
+  int *_order = nullptr;
+
+  /**
+   * @brief The stack of the segments to visit.
+   * 
+   */
+  int *_stack = nullptr;
+
+  /**
+   * @brief Allocate the vectors for the segments of the tree.
+   * 
+   */
+  void allocate();
+
+  /**
+   * @brief Release the vectors.
+   * 
+   */
+  void deallocate();
 
  public:
   /**
@@ -87,7 +132,7 @@ class TreeMorphometry {
    * @brief Destroy the Tree Morphometry object.
    * 
    */
-  ~TreeMorphometry() {}
+  ~TreeMorphometry() { deallocate(); }
 
   /**
    * @brief Set the tree.
@@ -97,8 +142,15 @@ class TreeMorphometry {
   void setTree(TreeModel *tree) { _tree = tree; }
 
   /**
-   * @brief Evaluate the length, radius, bifurcation level, and Strahler order
-   * for each segment.
+   * @brief Evaluate the length, radius, bifurcation level, Strahler order,
+   * subtree volume and number of terminals for each segment.
+   * 
+   * The tree is visited once in preorder, with an explicit stack, where the
+   * length, the radius and the level (one more than the parent one) are
+   * evaluated. The Strahler order, the subtree volume and the number of
+   * terminals are then evaluated in the reverse order, so each segment comes
+   * after its descendents. The cost is linear on the number of segments and
+   * there is no recursion, even on very deep trees.
    * 
    */
   void analytics();
@@ -108,8 +160,10 @@ class TreeMorphometry {
    * radius, bifurcation level, and Strahler order for the segments on the
    * tree.
    * 
-   * Each row has the length, radius, bifurcation level, and Strahler order
-   * (in respective column "LENGTH", "RADIUS", "LEVEL", and "STRAHLER_ORDER").
+   * Each row has the length, radius, bifurcation level, Strahler order,
+   * subtree volume and number of terminals on the subtree (in respective
+   * column "LENGTH", "RADIUS", "LEVEL", "STRAHLER_ORDER", "SUBTREE_VOLUME"
+   * and "TERMINALS"). The rows follow the segment indices.
    * 
    * @param filename The filename.
    * @param delimiter The delimiter for the columns. Defaults to one space.
@@ -0,0 +1,60 @@
+/**
+ * @file AllocationCounter.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+
+#ifndef _CCOLAB_PROGRESS_ALLOCATIONCOUNTER_H
+#define _CCOLAB_PROGRESS_ALLOCATIONCOUNTER_H
+/**
+ * @brief Counter of the heap allocations, to check that the loops do not
+ * allocate.
+ *
+ * The counter only works when the code is compiled with
+ * -DCCOLAB_COUNT_ALLOCATIONS (for example, make cco
+ * DEFINES=-DCCOLAB_COUNT_ALLOCATIONS). Then the global operators new and
+ * new[] count every call. Otherwise the count is always zero and there is
+ * no cost.
+ */
+class AllocationCounter {
+ public:
+  /**
+   * @brief Check if the allocations are counted.
+   *
+   * @return Returns true if the code was compiled with
+   * CCOLAB_COUNT_ALLOCATIONS. Returns false otherwise.
+   */
+  static bool isEnabled();
+
+  /**
+   * @brief Get the number of heap allocations since the program started (of
+   * all threads).
+   *
+   * @return The number of heap allocations.
+   */
+  static long numberOfAllocations();
+};
+#endif  // _CCOLAB_PROGRESS_ALLOCATIONCOUNTER_H
@@ -73,11 +73,12 @@ Progress::Progress(int totalSteps, string prefix, char fill, int length,
 
 void Progress::print() {
   double percent;
-  stringstream _per;
+  char _per[32];
   if (_printBar) {
+    /* Format with snprintf, as a stringstream allocates on each call. */
     percent = 100.0 * _step / _totalSteps;
-    _per << fixed << setprecision(1) << percent;
-    cout << "\r" << _prefix << " " << _bar << " " << _per.str() << "%";
+    snprintf(_per, sizeof(_per), "%.1f", percent);
+    cout << "\r" << _prefix << " " << _bar << " " << _per << "%";
     _printBar = false;
     if (_step == _totalSteps) {
       reset();
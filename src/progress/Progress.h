@@ -27,6 +27,7 @@
  * @date 2022-05-18
  */
 #include <cmath>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -60,5 +60,12 @@ class ConstantBifurcationExpoent : public BifurcationExpoentLaw {
    * @return The bifurction expoent.
    */
   virtual double eval(int segmentLevel);
+
+  /**
+   * @brief The expoent is the same at every level.
+   * 
+   * @return Returns true.
+   */
+  virtual bool isConstant() { return true; }
 };
 #endif //_CCOLAB_TREE_CONSTANTBIFURCATIONEXPOENT_H
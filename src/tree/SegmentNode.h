@@ -0,0 +1,105 @@
+/**
+ * @file SegmentNode.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+
+#ifndef _CCOLAB_TREE_SEGMENTNODE_H
+#define _CCOLAB_TREE_SEGMENTNODE_H
+/**
+ * @brief The fields of a segment that the tree reads and writes together,
+ * packed into one 64-byte cache line.
+ *
+ * Tree::update and the radius evaluation walk the tree only through these
+ * fields, so each visited segment costs a single cache line. The coordinates
+ * and the Segment records are kept in separate arrays.
+ */
+class alignas(64) SegmentNode {
+ public:
+  /**
+   * @brief The blood flow passing through the segment.
+   *
+   */
+  double flow = 0.0;
+
+  /**
+   * @brief The reduced hydrodynamic resistance of the subtree.
+   *
+   */
+  double reducedHydrodynamicResistance = 0.0;
+
+  /**
+   * @brief The segment length (without the length unit).
+   *
+   */
+  double length = 0.0;
+
+  /**
+   * @brief The left bifurcation ratio.
+   *
+   */
+  double bifurcationRatioLeft = 1.0;
+
+  /**
+   * @brief The right bifurcation ratio.
+   *
+   */
+  double bifurcationRatioRight = 1.0;
+
+  /**
+   * @brief The radius ratio between the segment and the root (valid only
+   * while the tree version does not change).
+   *
+   */
+  double radiusRatio = 1.0;
+
+  /**
+   * @brief The index of the ascendent segment.
+   *
+   */
+  int up = -1;
+
+  /**
+   * @brief The index of the left descendent segment.
+   *
+   */
+  int left = -1;
+
+  /**
+   * @brief The index of the right descendent segment.
+   *
+   */
+  int right = -1;
+
+  /**
+   * @brief The bifurcation level (the number of ascendents).
+   *
+   */
+  int level = 0;
+};
+
+static_assert(sizeof(SegmentNode) == 64, "SegmentNode must fill a cache line.");
+#endif  // _CCOLAB_TREE_SEGMENTNODE_H
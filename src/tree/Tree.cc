@@ -29,12 +29,87 @@
 #include "Tree.h"
 
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 using std::cout;
 using std::endl;
 
+bool Tree::_hugePages = true;
+
+/**
+ * @brief Allocate a vector aligned to the cache line. Vectors of at least one
+ * huge page are aligned to the huge page and, if enabled, advised to use huge
+ * pages. The vector is released with free().
+ *
+ * @param size The size of the vector in bytes.
+ * @param hugePages Flag if the huge pages are advised.
+ * @return The vector.
+ */
+static void *allocateAligned(size_t size, bool hugePages) {
+  const size_t cacheLine = 64, hugePage = 2 * 1024 * 1024;
+  size_t alignment = size >= hugePage ? hugePage : cacheLine;
+  void *memory = nullptr;
+  if (posix_memalign(&memory, alignment, size) != 0) {
+    throw std::bad_alloc();
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (hugePages && size >= hugePage) {
+    /* Only an advice: it is ignored where huge pages are not available. */
+    madvise(memory, size - size % hugePage, MADV_HUGEPAGE);
+  }
+#endif
+  return memory;
+}
+
+/**
+ * @brief Move each record of the vector to its new position: the record at
+ * position i is moved from position order[i]. The records are moved along
+ * the cycles of the permutation, so only one record is saved at a time.
+ *
+ * @tparam T The type of the record elements.
+ * @param values The vector.
+ * @param stride The number of elements of each record (at most 3).
+ * @param order The old position of the record at each new position.
+ * @param isMoved Working vector with a flag for each record.
+ * @param n The number of records.
+ */
+template <typename T>
+static void permute(T *values, int stride, const int *order, bool *isMoved,
+                    int n) {
+  int i, j, k, next;
+  T saved[3];
+  for (i = 0; i < n; i++) {
+    isMoved[i] = false;
+  }
+  for (i = 0; i < n; i++) {
+    if (isMoved[i]) {
+      continue;
+    }
+    for (k = 0; k < stride; k++) {
+      saved[k] = values[stride * i + k];
+    }
+    j = i;
+    while (order[j] != i) {
+      next = order[j];
+      for (k = 0; k < stride; k++) {
+        values[stride * j + k] = values[stride * next + k];
+      }
+      isMoved[j] = true;
+      j = next;
+    }
+    for (k = 0; k < stride; k++) {
+      values[stride * j + k] = saved[k];
+    }
+    isMoved[j] = true;
+  }
+}
+
 Tree::Tree(Point seed, int numberOfTerminals, int dimension)
     : TreeModel(seed, numberOfTerminals, dimension) {
 
@@ -49,10 +124,9 @@ Tree::Tree(Point seed, int numberOfTerminals, int dimension)
    *  Allocate all segments once. It speed up the code because later it wont
    *  need to create/destroy objects as the tree grows.
    **/
-  _segments = new Segment[TreeModel::totalNumberOfSegments()];
-  _reducedHydrodynamicResistance =
-      new double[TreeModel::totalNumberOfSegments()];
-  _length = new double[TreeModel::totalNumberOfSegments()];
+  allocateSegments();
+  allocateRadiusRatio();
+  allocateSegmentIndex();
 }
 
 Tree::Tree(Point seed, int numberOfTerminals, int dimension,
@@ -70,26 +144,340 @@ Tree::Tree(Point seed, int numberOfTerminals, int dimension,
    *  Allocate all segments once. It speed up the code because later it wont
    *  need to create/destroy objects as the tree grows.
    **/
-  _segments = new Segment[TreeModel::totalNumberOfSegments()];
-  _reducedHydrodynamicResistance =
-      new double[TreeModel::totalNumberOfSegments()];
+  allocateSegments();
+  allocateRadiusRatio();
+  allocateSegmentIndex();
 }
 
 Tree::~Tree() {
-  delete[] _reducedHydrodynamicResistance;
-  delete[] _length;
+  delete[] _segments;
+  free(_nodes);
+  free(_distalCoordinates);
+  free(_proximalCoordinates);
   delete _geometry;
+  delete _segmentIndex;
+  delete[] _modifiedSegments;
+  delete[] _isModified;
+  delete[] _radiusRatioVersion;
+  delete[] _radiusRatioPath;
+  delete[] _strahlerOrder;
+  delete[] _observers;
+  delete[] _order;
+  delete[] _newIDs;
+  delete[] _isReordered;
 }
 
-int Tree::currentNumberOfTerminals() { return _currentNumberOfTerminals; }
+void Tree::allocateSegments() {
+  int i, n = TreeModel::totalNumberOfSegments();
+  _segments = new Segment[n];
+  _nodes = static_cast<SegmentNode *>(
+      allocateAligned(n * sizeof(SegmentNode), _hugePages));
+  _distalCoordinates = static_cast<double *>(
+      allocateAligned(3 * n * sizeof(double), _hugePages));
+  _proximalCoordinates = static_cast<double *>(
+      allocateAligned(3 * n * sizeof(double), _hugePages));
+  _strahlerOrder = new int[n];
+
+  /* The same initial values of a new Segment. */
+  for (i = 0; i < 3 * n; i++) {
+    _distalCoordinates[i] = 0.0;
+    _proximalCoordinates[i] = 0.0;
+  }
+  for (i = 0; i < n; i++) {
+    new (&_nodes[i]) SegmentNode();
+    _strahlerOrder[i] = 1;
+  }
+  setSeed(seed());
+}
+
+void Tree::setDistalPoint(int segmentID, Point point) {
+  int k;
+  const double *coordinates = point.coordinates();
+
+  _segments[segmentID].setPoint(point);
+  for (k = 0; k < 3; k++) {
+    _distalCoordinates[3 * segmentID + k] = coordinates[k];
+  }
+
+  if (_nodes[segmentID].left != _TERMINALEND) {
+    for (k = 0; k < 3; k++) {
+      _proximalCoordinates[3 * _nodes[segmentID].left + k] = coordinates[k];
+    }
+  }
+
+  if (_nodes[segmentID].right != _TERMINALEND) {
+    for (k = 0; k < 3; k++) {
+      _proximalCoordinates[3 * _nodes[segmentID].right + k] = coordinates[k];
+    }
+  }
+}
+
+void Tree::setFlow(int segmentID, double value) {
+  _segments[segmentID].setFlow(value);
+  _nodes[segmentID].flow = value;
+}
+
+void Tree::setBifurcationRatios(int segmentID, double left, double right) {
+  _segments[segmentID].setBifurcationRatioLeft(left);
+  _segments[segmentID].setBifurcationRatioRight(right);
+  _nodes[segmentID].bifurcationRatioLeft = left;
+  _nodes[segmentID].bifurcationRatioRight = right;
+}
+
+void Tree::setUp(int segmentID, int upID) {
+  int k;
+  _segments[segmentID].setUp(upID);
+  _nodes[segmentID].up = upID;
+  if (upID != _TERMINALEND) {
+    for (k = 0; k < 3; k++) {
+      _proximalCoordinates[3 * segmentID + k] =
+          _distalCoordinates[3 * upID + k];
+    }
+  }
+}
+
+void Tree::setDescendents(int segmentID, int leftID, int rightID) {
+  _segments[segmentID].setLeft(leftID);
+  _segments[segmentID].setRight(rightID);
+  _nodes[segmentID].left = leftID;
+  _nodes[segmentID].right = rightID;
+}
+
+bool Tree::shiftLevels(int segmentID, int value) {
+  int currentID = segmentID, previousID;
+  bool isExpoentConstant = isBifurcationExpoentConstant(),
+       isExpoentChanged = false;
+  while (true) {
+    _nodes[currentID].level += value;
+    if (!isTerminal(currentID)) {
+      if (!isExpoentConstant &&
+          bifurcationExpoent(_nodes[currentID].level) !=
+              bifurcationExpoent(_nodes[currentID].level - value)) {
+        isExpoentChanged = true;
+      }
+      currentID = _nodes[currentID].left;
+      continue;
+    }
+
+    /* Climb up to the first ascendent whose right subtree is not visited. */
+    do {
+      if (currentID == segmentID) {
+        return isExpoentChanged;
+      }
+      previousID = currentID;
+      currentID = _nodes[currentID].up;
+    } while (_nodes[currentID].right == previousID);
+    currentID = _nodes[currentID].right;
+  }
+}
+
+void Tree::updateSubtree(int segmentID) {
+  int currentID = segmentID, previousID;
+  while (true) {
+    while (!isTerminal(currentID)) {
+      currentID = _nodes[currentID].left;
+    }
+
+    /**
+     *  Climb up evaluating the bifurcations whose right subtree is visited,
+     *  until the first one whose right subtree is not.
+     **/
+    while (true) {
+      if (!isTerminal(currentID)) {
+        updateSegment(currentID);
+        notify(currentID);
+      }
+      if (currentID == segmentID) {
+        return;
+      }
+      previousID = currentID;
+      currentID = _nodes[currentID].up;
+      if (_nodes[currentID].left == previousID) {
+        currentID = _nodes[currentID].right;
+        break;
+      }
+    }
+  }
+}
+
+void Tree::updateStrahlerOrders(int segmentID) {
+  int order, leftOrder, rightOrder;
+  while (segmentID != _TERMINALEND) {
+    if (isTerminal(segmentID)) {
+      order = 1;
+    } else {
+      leftOrder = _strahlerOrder[_nodes[segmentID].left];
+      rightOrder = _strahlerOrder[_nodes[segmentID].right];
+      if (leftOrder == rightOrder) {
+        order = leftOrder + 1;
+      } else {
+        order = leftOrder > rightOrder ? leftOrder : rightOrder;
+      }
+    }
+
+    /* The ascendents depend only on this order. */
+    if (order == _strahlerOrder[segmentID]) {
+      return;
+    }
+    _strahlerOrder[segmentID] = order;
+    segmentID = _nodes[segmentID].up;
+  }
+}
+
+void Tree::allocateRadiusRatio() {
+  int i;
+  _radiusRatioVersion = new long[TreeModel::totalNumberOfSegments()];
+  _radiusRatioPath = new int[TreeModel::totalNumberOfSegments()];
+  for (i = 0; i < TreeModel::totalNumberOfSegments(); i++) {
+    _radiusRatioVersion[i] = -1;
+  }
+}
+
+void Tree::allocateSegmentIndex() {
+  int i;
+  _segmentIndex = new BoundingVolumeHierarchy(
+      TreeModel::totalNumberOfSegments(), dimension());
+  _modifiedSegments = new int[TreeModel::totalNumberOfSegments()];
+  _isModified = new bool[TreeModel::totalNumberOfSegments()];
+  for (i = 0; i < TreeModel::totalNumberOfSegments(); i++) {
+    _isModified[i] = false;
+  }
+}
+
+void Tree::attach(TreeObserver *observer) {
+  int i;
+  TreeObserver **observers = new TreeObserver *[_numberOfObservers + 1];
+  for (i = 0; i < _numberOfObservers; i++) {
+    observers[i] = _observers[i];
+  }
+  observers[_numberOfObservers] = observer;
+  delete[] _observers;
+  _observers = observers;
+  _numberOfObservers++;
+}
+
+void Tree::detach(TreeObserver *observer) {
+  int i, j = 0;
+  for (i = 0; i < _numberOfObservers; i++) {
+    if (_observers[i] != observer) {
+      _observers[j++] = _observers[i];
+    }
+  }
+  _numberOfObservers = j;
+}
+
+void Tree::notify(int segmentID) {
+  int i;
+  for (i = 0; i < _numberOfObservers; i++) {
+    _observers[i]->changed(segmentID);
+  }
+}
+
+void Tree::refresh() {
+  int i;
+  updateSegmentIndex();
+  rootRadius();
+  for (i = begin(); i < end(); i++) {
+    radiusRatio(i);
+  }
+}
+
+void Tree::reorder() {
+  int i, segmentID, stackSize = 0, n = end();
+  if (_order == nullptr) {
+    _order = new int[TreeModel::totalNumberOfSegments()];
+    _newIDs = new int[TreeModel::totalNumberOfSegments()];
+    _isReordered = new bool[TreeModel::totalNumberOfSegments()];
+  }
+  if (n == 0) {
+    return;
+  }
+
+  /**
+   *  Number the segments in preorder. The segments not numbered yet are on
+   *  the stack, kept on _newIDs (there are never more than n of them).
+   **/
+  _newIDs[stackSize++] = _rootID;
+  for (i = 0; i < n; i++) {
+    segmentID = _newIDs[--stackSize];
+    _order[i] = segmentID;
+    if (!isTerminal(segmentID)) {
+      _newIDs[stackSize++] = _nodes[segmentID].right;
+      _newIDs[stackSize++] = _nodes[segmentID].left;
+    }
+  }
+  for (i = 0; i < n; i++) {
+    _newIDs[_order[i]] = i;
+  }
 
-int Tree::begin() { return _rootID; }
+  /* Rewrite the links and move the records. */
+  for (i = 0; i < n; i++) {
+    if (_nodes[i].up != _TERMINALEND) {
+      _nodes[i].up = _newIDs[_nodes[i].up];
+    }
+    if (_nodes[i].left != _TERMINALEND) {
+      _nodes[i].left = _newIDs[_nodes[i].left];
+      _nodes[i].right = _newIDs[_nodes[i].right];
+    }
+  }
+  permute(_nodes, 1, _order, _isReordered, n);
+  permute(_distalCoordinates, 3, _order, _isReordered, n);
+  permute(_proximalCoordinates, 3, _order, _isReordered, n);
+  permute(_segments, 1, _order, _isReordered, n);
+  permute(_strahlerOrder, 1, _order, _isReordered, n);
+  for (i = 0; i < n; i++) {
+    _segments[i].setID(i);
+    _segments[i].setUp(_nodes[i].up);
+    _segments[i].setLeft(_nodes[i].left);
+    _segments[i].setRight(_nodes[i].right);
+  }
 
-int Tree::end() { return currentNumberOfSegments(); }
+  /**
+   *  Every segment has new values for its index. The descendents are notified
+   *  before their ascendents, as update() does (in preorder they come after).
+   **/
+  for (i = n - 1; i >= 0; i--) {
+    modify(i);
+    notify(i);
+  }
+  changeRadii();
+}
+
+void Tree::modify(int segmentID) {
+  if (!_isModified[segmentID]) {
+    _isModified[segmentID] = true;
+    _modifiedSegments[_numberOfModifiedSegments++] = segmentID;
+  }
+}
+
+void Tree::updateSegmentIndex() {
+  int i, segmentID;
+  for (i = 0; i < _numberOfModifiedSegments; i++) {
+    segmentID = _modifiedSegments[i];
+    if (segmentID < end()) {
+      _segmentIndex->update(segmentID, proximalPoint(segmentID),
+                            distalPoint(segmentID));
+    } else {
+      _segmentIndex->remove(segmentID);
+    }
+    _isModified[segmentID] = false;
+  }
+  _numberOfModifiedSegments = 0;
+}
+
+int Tree::currentNumberOfTerminals() { return _currentNumberOfTerminals; }
 
 void Tree::setSeed(double *value) {
   Point seed(value, dimension());
-  TreeModel::setSeed(seed);
+  setSeed(seed);
+}
+
+void Tree::setSeed(Point point) {
+  int k;
+  TreeModel::setSeed(point);
+  for (k = 0; k < 3; k++) {
+    _proximalCoordinates[3 * _rootID + k] = point.coordinates()[k];
+  }
 }
 
 Segment Tree::root() { return _segments[_rootID]; }
@@ -99,42 +487,51 @@ Segment Tree::parent(int segmentID) {
   if (isRoot(segmentID)) {
     return _segments[segmentID];
   } else {
-    parentID = _segments[segmentID].up();
+    parentID = _nodes[segmentID].up;
     return _segments[parentID];
   }
 }
 
 Segment Tree::left(int segmentID) {
-  int leftID = _segments[segmentID].left();
+  int leftID = _nodes[segmentID].left;
   return _segments[leftID];
 }
 
 Segment Tree::right(int segmentID) {
-  int rightID = _segments[segmentID].right();
+  int rightID = _nodes[segmentID].right;
   return _segments[rightID];
 }
 
 void Tree::moveDistalPoint(int segmentID, Point point) {
-  int _left, _right;
+  int leftID, rightID;
   double oldLength;
-  _segments[segmentID].setPoint(point);
-  _length[segmentID] = _geometry->distance(proximalPoint(segmentID), point);
+  setDistalPoint(segmentID, point);
+  _nodes[segmentID].length =
+      _geometry->distance(proximalPoint(segmentID), point);
+  modify(segmentID);
   if (!isTerminal(segmentID)) {
-    _left = _segments[segmentID].left();
-    oldLength = _length[_left];
-    _length[_left] = _geometry->distance(point, distalPoint(_left));
-    _reducedHydrodynamicResistance[_left] =
-        _reducedHydrodynamicResistance[_left] +
-        _poiseuilleLawConstant * (bloodViscosity(_left) * _length[_left] -
-                                  bloodViscosity(_left) * oldLength);
-
-    _right = _segments[segmentID].right();
-    oldLength = _length[_right];
-    _length[_right] = _geometry->distance(point, distalPoint(_right));
-    _reducedHydrodynamicResistance[_right] =
-        _reducedHydrodynamicResistance[_right] +
-        _poiseuilleLawConstant * (bloodViscosity(_right) * _length[_right] -
-                                  bloodViscosity(_right) * oldLength);
+    leftID = _nodes[segmentID].left;
+    modify(leftID);
+    oldLength = _nodes[leftID].length;
+    _nodes[leftID].length = _geometry->distance(point, distalPoint(leftID));
+    _nodes[leftID].reducedHydrodynamicResistance =
+        _nodes[leftID].reducedHydrodynamicResistance +
+        _poiseuilleLawConstant *
+            (bloodViscosity(leftID) * _nodes[leftID].length -
+             bloodViscosity(leftID) * oldLength);
+
+    rightID = _nodes[segmentID].right;
+    modify(rightID);
+    oldLength = _nodes[rightID].length;
+    _nodes[rightID].length = _geometry->distance(point, distalPoint(rightID));
+    _nodes[rightID].reducedHydrodynamicResistance =
+        _nodes[rightID].reducedHydrodynamicResistance +
+        _poiseuilleLawConstant *
+            (bloodViscosity(rightID) * _nodes[rightID].length -
+             bloodViscosity(rightID) * oldLength);
+
+    notify(leftID);
+    notify(rightID);
   }
 
   update(_segments[segmentID]);
@@ -142,30 +539,52 @@ void Tree::moveDistalPoint(int segmentID, Point point) {
 
 Segment *Tree::segment(int segmentID) { return &_segments[segmentID]; }
 
-double Tree::length(int segmentID) {
-  return (TreeModel::lengthUnit()) * _length[segmentID];
+double Tree::radius(int segmentID) {
+  return radiusRatio(segmentID) * rootRadius();
 }
 
-double Tree::radius(int segmentID) {
-  int _parent;
-  double radiusRatio = 1.0;
-  double rootRadius =
-      TreeModel::radiusUnit() *
-      pow(reducedHydrodynamicResistance(_rootID) * _perfusionFlow /
-              (_perfusionPressure - _terminalPressure),
-          0.25);
-
-  while (!isRoot(segmentID)) {
-    _parent = _segments[segmentID].up();
-    if (_segments[_parent].left() == segmentID) {
-      radiusRatio *= _segments[_parent].bifurcationRatioLeft();
+double Tree::radiusRatio(int segmentID) {
+  int i, pathSize = 0, ancestorID = segmentID, parentID;
+
+  /* Search for the closest ancestor with an updated radius ratio. */
+  while (_radiusRatioVersion[ancestorID] != _version && !isRoot(ancestorID)) {
+    _radiusRatioPath[pathSize++] = ancestorID;
+    ancestorID = _nodes[ancestorID].up;
+  }
+
+  if (_radiusRatioVersion[ancestorID] != _version) {
+    _nodes[ancestorID].radiusRatio = 1.0;
+    _radiusRatioVersion[ancestorID] = _version;
+  }
+
+  /* Evaluate the radius ratios from that ancestor down to the segment. */
+  while (pathSize > 0) {
+    i = _radiusRatioPath[--pathSize];
+    parentID = _nodes[i].up;
+    if (_nodes[parentID].left == i) {
+      _nodes[i].radiusRatio =
+          _nodes[parentID].radiusRatio * _nodes[parentID].bifurcationRatioLeft;
     } else {
-      radiusRatio *= _segments[_parent].bifurcationRatioRight();
+      _nodes[i].radiusRatio =
+          _nodes[parentID].radiusRatio * _nodes[parentID].bifurcationRatioRight;
     }
-    segmentID = _parent;
+    _radiusRatioVersion[i] = _version;
+  }
+
+  return _nodes[segmentID].radiusRatio;
+}
+
+double Tree::rootRadius() {
+  if (_rootRadiusVersion != _version) {
+    _rootRadius =
+        TreeModel::radiusUnit() *
+        pow(reducedHydrodynamicResistance(_rootID) * _perfusionFlow /
+                (_perfusionPressure - _terminalPressure),
+            0.25);
+    _rootRadiusVersion = _version;
   }
 
-  return radiusRatio * rootRadius;
+  return _rootRadius;
 }
 
 double Tree::volume() {
@@ -182,34 +601,24 @@ double Tree::volume() {
   return vol;
 }
 
-double Tree::reducedHydrodynamicResistance(int segmentID) {
-  return _reducedHydrodynamicResistance[segmentID];
+void Tree::setRadiusUnit(double value) {
+  TreeModel::setRadiusUnit(value);
+  changeRadii();
 }
 
-int Tree::level(int segmentID) {
-  int _level = 0;
-  while (!isRoot(segmentID)) {
-    _level++;
-    segmentID = _segments[segmentID].up();
-  }
-
-  return _level;
+void Tree::setPerfusionPressure(double value) {
+  TreeModel::setPerfusionPressure(value);
+  changeRadii();
 }
 
-int Tree::strahlerOrder(int segmentID) {
-  int leftSO, rightSO;
+void Tree::setTerminalPressure(double value) {
+  TreeModel::setTerminalPressure(value);
+  changeRadii();
+}
 
-  if (isTerminal(segmentID)) {
-    return 1;
-  } else {
-    leftSO = strahlerOrder(left(segmentID).ID());
-    rightSO = strahlerOrder(right(segmentID).ID());
-    if (leftSO == rightSO) {
-      return leftSO + 1;
-    } else {
-      return leftSO > rightSO ? leftSO : rightSO;
-    }
-  }
+void Tree::setPerfusionFlow(double value) {
+  TreeModel::setPerfusionFlow(value);
+  changeRadii();
 }
 
 Segment Tree::growRoot(Segment root) {
@@ -219,9 +628,14 @@ Segment Tree::growRoot(Segment root) {
 
   _segments[_rootID].setID(_rootID);
   copy(root, _segments[_rootID]);
-  _reducedHydrodynamicResistance[_rootID] =
+  _nodes[_rootID].reducedHydrodynamicResistance =
       segmentReducedHydrodynamicResistance;
-  _length[_rootID] = rootLength;
+  _nodes[_rootID].length = rootLength;
+  _nodes[_rootID].level = 0;
+  _strahlerOrder[_rootID] = 1;
+  modify(_rootID);
+  changeRadii();
+  notify(_rootID);
   setCurrentNumberOfSegments(1);
   _currentNumberOfTerminals = 1;
 
@@ -229,81 +643,99 @@ Segment Tree::growRoot(Segment root) {
 }
 
 void Tree::copy(Segment source, Segment destination) {
+  modify(destination.ID());
+  changeRadii();
+  notify(destination.ID());
   _segments[destination.ID()].setDimension(dimension());
-  _segments[destination.ID()].setPoint(source.point());
-  _segments[destination.ID()].setFlow(source.flow());
-  _segments[destination.ID()].setBifurcationRatioLeft(
-      source.bifurcationRatioLeft());
-  _segments[destination.ID()].setBifurcationRatioRight(
-      source.bifurcationRatioRight());
-  _segments[destination.ID()].setLeft(source.left());
-  _segments[destination.ID()].setRight(source.right());
+  setDescendents(destination.ID(), source.left(), source.right());
+  setDistalPoint(destination.ID(), source.point());
+  setFlow(destination.ID(), source.flow());
+  setBifurcationRatios(destination.ID(), source.bifurcationRatioLeft(),
+                       source.bifurcationRatioRight());
 
   if (source.left() != _TERMINALEND) {
-    _segments[source.left()].setUp(destination.ID());
+    setUp(source.left(), destination.ID());
   }
 
   if (source.right() != _TERMINALEND) {
-    _segments[source.right()].setUp(destination.ID());
+    setUp(source.right(), destination.ID());
   }
 }
 
 Segment Tree::growSegment(Point bifurcationPoint, Segment parent,
                                Segment child) {
   double segmentReducedHydrodynamicResistance;
+  bool isExpoentChanged;
   Segment connection(dimension()), bifurcation(dimension()),
       newSegment(dimension());
 
   /* Create the connection segment as a copy of the parent. */
   _segments[currentNumberOfSegments()].setDimension(dimension());
   _segments[currentNumberOfSegments()].setID(currentNumberOfSegments());
-  _segments[currentNumberOfSegments()].setPoint(parent.point());
-  _segments[currentNumberOfSegments()].setFlow(parent.flow());
-  _segments[currentNumberOfSegments()].setBifurcationRatioLeft(
-      parent.bifurcationRatioLeft());
-  _segments[currentNumberOfSegments()].setBifurcationRatioRight(
-      parent.bifurcationRatioRight());
-  _segments[currentNumberOfSegments()].setLeft(parent.left());
-  _segments[currentNumberOfSegments()].setRight(parent.right());
+  setDescendents(currentNumberOfSegments(), parent.left(), parent.right());
+  setDistalPoint(currentNumberOfSegments(), parent.point());
+  setFlow(currentNumberOfSegments(), parent.flow());
+  setBifurcationRatios(currentNumberOfSegments(),
+                       parent.bifurcationRatioLeft(),
+                       parent.bifurcationRatioRight());
   if (parent.left() != _TERMINALEND) {
-    _segments[parent.left()].setUp(currentNumberOfSegments());
+    setUp(parent.left(), currentNumberOfSegments());
   }
 
   if (parent.right() != _TERMINALEND) {
-    _segments[parent.right()].setUp(currentNumberOfSegments());
+    setUp(parent.right(), currentNumberOfSegments());
   }
 
-  _segments[currentNumberOfSegments()].setUp(parent.ID());
-  _length[currentNumberOfSegments()] =
+  setUp(currentNumberOfSegments(), parent.ID());
+  modify(currentNumberOfSegments());
+
+  /* The connection takes the subtree of the parent one level down. */
+  _nodes[currentNumberOfSegments()].level = _nodes[parent.ID()].level;
+  _strahlerOrder[currentNumberOfSegments()] = _strahlerOrder[parent.ID()];
+  isExpoentChanged = shiftLevels(currentNumberOfSegments(), 1);
+  _nodes[currentNumberOfSegments()].length =
       _geometry->distance(bifurcationPoint, parent.point());
-  _reducedHydrodynamicResistance[currentNumberOfSegments()] =
-      _reducedHydrodynamicResistance[parent.ID()] +
+  _nodes[currentNumberOfSegments()].reducedHydrodynamicResistance =
+      _nodes[parent.ID()].reducedHydrodynamicResistance +
       _poiseuilleLawConstant *
           (bloodViscosity(currentNumberOfSegments()) *
-               _length[currentNumberOfSegments()] -
+               _nodes[currentNumberOfSegments()].length -
            bloodViscosity(parent.ID()) * length(parent.ID()));
   setCurrentNumberOfSegments(currentNumberOfSegments() + 1);
 
   /* Add the new segment. */
   _segments[currentNumberOfSegments()].setDimension(dimension());
   _segments[currentNumberOfSegments()].setID(currentNumberOfSegments());
-  _segments[currentNumberOfSegments()].setPoint(child.point());
-  _segments[currentNumberOfSegments()].setFlow(child.flow());
-  _segments[currentNumberOfSegments()].setUp(parent.ID());
-  _length[currentNumberOfSegments()] =
+  setDistalPoint(currentNumberOfSegments(), child.point());
+  setFlow(currentNumberOfSegments(), child.flow());
+  setUp(currentNumberOfSegments(), parent.ID());
+  modify(currentNumberOfSegments());
+  _nodes[currentNumberOfSegments()].level = _nodes[parent.ID()].level + 1;
+  _strahlerOrder[currentNumberOfSegments()] = 1;
+  _nodes[currentNumberOfSegments()].length =
       _geometry->distance(bifurcationPoint, child.point());
-  _reducedHydrodynamicResistance[currentNumberOfSegments()] =
+  _nodes[currentNumberOfSegments()].reducedHydrodynamicResistance =
       _poiseuilleLawConstant * bloodViscosity(currentNumberOfSegments()) *
-      _length[currentNumberOfSegments()];
+      _nodes[currentNumberOfSegments()].length;
   setCurrentNumberOfSegments(currentNumberOfSegments() + 1);
 
+  notify(currentNumberOfSegments() - 2);
+  notify(currentNumberOfSegments() - 1);
+
   /* Update the bifurcation segment. */
-  _segments[parent.ID()].setPoint(bifurcationPoint);
-  _segments[parent.ID()].setLeft(currentNumberOfSegments() - 2);
-  _segments[parent.ID()].setRight(currentNumberOfSegments() - 1);
-  _length[parent.ID()] =
+  setDescendents(parent.ID(), currentNumberOfSegments() - 2,
+                 currentNumberOfSegments() - 1);
+  updateStrahlerOrders(parent.ID());
+  setDistalPoint(parent.ID(), bifurcationPoint);
+  modify(parent.ID());
+  _nodes[parent.ID()].length =
       _geometry->distance(proximalPoint(parent.ID()), distalPoint(parent.ID()));
 
+  /* The ratios copied from the parent were evaluated at its level. */
+  if (isExpoentChanged) {
+    updateSubtree(currentNumberOfSegments() - 2);
+  }
+
   /* Recalculate the radii bifurcations ratio and the flow. */
   update(_segments[parent.ID()]);
 
@@ -313,22 +745,31 @@ Segment Tree::growSegment(Point bifurcationPoint, Segment parent,
 }
 
 Segment Tree::remove(Segment segment) {
-  int parentID = segment.up(), connectionID = _segments[segment.up()].left(),
-      terminalID = _segments[segment.up()].right();
+  int parentID = segment.up(), connectionID = _nodes[segment.up()].left,
+      terminalID = _nodes[segment.up()].right;
+  bool isLeftExpoentChanged = false, isRightExpoentChanged = false;
 
   /* Update the bifurcation segment. */
-  _segments[parentID].setPoint(_segments[connectionID].point());
-  _segments[parentID].setLeft(_segments[connectionID].left());
-  _segments[parentID].setRight(_segments[connectionID].right());
+  setDescendents(parentID, _nodes[connectionID].left,
+                 _nodes[connectionID].right);
+  setDistalPoint(parentID, distalPoint(connectionID));
   if (!isTerminal(connectionID)) {
-    _segments[_segments[connectionID].left()].setUp(parentID);
-    _segments[_segments[connectionID].right()].setUp(parentID);
+    setUp(_nodes[connectionID].left, parentID);
+    setUp(_nodes[connectionID].right, parentID);
+
+    /* The subtree of the connection goes one level up. */
+    isLeftExpoentChanged = shiftLevels(_nodes[connectionID].left, -1);
+    isRightExpoentChanged = shiftLevels(_nodes[connectionID].right, -1);
   } else {
-    _segments[parentID].setFlow(_segments[connectionID].flow());
+    setFlow(parentID, _nodes[connectionID].flow);
   }
+  updateStrahlerOrders(parentID);
 
-  _length[parentID] =
+  _nodes[parentID].length =
       _geometry->distance(proximalPoint(parentID), distalPoint(parentID));
+  modify(parentID);
+  modify(connectionID);
+  modify(terminalID);
 
   /* Remove the given terminal segment. */
   setCurrentNumberOfSegments(currentNumberOfSegments() - 1);
@@ -336,6 +777,14 @@ Segment Tree::remove(Segment segment) {
   /* Remove the connection segment. */
   setCurrentNumberOfSegments(currentNumberOfSegments() - 1);
 
+  /* The ratios of the subtrees were evaluated one level down. */
+  if (isLeftExpoentChanged) {
+    updateSubtree(_nodes[parentID].left);
+  }
+  if (isRightExpoentChanged) {
+    updateSubtree(_nodes[parentID].right);
+  }
+
   /* Recalculate the radii bifurcations ratio and the flow. */
   update(_segments[parentID]);
 
@@ -345,80 +794,79 @@ Segment Tree::remove(Segment segment) {
 }
 
 void Tree::update(Segment segment) {
-  int segmentID = segment.ID(), connectionID, _newID;
-  double connectionFlow, newFlow, flowRatio, leftReducedHydrodynamicResistance,
-      rightReducedHydrodynamicResistance, reducedHydrodynamicResistanceRatio,
-      radiusRatio, Rtemp, radiusRatioPowerBifurcationExpoent, leftRadiusRatio,
-      rightRadiusRatio;
+  int segmentID = segment.ID();
 
   /* Recalculate the radii bifurcations ratio and the flow from the segment up
    * to the root. */
   do {
-    if (isTerminal(segmentID)) {
-      _reducedHydrodynamicResistance[segmentID] = _poiseuilleLawConstant *
-                                                  bloodViscosity(segmentID) *
-                                                  length(segmentID);
-      _segments[segmentID].setBifurcationRatioLeft(1.0);
-      _segments[segmentID].setBifurcationRatioRight(1.0);
-    } else {
-      connectionID = _segments[segmentID].left();
-      _newID = _segments[segmentID].right();
-
-      connectionFlow = _segments[connectionID].flow();
-      newFlow = _segments[_newID].flow();
-      _segments[segmentID].setFlow(connectionFlow + newFlow);
-      flowRatio = connectionFlow / newFlow;
-
-      leftReducedHydrodynamicResistance =
-          reducedHydrodynamicResistance(connectionID);
-      rightReducedHydrodynamicResistance =
-          reducedHydrodynamicResistance(_newID);
-      reducedHydrodynamicResistanceRatio = leftReducedHydrodynamicResistance /
-                                           rightReducedHydrodynamicResistance;
-
-      radiusRatio = pow(flowRatio * reducedHydrodynamicResistanceRatio, 0.25);
-      radiusRatioPowerBifurcationExpoent =
-          pow(radiusRatio, bifurcationExpoent(segmentID));
-      leftRadiusRatio = pow(1.0 + 1.0 / radiusRatioPowerBifurcationExpoent,
-                            -1.0 / bifurcationExpoent(segmentID));
-      rightRadiusRatio = pow(1.0 + radiusRatioPowerBifurcationExpoent,
-                             -1.0 / bifurcationExpoent(segmentID));
-
-      _segments[segmentID].setBifurcationRatioLeft(leftRadiusRatio);
-      _segments[segmentID].setBifurcationRatioRight(rightRadiusRatio);
-
-      Rtemp = pow(leftRadiusRatio, 4.0) / leftReducedHydrodynamicResistance +
-              pow(rightRadiusRatio, 4.0) / rightReducedHydrodynamicResistance;
-      _reducedHydrodynamicResistance[segmentID] =
-          _poiseuilleLawConstant * bloodViscosity(segmentID) *
-              length(segmentID) +
-          1.0 / Rtemp;
-    }
-
-    segmentID = _segments[segmentID].up();
+    updateSegment(segmentID);
+    notify(segmentID);
+    segmentID = _nodes[segmentID].up;
   } while (segmentID != _TERMINALEND);
-}
 
-bool Tree::isRoot(int segmentID) { return segmentID == _rootID; }
-
-bool Tree::isTerminal(int segmentID) {
-  return (_segments[segmentID].left() == _TERMINALEND &&
-          _segments[segmentID].right() == _TERMINALEND);
+  /* The bifurcation ratios changed up to the root, so every radius changed. */
+  changeRadii();
 }
 
-Point Tree::proximalPoint(int segmentID) {
-  int parentID;
-  if (isRoot(segmentID)) {
-    return seed();
-  } else {
-    parentID = _segments[segmentID].up();
-    return _segments[parentID].point();
+void Tree::updateSegment(int segmentID) {
+  int connectionID, _newID;
+  double connectionFlow, newFlow, flowRatio, leftReducedHydrodynamicResistance,
+      rightReducedHydrodynamicResistance, reducedHydrodynamicResistanceRatio,
+      radiusRatio, Rtemp, radiusRatioPowerBifurcationExpoent, leftRadiusRatio,
+      rightRadiusRatio, expoent;
+
+  if (isTerminal(segmentID)) {
+    _nodes[segmentID].reducedHydrodynamicResistance =
+        _poiseuilleLawConstant * bloodViscosity(segmentID) * length(segmentID);
+    setBifurcationRatios(segmentID, 1.0, 1.0);
+    return;
   }
+
+  connectionID = _nodes[segmentID].left;
+  _newID = _nodes[segmentID].right;
+
+  connectionFlow = _nodes[connectionID].flow;
+  newFlow = _nodes[_newID].flow;
+  setFlow(segmentID, connectionFlow + newFlow);
+  flowRatio = connectionFlow / newFlow;
+
+  leftReducedHydrodynamicResistance =
+      reducedHydrodynamicResistance(connectionID);
+  rightReducedHydrodynamicResistance = reducedHydrodynamicResistance(_newID);
+  reducedHydrodynamicResistanceRatio =
+      leftReducedHydrodynamicResistance / rightReducedHydrodynamicResistance;
+
+  radiusRatio = pow(flowRatio * reducedHydrodynamicResistanceRatio, 0.25);
+  expoent = bifurcationExpoent(_nodes[segmentID].level);
+  radiusRatioPowerBifurcationExpoent = pow(radiusRatio, expoent);
+  leftRadiusRatio =
+      pow(1.0 + 1.0 / radiusRatioPowerBifurcationExpoent, -1.0 / expoent);
+  rightRadiusRatio =
+      pow(1.0 + radiusRatioPowerBifurcationExpoent, -1.0 / expoent);
+
+  setBifurcationRatios(segmentID, leftRadiusRatio, rightRadiusRatio);
+
+  Rtemp = pow(leftRadiusRatio, 4.0) / leftReducedHydrodynamicResistance +
+          pow(rightRadiusRatio, 4.0) / rightReducedHydrodynamicResistance;
+  _nodes[segmentID].reducedHydrodynamicResistance =
+      _poiseuilleLawConstant * bloodViscosity(segmentID) * length(segmentID) +
+      1.0 / Rtemp;
 }
 
-Point Tree::distalPoint(int segmentID) { return _segments[segmentID].point(); }
+double Tree::flow() { return _nodes[_rootID].flow; }
 
-double Tree::flow() { return _segments[_rootID].flow(); }
+int Tree::nearestSegments(Point point, int numberOfSegments, int *segmentIDs,
+                          double *distances) {
+  updateSegmentIndex();
+  return _segmentIndex->nearest(point, numberOfSegments, segmentIDs,
+                                distances);
+}
+
+int Tree::nearbySegments(Point pointA, Point pointB, double distance,
+                         int *segmentIDs) {
+  updateSegmentIndex();
+  return _segmentIndex->overlap(pointA, pointB, distance, segmentIDs);
+}
 
 void Tree::print() {
   int i;
@@ -432,3 +880,13 @@ void Tree::print() {
 
   cout << "---" << endl;
 }
+
+const double *Tree::distalCoordinates() { return _distalCoordinates; }
+
+const double *Tree::proximalCoordinates() { return _proximalCoordinates; }
+
+const SegmentNode *Tree::nodes() { return _nodes; }
+
+void Tree::setHugePages(bool value) { _hugePages = value; }
+
+bool Tree::hugePages() { return _hugePages; }
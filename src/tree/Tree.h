@@ -28,30 +28,59 @@
  */
 #include "ConstantBifurcationExpoent.h"
 #include "ConstantBloodViscosity.h"
+#include "SegmentNode.h"
+#include "geometry/BoundingVolumeHierarchy.h"
 #include "geometry/Geometry.h"
 #include "interface/TreeModel.h"
 
 #ifndef _CCOLAB_TREE_TREE_H
 #define _CCOLAB_TREE_TREE_H
-class Tree : public TreeModel {
+/**
+ * @brief The tree of segments.
+ *
+ * The class is final, so the calls through a Tree pointer (and inside the
+ * tree) are bound at compile time. The getters used in the inner loops are
+ * defined here to be inlined, and they read the segment arrays without
+ * copying segments.
+ */
+class Tree final : public TreeModel {
  private:
   /**
-   * @brief Vector of segments on the tree.
+   * @brief Vector of the fields of the segments read and written together
+   * (one cache line per segment).
    *
    */
-  Segment *_segments;
+  SegmentNode *_nodes;
+
+  /**
+   * @brief Vector of the distal point coordinates (3 per segment, the z
+   * coordinate is zero in 2D).
+   *
+   */
+  double *_distalCoordinates;
 
   /**
-   * @brief Vector of the reduced hydrodynamic resistance.
+   * @brief Vector of the proximal point coordinates (3 per segment). They
+   * are the distal coordinates of the parent, or the seed for the root.
    *
    */
-  double *_reducedHydrodynamicResistance;
+  double *_proximalCoordinates;
 
   /**
-   * @brief Vector of the segments length.
+   * @brief Vector of the segment records returned by segment(), root(),
+   * parent(), left() and right().
+   *
+   * The records mirror the nodes and the coordinates, and only those
+   * accessors read them.
+   *
+   */
+  Segment *_segments;
+
+  /**
+   * @brief Flag if the large vectors are advised to use huge pages.
    *
    */
-  double *_length;
+  static bool _hugePages;
 
   /**
    * @brief Geometry object to do some geometric calculations.
@@ -65,6 +94,249 @@ class Tree : public TreeModel {
    */
   int _currentNumberOfTerminals = 0;
 
+  /**
+   * @brief Spatial index of the segments.
+   *
+   */
+  BoundingVolumeHierarchy *_segmentIndex;
+
+  /**
+   * @brief The segments changed since the last update of the spatial index.
+   *
+   */
+  int *_modifiedSegments;
+
+  /**
+   * @brief Flag the segments changed since the last update of the spatial
+   * index.
+   *
+   */
+  bool *_isModified;
+
+  /**
+   * @brief The number of segments changed since the last update of the
+   * spatial index.
+   *
+   */
+  int _numberOfModifiedSegments = 0;
+
+  /**
+   * @brief The version of the tree when each radius ratio was evaluated
+   * (the ratios are on the nodes).
+   *
+   */
+  long *_radiusRatioVersion;
+
+  /**
+   * @brief The segments waiting to have their radius ratio evaluated.
+   *
+   */
+  int *_radiusRatioPath;
+
+  /**
+   * @brief The Strahler order of each segment, kept up to date as the tree
+   * grows (the levels are on the nodes).
+   *
+   */
+  int *_strahlerOrder;
+
+  /**
+   * @brief The segments in depth-first order, and the stack of the
+   * depth-first search (allocated by the first reorder()).
+   *
+   */
+  int *_order = nullptr;
+
+  /**
+   * @brief The new index of each segment on reorder().
+   *
+   */
+  int *_newIDs = nullptr;
+
+  /**
+   * @brief Flag if each record was already moved on reorder().
+   *
+   */
+  bool *_isReordered = nullptr;
+
+  /**
+   * @brief The radius of the root segment.
+   *
+   */
+  double _rootRadius;
+
+  /**
+   * @brief The version of the tree when the root radius was evaluated.
+   *
+   */
+  long _rootRadiusVersion = -1;
+
+  /**
+   * @brief The version of the tree. It changes every time the radii change.
+   *
+   */
+  long _version = 0;
+
+  /**
+   * @brief The observers notified when the segments change.
+   *
+   */
+  TreeObserver **_observers = nullptr;
+
+  /**
+   * @brief The number of observers.
+   *
+   */
+  int _numberOfObservers = 0;
+
+  /**
+   * @brief Notify the observers that the segment changed.
+   *
+   * @param segmentID The index of the segment.
+   */
+  void notify(int segmentID);
+
+  /**
+   * @brief Allocate the segment records and the arrays of the segments.
+   *
+   */
+  void allocateSegments();
+
+  /**
+   * @brief Set the distal point of the segment (and the proximal point of
+   * its descendents).
+   *
+   * @param segmentID The index of the segment.
+   * @param point The distal point.
+   */
+  void setDistalPoint(int segmentID, Point point);
+
+  /**
+   * @brief Set the blood flow passing through the segment.
+   *
+   * @param segmentID The index of the segment.
+   * @param value The blood flow.
+   */
+  void setFlow(int segmentID, double value);
+
+  /**
+   * @brief Set the bifurcation ratios of the segment.
+   *
+   * @param segmentID The index of the segment.
+   * @param left The left bifurcation ratio.
+   * @param right The right bifurcation ratio.
+   */
+  void setBifurcationRatios(int segmentID, double left, double right);
+
+  /**
+   * @brief Set the ascendent segment (and the proximal point of the segment).
+   *
+   * @param segmentID The index of the segment.
+   * @param upID The index of the ascendent segment.
+   */
+  void setUp(int segmentID, int upID);
+
+  /**
+   * @brief Set the descendent segments.
+   *
+   * @param segmentID The index of the segment.
+   * @param leftID The index of the left descendent segment.
+   * @param rightID The index of the right descendent segment.
+   */
+  void setDescendents(int segmentID, int leftID, int rightID);
+
+  /**
+   * @brief Add a value to the level of the segment and of its descendents.
+   *
+   * The subtree is visited without a stack, climbing through the links to
+   * the ascendents.
+   *
+   * @param segmentID The index of the segment.
+   * @param value The value.
+   * @return If the bifurcation expoent of a bifurcation in the subtree
+   * changed (never with a constant law), so its ratios must be evaluated
+   * again with updateSubtree().
+   */
+  bool shiftLevels(int segmentID, int value);
+
+  /**
+   * @brief Evaluate again the radii bifurcation ratios, the flow and the
+   * reduced hydrodynamic resistance of the segment from its descendents.
+   *
+   * @param segmentID The index of the segment.
+   */
+  void updateSegment(int segmentID);
+
+  /**
+   * @brief Evaluate again every bifurcation of the subtree of the segment,
+   * the descendents before their ascendents.
+   *
+   * The ascendents of the segment are not evaluated, update() does it.
+   *
+   * @param segmentID The index of the segment.
+   */
+  void updateSubtree(int segmentID);
+
+  /**
+   * @brief Evaluate again the Strahler order of the segment from its
+   * descendents, and of its ascendents up to the first one not changed.
+   *
+   * @param segmentID The index of the segment.
+   */
+  void updateStrahlerOrders(int segmentID);
+
+  /**
+   * @brief Allocate the spatial index of the segments.
+   *
+   */
+  void allocateSegmentIndex();
+
+  /**
+   * @brief Flag the segment as changed (moved, grown or removed).
+   *
+   * The spatial index is only updated when it is queried, so the many
+   * moves done by the optimization of a bifurcation cost nothing there.
+   *
+   * @param segmentID The index of the segment.
+   */
+  void modify(int segmentID);
+
+  /**
+   * @brief Update the spatial index with the changed segments.
+   *
+   */
+  void updateSegmentIndex();
+
+  /**
+   * @brief Allocate the radius ratios of the segments.
+   *
+   */
+  void allocateRadiusRatio();
+
+  /**
+   * @brief Flag all the radii as outdated.
+   *
+   */
+  void changeRadii() { _version++; }
+
+  /**
+   * @brief Get the radius ratio between the segment and the root.
+   *
+   * The outdated ratios are evaluated from the closest updated ancestor down
+   * to the segment, so evaluating the ratio of all segments costs O(N).
+   *
+   * @param segmentID The index of the segment.
+   * @return The radius ratio between the segment and the root.
+   */
+  double radiusRatio(int segmentID);
+
+  /**
+   * @brief Get the radius of the root segment.
+   *
+   * @return The radius of the root segment.
+   */
+  double rootRadius();
+
  public:
   /**
    * @brief Construct a new Tree object.
@@ -111,14 +383,14 @@ class Tree : public TreeModel {
    *
    * @return The index of the first segment on the tree.
    */
-  virtual int begin();
+  virtual int begin() { return _rootID; }
 
   /**
    * @brief Get the index of the last segment on the tree.
    *
    * @return The index of the last segment on the tree.
    */
-  virtual int end();
+  virtual int end() { return currentNumberOfSegments(); }
 
   /**
    * @brief Get the root segment.
@@ -159,6 +431,30 @@ class Tree : public TreeModel {
    */
   virtual Segment *segment(int segmentID);
 
+  /**
+   * @brief Get the index of the parent (ie, ascendent) segment.
+   *
+   * @param segmentID The index of the segment.
+   * @return The index of the parent segment (_TERMINALEND for the root).
+   */
+  virtual int parentID(int segmentID) { return _nodes[segmentID].up; }
+
+  /**
+   * @brief Get the index of the left descendent segment.
+   *
+   * @param segmentID The index of the segment.
+   * @return The index of the left segment (_TERMINALEND for a terminal).
+   */
+  virtual int leftID(int segmentID) { return _nodes[segmentID].left; }
+
+  /**
+   * @brief Get the index of the right descendent segment.
+   *
+   * @param segmentID The index of the segment.
+   * @return The index of the right segment (_TERMINALEND for a terminal).
+   */
+  virtual int rightID(int segmentID) { return _nodes[segmentID].right; }
+
   /**
    * @brief Move the distal point of the segment.
    *
@@ -174,7 +470,9 @@ class Tree : public TreeModel {
    * @param segmentID The index of the segment.
    * @return The length of the segment.
    */
-  virtual double length(int segmentID);
+  virtual double length(int segmentID) {
+    return (TreeModel::lengthUnit()) * _nodes[segmentID].length;
+  }
 
   /**
    * @brief Get the radius of the segment.
@@ -191,6 +489,34 @@ class Tree : public TreeModel {
    */
   virtual double volume();
 
+  /**
+   * @brief Set the unit of the metric system used to represent the radius.
+   *
+   * @param value The unit of the metric system used to represent the radius.
+   */
+  virtual void setRadiusUnit(double value);
+
+  /**
+   * @brief Set the perfusion pressure.
+   *
+   * @param value The perfusion pressure.
+   */
+  virtual void setPerfusionPressure(double value);
+
+  /**
+   * @brief Set the terminal pressure.
+   *
+   * @param value The terminal pressure.
+   */
+  virtual void setTerminalPressure(double value);
+
+  /**
+   * @brief Set the perfusion flow.
+   *
+   * @param value The perfusion flow.
+   */
+  virtual void setPerfusionFlow(double value);
+
   /**
    * @brief Get the reduced hydrodynamic resistance of the tree begining at
    * the given segment.
@@ -199,23 +525,29 @@ class Tree : public TreeModel {
    * @return the reduced hydrodynamic resistance of the tree begining at
    * the given segment.
    */
-  virtual double reducedHydrodynamicResistance(int segmentID);
+  virtual double reducedHydrodynamicResistance(int segmentID) {
+    return _nodes[segmentID].reducedHydrodynamicResistance;
+  }
 
   /**
-   * @brief Get the bifurcation level of the segment.
+   * @brief Get the bifurcation level of the segment (kept up to date by
+   * growSegment() and remove()).
    *
    * @param segmentID The index of the segment.
    * @return The bifurcation level of the segment.
    */
-  virtual int level(int segmentID);
+  virtual int level(int segmentID) { return _nodes[segmentID].level; }
 
   /**
-   * @brief Get the Strahler order of the segment.
+   * @brief Get the Strahler order of the segment (kept up to date by
+   * growSegment() and remove()).
    *
    * @param segmentID The index of the segment.
    * @return The Strahler order of the segment.
    */
-  virtual int strahlerOrder(int segmentID);
+  virtual int strahlerOrder(int segmentID) {
+    return _strahlerOrder[segmentID];
+  }
 
   /**
    * @brief Grow the root segment.
@@ -270,7 +602,7 @@ class Tree : public TreeModel {
    * otherwise.
    *
    */
-  virtual bool isRoot(int segmentID);
+  virtual bool isRoot(int segmentID) { return segmentID == _rootID; }
 
   /**
    * @brief Check if a segment is a terminal segment.
@@ -280,7 +612,10 @@ class Tree : public TreeModel {
    * otherwise.
    *
    */
-  virtual bool isTerminal(int segmentID);
+  virtual bool isTerminal(int segmentID) {
+    return (_nodes[segmentID].left == _TERMINALEND &&
+            _nodes[segmentID].right == _TERMINALEND);
+  }
 
   /**
    * @brief Get the proximal point of the given segment.
@@ -288,7 +623,9 @@ class Tree : public TreeModel {
    * @param segmentID The index of the segment.
    * @return The proximal point of the given segment.
    */
-  virtual Point proximalPoint(int segmentID);
+  virtual Point proximalPoint(int segmentID) {
+    return Point(&_proximalCoordinates[3 * segmentID], dimension());
+  }
 
   /**
    * @brief Get the distal point of the given segment.
@@ -296,7 +633,82 @@ class Tree : public TreeModel {
    * @param segmentID The index of the segment.
    * @return The distal point of the given segment.
    */
-  virtual Point distalPoint(int segmentID);
+  virtual Point distalPoint(int segmentID) {
+    return Point(&_distalCoordinates[3 * segmentID], dimension());
+  }
+
+  /**
+   * @brief Find the segments closest to the point.
+   *
+   * The segments are sorted by the critic distance from the point and the
+   * ties are sorted by the segment index.
+   *
+   * @param point The point.
+   * @param numberOfSegments The maximum number of segments to find.
+   * @param segmentIDs The closest segments (at least numberOfSegments
+   * positions).
+   * @param distances The distance of the closest segments (at least
+   * numberOfSegments positions).
+   * @return The number of segments found.
+   */
+  virtual int nearestSegments(Point point, int numberOfSegments,
+                              int *segmentIDs, double *distances);
+
+  /**
+   * @brief Find the segments that may be closer than the distance from the
+   * segment AB.
+   *
+   * Every segment closer than the distance is found, but some farther
+   * segments may be found too.
+   *
+   * @param pointA The proximal point of the segment AB.
+   * @param pointB The distal point of the segment AB.
+   * @param distance The distance.
+   * @param segmentIDs The segments found (at least totalNumberOfSegments
+   * positions).
+   * @return The number of segments found.
+   */
+  virtual int nearbySegments(Point pointA, Point pointB, double distance,
+                             int *segmentIDs);
+
+  /**
+   * @brief Attach the observer to be notified when the segments change.
+   *
+   * @param observer The observer.
+   */
+  virtual void attach(TreeObserver *observer);
+
+  /**
+   * @brief Detach the observer (nothing happens if it is not attached).
+   *
+   * @param observer The observer.
+   */
+  virtual void detach(TreeObserver *observer);
+
+  /**
+   * @brief Evaluate now the radius ratios, the root radius and the segment
+   * index, so the getters only read the tree until it changes again.
+   *
+   */
+  virtual void refresh();
+
+  /**
+   * @brief Renumber the segments in depth-first order (the root, the left
+   * subtree and then the right subtree).
+   *
+   * The segments are numbered in the order they are grown, so a parent is
+   * usually far from its children in memory. After the renumbering, each
+   * parent is followed by its left child and the walks down the tree read
+   * the memory sequentially. The links, the spatial index and the observers
+   * are updated (every segment is notified), and no value changes. The
+   * indices of the segments held by other objects are invalid afterwards.
+   *
+   * The candidate connections are visited and their ties broken in index
+   * order, so a tree renumbered while it grows may end up different from the
+   * one grown without renumbering.
+   *
+   */
+  virtual void reorder();
 
   /**
    * @brief Get the flow passing through the root segment.
@@ -311,5 +723,63 @@ class Tree : public TreeModel {
    */
   virtual void print();
   void setSeed(double *value);
+
+  /**
+   * @brief Set the seed of the tree (the proximal point of the root).
+   *
+   * @param point The seed of the tree.
+   */
+  virtual void setSeed(Point point);
+
+  /**
+   * @brief Get the distal point coordinates of the segments, 3 per segment
+   * from begin() to end() (the z coordinate is zero in 2D).
+   *
+   * The vectors below let the loops over the segments read only the fields
+   * they need. They are valid until the tree is destroyed, and their values
+   * change with the tree.
+   *
+   * @return The distal point coordinates.
+   */
+  const double *distalCoordinates();
+
+  /**
+   * @brief Get the proximal point coordinates of the segments, 3 per
+   * segment.
+   *
+   * @return The proximal point coordinates.
+   */
+  const double *proximalCoordinates();
+
+  /**
+   * @brief Get the nodes of the segments, with the flows, the reduced
+   * hydrodynamic resistances, the lengths (without the length unit), the
+   * bifurcation ratios and the links.
+   *
+   * @return The nodes.
+   */
+  const SegmentNode *nodes();
+
+  /**
+   * @brief Set if the vectors of the trees created from now on are advised
+   * to use huge pages (the default).
+   *
+   * Only the vectors of at least one huge page (2 MB, about 32768 segments
+   * for the nodes) are advised, so small trees are not affected. The advice
+   * reduces the TLB misses on trees with millions of segments. It is only
+   * given on Linux.
+   *
+   * @param value Flag if the huge pages are used.
+   */
+  static void setHugePages(bool value);
+
+  /**
+   * @brief Check if the vectors of the new trees are advised to use huge
+   * pages.
+   *
+   * @return Returns true if the huge pages are used. Returns false
+   * otherwise.
+   */
+  static bool hugePages();
 };
 #endif
@@ -0,0 +1,140 @@
+/**
+ * @file TreeChangeLog.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "TreeChangeLog.h"
+
+#include <algorithm>
+
+TreeChangeLog::TreeChangeLog(TreeModel *tree) {
+  int i;
+  _tree = tree;
+  _capacity = tree->totalNumberOfSegments();
+
+  /**
+   *  Allocate all vectors once. It speed up the code because later it wont
+   *  need to create/destroy objects as the tree grows.
+   * */
+  _isLogged = new bool[_capacity];
+  _proximalPoint = new Point[_capacity];
+  _distalPoint = new Point[_capacity];
+  _modifiedSegments = new int[_capacity];
+  _isModified = new bool[_capacity];
+  for (i = 0; i < _capacity; i++) {
+    _isLogged[i] = false;
+    _isModified[i] = false;
+  }
+
+  _end = _tree->end();
+  for (i = _tree->begin(); i < _end; i++) {
+    _isLogged[i] = true;
+    _proximalPoint[i] = _tree->proximalPoint(i);
+    _distalPoint[i] = _tree->distalPoint(i);
+  }
+
+  _tree->attach(this);
+}
+
+TreeChangeLog::~TreeChangeLog() {
+  _tree->detach(this);
+  delete[] _isLogged;
+  delete[] _proximalPoint;
+  delete[] _distalPoint;
+  delete[] _modifiedSegments;
+  delete[] _isModified;
+}
+
+TreeModel *TreeChangeLog::tree() { return _tree; }
+
+int TreeChangeLog::capacity() { return _capacity; }
+
+void TreeChangeLog::changed(int segmentID) {
+  if (segmentID < _capacity && !_isModified[segmentID]) {
+    _isModified[segmentID] = true;
+    _modifiedSegments[_numberOfModifiedSegments++] = segmentID;
+  }
+}
+
+void TreeChangeLog::log(int segmentID, int end, int *segmentIDs,
+                        bool *wasLogged, Point *proximalPoints,
+                        Point *distalPoints, int *numberOfSegments) {
+  Point proximalPoint, distalPoint;
+
+  if (segmentID < end) {
+    /* Most segments changed only their flow or radius. */
+    proximalPoint = _tree->proximalPoint(segmentID);
+    distalPoint = _tree->distalPoint(segmentID);
+    if (_isLogged[segmentID] &&
+        proximalPoint.x() == _proximalPoint[segmentID].x() &&
+        proximalPoint.y() == _proximalPoint[segmentID].y() &&
+        proximalPoint.z() == _proximalPoint[segmentID].z() &&
+        distalPoint.x() == _distalPoint[segmentID].x() &&
+        distalPoint.y() == _distalPoint[segmentID].y() &&
+        distalPoint.z() == _distalPoint[segmentID].z()) {
+      return;
+    }
+  } else if (!_isLogged[segmentID]) {
+    return;
+  }
+
+  segmentIDs[*numberOfSegments] = segmentID;
+  wasLogged[*numberOfSegments] = _isLogged[segmentID];
+  proximalPoints[*numberOfSegments] = _proximalPoint[segmentID];
+  distalPoints[*numberOfSegments] = _distalPoint[segmentID];
+  (*numberOfSegments)++;
+
+  _isLogged[segmentID] = segmentID < end;
+  if (segmentID < end) {
+    _proximalPoint[segmentID] = proximalPoint;
+    _distalPoint[segmentID] = distalPoint;
+  }
+}
+
+int TreeChangeLog::update(int *segmentIDs, bool *wasLogged,
+                          Point *proximalPoints, Point *distalPoints) {
+  int i, numberOfSegments = 0, end = _tree->end();
+
+  for (i = 0; i < _numberOfModifiedSegments; i++) {
+    _isModified[_modifiedSegments[i]] = false;
+    log(_modifiedSegments[i], end, segmentIDs, wasLogged, proximalPoints,
+        distalPoints, &numberOfSegments);
+  }
+  _numberOfModifiedSegments = 0;
+
+  /* The segments removed or added without notification. */
+  for (i = end; i < _end; i++) {
+    log(i, end, segmentIDs, wasLogged, proximalPoints, distalPoints,
+        &numberOfSegments);
+  }
+  for (i = std::max(_tree->begin(), _end); i < end; i++) {
+    log(i, end, segmentIDs, wasLogged, proximalPoints, distalPoints,
+        &numberOfSegments);
+  }
+  _end = end;
+
+  return numberOfSegments;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file TreeChangeLog.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "geometry/Point.h"
+#include "interface/TreeModel.h"
+#include "interface/TreeObserver.h"
+
+#ifndef _CCOLAB_TREE_TREECHANGELOG_H
+#define _CCOLAB_TREE_TREECHANGELOG_H
+/**
+ * @brief Log of the segments whose endpoints changed.
+ *
+ * The log observes the tree and keeps the endpoints of each segment as they
+ * were on the last update. Most notifications change only the flow or the
+ * radius of the segments, so they are filtered out by comparing the
+ * endpoints.
+ */
+class TreeChangeLog : public TreeObserver {
+ private:
+  /**
+   * @brief The tree.
+   *
+   */
+  TreeModel *_tree;
+
+  /**
+   * @brief The maximum number of segments.
+   *
+   */
+  int _capacity;
+
+  /**
+   * @brief Flag if the endpoints of each segment are logged.
+   *
+   */
+  bool *_isLogged;
+
+  /**
+   * @brief The logged proximal point of each segment.
+   *
+   */
+  Point *_proximalPoint;
+
+  /**
+   * @brief The logged distal point of each segment.
+   *
+   */
+  Point *_distalPoint;
+
+  /**
+   * @brief The segments notified since the last update.
+   *
+   */
+  int *_modifiedSegments;
+
+  /**
+   * @brief Flag if each segment was notified since the last update.
+   *
+   */
+  bool *_isModified;
+
+  /**
+   * @brief The number of segments notified since the last update.
+   *
+   */
+  int _numberOfModifiedSegments = 0;
+
+  /**
+   * @brief The end of the tree segments on the last update.
+   *
+   */
+  int _end = 0;
+
+  /**
+   * @brief Log the current endpoints of the segment, and report it if they
+   * changed.
+   *
+   * @param segmentID The segment index.
+   * @param end The end of the tree segments.
+   * @param segmentIDs The reported segments.
+   * @param wasLogged Flag if each reported segment was logged.
+   * @param proximalPoints The logged proximal point of each reported segment.
+   * @param distalPoints The logged distal point of each reported segment.
+   * @param numberOfSegments The number of reported segments.
+   */
+  void log(int segmentID, int end, int *segmentIDs, bool *wasLogged,
+           Point *proximalPoints, Point *distalPoints, int *numberOfSegments);
+
+ public:
+  /**
+   * @brief Construct a new Tree Change Log object attached to the tree. The
+   * current segments are logged.
+   *
+   * @param tree The tree.
+   */
+  explicit TreeChangeLog(TreeModel *tree);
+
+  /**
+   * @brief Destroy the Tree Change Log object (it is detached from the
+   * tree).
+   *
+   */
+  ~TreeChangeLog();
+
+  /**
+   * @brief Get the tree.
+   *
+   * @return The tree.
+   */
+  TreeModel *tree();
+
+  /**
+   * @brief Get the maximum number of segments.
+   *
+   * @return The maximum number of segments.
+   */
+  int capacity();
+
+  /**
+   * @brief Notify that the segment changed.
+   *
+   * @param segmentID The index of the segment.
+   */
+  virtual void changed(int segmentID);
+
+  /**
+   * @brief Get the segments added, moved or removed since the last update,
+   * with the endpoints they had then, and log their current endpoints.
+   *
+   * A reported segment was removed if its index is not less than the tree
+   * end, and it was added if it was not logged. Each vector must have room
+   * for capacity() segments.
+   *
+   * @param segmentIDs The reported segments.
+   * @param wasLogged Flag if each reported segment was logged.
+   * @param proximalPoints The logged proximal point of each reported segment.
+   * @param distalPoints The logged distal point of each reported segment.
+   * @return The number of reported segments.
+   */
+  int update(int *segmentIDs, bool *wasLogged, Point *proximalPoints,
+             Point *distalPoints);
+};
+#endif //_CCOLAB_TREE_TREECHANGELOG_H
@@ -31,26 +31,19 @@
 #include <iostream>
 #include <string>
 
-#include "geometry/Geometry.h"
 using std::cout;
 using std::endl;
 
-TreeConnectionSearch::TreeConnectionSearch(int numberOfConnections,
-                                           int totalNumberOfSegments,
-                                           int dimension) {
+TreeConnectionSearch::TreeConnectionSearch(int numberOfConnections) {
   _numberOfConnections = numberOfConnections;
   _currentNumberOfConnections = 0;
-  _currentNumberOfSegments = 0;
 
   /**
    *  Allocate all vectors once. It speed up the code because later it wont
    *  need to create/destroy objects as the tree grows.
    * */
-  _segmentDistance = new double[totalNumberOfSegments];
-  _segmentID = new int[totalNumberOfSegments];
+  _segmentDistance = new double[_numberOfConnections];
   _closestSegments = new int[_numberOfConnections];
-
-  _geometry = new Geometry(dimension);
 }
 
 TreeConnectionSearch::TreeConnectionSearch(TreeModel *tree,
@@ -58,23 +51,18 @@ TreeConnectionSearch::TreeConnectionSearch(TreeModel *tree,
   _tree = tree;
   _numberOfConnections = numberOfConnections;
   _currentNumberOfConnections = 0;
-  _currentNumberOfSegments = 0;
 
   /**
    *  Allocate all vectors once. It speed up the code because later it wont
    *  need to create/destroy objects as the tree grows.
    * */
-  _segmentDistance = new double[_tree->totalNumberOfSegments()];
-  _segmentID = new int[_tree->totalNumberOfSegments()];
+  _segmentDistance = new double[_numberOfConnections];
   _closestSegments = new int[_numberOfConnections];
-
-  _geometry = new Geometry(_tree->dimension());
 }
 
 TreeConnectionSearch::~TreeConnectionSearch() {
-  // delete[] _segmentDistance;
-  // delete[] _segmentID;
-  // delete[] _closestSegments;
+  delete[] _segmentDistance;
+  delete[] _closestSegments;
 }
 
 void TreeConnectionSearch::setTree(TreeModel *tree) { _tree = tree; }
@@ -86,52 +74,12 @@ int TreeConnectionSearch::currentNumberOfConnections() {
 }
 
 int *TreeConnectionSearch::atPoint(Point point) {
-  int i, j, k, oldSegmentID;
-  double d, oldDistance;
-  _currentNumberOfSegments = 0;
-
-  /* Compute the distance of the point from each segment. */
-  for (i = _tree->begin(); i < _tree->end(); i++) {
-    d = _geometry->distanceFromSegment(point, _tree->proximalPoint(i),
-                                       _tree->distalPoint(i));
-    _segmentDistance[_currentNumberOfSegments] = d;
-    _segmentID[_currentNumberOfSegments] = i;
-    _currentNumberOfSegments++;
-  }
-
-  /* Sort the computed distances. */
-  sort();
-
-  /* Get the closest segments */
-  _currentNumberOfConnections = _currentNumberOfSegments < _numberOfConnections
-                                    ? _currentNumberOfSegments
-                                    : _numberOfConnections;
-
-  for (i = 0; i < _currentNumberOfConnections; i++) {
-    _closestSegments[i] = _segmentID[i];
-  }
+  /**
+   *  The tree spatial index gives the closest segments sorted by distance
+   *  (ties sorted by segment index), without scanning the whole tree.
+   */
+  _currentNumberOfConnections = _tree->nearestSegments(
+      point, _numberOfConnections, _closestSegments, _segmentDistance);
 
   return _closestSegments;
 }
-
-void TreeConnectionSearch::sort() {
-  /* Bubble sort */
-  int i, oldSegmentID;
-  bool swap;
-  double oldDistance;
-
-  do {
-    swap = false;
-    for (i = 0; i < _currentNumberOfSegments - 1; i++) {
-      if (_segmentDistance[i] > _segmentDistance[i + 1]) {
-        oldDistance = _segmentDistance[i];
-        oldSegmentID = _segmentID[i];
-        _segmentDistance[i] = _segmentDistance[i + 1];
-        _segmentID[i] = _segmentID[i + 1];
-        _segmentDistance[i + 1] = oldDistance;
-        _segmentID[i + 1] = oldSegmentID;
-        swap = true;
-      }
-    }
-  } while (swap);
-}
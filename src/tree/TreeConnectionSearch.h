@@ -26,7 +26,6 @@
  * @version 1.0
  * @date 2022-05-18
  */
-#include "geometry/Geometry.h"
 #include "interface/TreeModel.h"
 
 #ifndef _CCOLAB_TREE_TREECONNECTIONSEARCH_H
@@ -36,16 +35,11 @@ class TreeConnectionSearch {
   TreeModel *_tree;
   int _numberOfConnections;
   int _currentNumberOfConnections;
-  int _currentNumberOfSegments;
   double *_segmentDistance;
-  int *_segmentID;
   int *_closestSegments;
-  Geometry *_geometry;
-  void sort();
 
  public:
-  TreeConnectionSearch(int numberOfConnections, int totalNumberOfSegments,
-                       int dimension);
+  explicit TreeConnectionSearch(int numberOfConnections);
   TreeConnectionSearch(TreeModel *tree, int numberOfConnections);
   ~TreeConnectionSearch();
   void setTree(TreeModel *tree);
@@ -35,13 +35,37 @@ TreeModel *TreeFile::tree() { return _tree; }
 void TreeFile::setTree(TreeModel *tree) { _tree = tree; }
 
 void TreeFile::save(string filename) {
-  int i;
+  int i, segmentID, stackSize = 0;
   ofstream treefile;
   Segment *segment;
   int numberOfSegments = _tree->currentNumberOfSegments();
   Point seed = _tree->seed();
   double lengthUnit = _tree->lengthUnit();
   double z = _tree->dimension() == 2 ? 0.0 : seed.z();
+  vector<int> order(numberOfSegments), newIDs(_tree->end());
+
+  /**
+   *  Write the segments in depth-first order (the root, the left subtree and
+   *  then the right subtree) through a permutation, so the tree and the
+   *  indices held by other objects are not changed. The segments not
+   *  numbered yet are on the stack, kept on newIDs.
+   **/
+  if (numberOfSegments > 0) {
+    newIDs[stackSize++] = _tree->rootID();
+  }
+  for (i = 0; i < numberOfSegments; i++) {
+    segmentID = newIDs[--stackSize];
+    order[i] = segmentID;
+    if (!_tree->isTerminal(segmentID)) {
+      segment = _tree->segment(segmentID);
+      newIDs[stackSize++] = segment->right();
+      newIDs[stackSize++] = segment->left();
+    }
+  }
+  for (i = 0; i < numberOfSegments; i++) {
+    newIDs[order[i]] = i;
+  }
+
   treefile.open(filename);
   if (treefile.is_open()) {
     treefile << "# vtk DataFile Version 3.0" << endl;
@@ -51,8 +75,8 @@ void TreeFile::save(string filename) {
     treefile << "POINTS " << numberOfSegments + 1 << " double" << endl;
     treefile << lengthUnit * seed.x() << " " << lengthUnit * seed.y() << " "
              << lengthUnit * z << endl;
-    for (i = _tree->begin(); i < _tree->end(); i++) {
-      segment = _tree->segment(i);
+    for (i = 0; i < numberOfSegments; i++) {
+      segment = _tree->segment(order[i]);
       z = _tree->dimension() == 2 ? 0.0 : segment->point().z();
       treefile << lengthUnit * segment->point().x() << " "
                << lengthUnit * segment->point().y() << " " << lengthUnit * z
@@ -62,12 +86,12 @@ void TreeFile::save(string filename) {
     treefile << "LINES " << numberOfSegments << " " << 3 * numberOfSegments
              << endl;
     treefile << "2 0 1" << endl;
-    for (i = _tree->begin(); i < _tree->end(); i++) {
-      segment = _tree->segment(i);
-      if (!_tree->isTerminal(i)) {
-        treefile << "2 " << segment->ID() + 1 << " " << segment->left() + 1
+    for (i = 0; i < numberOfSegments; i++) {
+      segment = _tree->segment(order[i]);
+      if (!_tree->isTerminal(order[i])) {
+        treefile << "2 " << i + 1 << " " << newIDs[segment->left()] + 1
                  << endl;
-        treefile << "2 " << segment->ID() + 1 << " " << segment->right() + 1
+        treefile << "2 " << i + 1 << " " << newIDs[segment->right()] + 1
                  << endl;
       }
     }
@@ -76,10 +100,10 @@ void TreeFile::save(string filename) {
     treefile << "SCALARS radius double" << endl;
     treefile << "LOOKUP_TABLE default" << endl;
     treefile << std::setprecision(numeric_limits<double>::digits10 + 1)
-             << _tree->radius(_tree->root().ID()) << endl;
-    for (i = _tree->begin(); i < _tree->end(); i++) {
-      segment = _tree->segment(i);
-      if (!_tree->isTerminal(i)) {
+             << _tree->radius(_tree->rootID()) << endl;
+    for (i = 0; i < numberOfSegments; i++) {
+      segment = _tree->segment(order[i]);
+      if (!_tree->isTerminal(order[i])) {
         treefile << std::setprecision(numeric_limits<double>::digits10)
                  << _tree->radius(segment->left()) << endl;
         treefile << std::setprecision(numeric_limits<double>::digits10)
@@ -32,12 +32,13 @@
 #include <limits>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "interface/TreeModel.h"
 
 using std::string, std::invalid_argument, std::ofstream, std::ifstream,
     std::stringstream, std::istringstream, std::cout, std::endl,
-    std::numeric_limits;
+    std::numeric_limits, std::vector;
 
 #ifndef _CCOLAB_TREE_TREEFILE_H
 #define _CCOLAB_TREE_TREEFILE_H
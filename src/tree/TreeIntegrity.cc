@@ -36,7 +36,7 @@ void TreeIntegrity::setTree(TreeModel *tree) { _tree = tree; }
 
 void TreeIntegrity::check() {
   int i, left, right;
-  double parentRadius, leftRadius, rightRadius;
+  double parentRadius, leftRadius, rightRadius, expoent;
   double pressureDrop;
   bool pass;
   Segment *parentSegment, leftSegment, rightSegment;
@@ -64,9 +64,10 @@ void TreeIntegrity::check() {
       leftRadius = _tree->radius(left);
       rightRadius = _tree->radius(right);
 
-      if (fabs(pow(parentRadius, _tree->bifurcationExpoent(i)) -
-               (pow(leftRadius, _tree->bifurcationExpoent(left)) +
-                pow(rightRadius, _tree->bifurcationExpoent(right)))) >
+      /* The radii of the bifurcation follow the expoent of the parent level. */
+      expoent = _tree->bifurcationExpoent(_tree->level(i));
+      if (fabs(pow(parentRadius, expoent) -
+               (pow(leftRadius, expoent) + pow(rightRadius, expoent))) >
           _TOLERANCE) {
         cout << "[Fail] Bifurcation Law at segment ID: " << i << endl;
         pass = false;
@@ -0,0 +1,353 @@
+/**
+ * @file TreeSegmentGrid.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "TreeSegmentGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+TreeSegmentGrid::TreeSegmentGrid(TreeModel *tree) {
+  int i;
+  _tree = tree;
+  _capacity = tree->totalNumberOfSegments();
+
+  /**
+   *  Allocate all vectors once. It speed up the code because later it wont
+   *  need to create/destroy objects as the tree grows. Only the entries grow
+   *  (by doubling), as the number of cells crossed by the segments grows.
+   * */
+  _numberOfBuckets = 64;
+  while (_numberOfBuckets < _capacity) {
+    _numberOfBuckets *= 2;
+  }
+  _bucket = new int[_numberOfBuckets];
+  _isIndexed = new bool[_capacity];
+  _proximalPoint = new double[3 * _capacity];
+  _distalPoint = new double[3 * _capacity];
+  _modifiedSegments = new int[_capacity];
+  _isModified = new bool[_capacity];
+  for (i = 0; i < _capacity; i++) {
+    _isIndexed[i] = false;
+    _isModified[i] = false;
+  }
+  _freeEntry = _NULLENTRY;
+
+  _tree->attach(this);
+}
+
+TreeSegmentGrid::~TreeSegmentGrid() {
+  _tree->detach(this);
+  delete[] _bucket;
+  delete[] _entrySegment;
+  delete[] _entryNext;
+  delete[] _isIndexed;
+  delete[] _proximalPoint;
+  delete[] _distalPoint;
+  delete[] _modifiedSegments;
+  delete[] _isModified;
+}
+
+TreeModel *TreeSegmentGrid::tree() { return _tree; }
+
+double TreeSegmentGrid::cellSize() { return _cellSize; }
+
+void TreeSegmentGrid::changed(int segmentID) {
+  if (segmentID < _capacity && !_isModified[segmentID]) {
+    _isModified[segmentID] = true;
+    _modifiedSegments[_numberOfModifiedSegments++] = segmentID;
+  }
+}
+
+int TreeSegmentGrid::bucket(long i, long j, long k) {
+  unsigned long key = static_cast<unsigned long>(i) * 73856093UL ^
+                      static_cast<unsigned long>(j) * 19349663UL ^
+                      static_cast<unsigned long>(k) * 83492791UL;
+  return static_cast<int>(key & (_numberOfBuckets - 1));
+}
+
+long TreeSegmentGrid::cell(double value) {
+  return static_cast<long>(floor(value / _cellSize));
+}
+
+void TreeSegmentGrid::link(int segmentID, bool insert) {
+  int piece, numberOfPieces, d, entry, previous, *next, *newEntrySegment,
+      *newEntryNext, newNumberOfEntries;
+  long i, j, k, lower[3], upper[3];
+  double A[3], B[3], start, end, t0, t1;
+
+  for (d = 0; d < 3; d++) {
+    A[d] = _proximalPoint[3 * segmentID + d];
+    B[d] = _distalPoint[3 * segmentID + d];
+  }
+  numberOfPieces = std::max(
+      1, static_cast<int>(ceil(GeometryKernel<3>::distance(A, B) / _cellSize)));
+
+  for (piece = 0; piece < numberOfPieces; piece++) {
+    t0 = static_cast<double>(piece) / numberOfPieces;
+    t1 = static_cast<double>(piece + 1) / numberOfPieces;
+    for (d = 0; d < 3; d++) {
+      start = A[d] + t0 * (B[d] - A[d]);
+      end = piece + 1 < numberOfPieces ? A[d] + t1 * (B[d] - A[d]) : B[d];
+      lower[d] = cell(std::min(start, end));
+      upper[d] = cell(std::max(start, end));
+    }
+
+    for (i = lower[0]; i <= upper[0]; i++) {
+      for (j = lower[1]; j <= upper[1]; j++) {
+        for (k = lower[2]; k <= upper[2]; k++) {
+          /* The segment is stored once per bucket. */
+          next = &_bucket[bucket(i, j, k)];
+          previous = _NULLENTRY;
+          for (entry = *next;
+               entry != _NULLENTRY && _entrySegment[entry] != segmentID;
+               entry = _entryNext[entry]) {
+            previous = entry;
+          }
+
+          if (insert && entry == _NULLENTRY) {
+            if (_freeEntry == _NULLENTRY) {
+              /* Double the entries and link the new ones as free. */
+              newNumberOfEntries = std::max(1024, 2 * _numberOfEntries);
+              newEntrySegment = new int[newNumberOfEntries];
+              newEntryNext = new int[newNumberOfEntries];
+              std::copy(_entrySegment, _entrySegment + _numberOfEntries,
+                        newEntrySegment);
+              std::copy(_entryNext, _entryNext + _numberOfEntries,
+                        newEntryNext);
+              for (entry = _numberOfEntries; entry < newNumberOfEntries;
+                   entry++) {
+                newEntryNext[entry] =
+                    entry + 1 < newNumberOfEntries ? entry + 1 : _NULLENTRY;
+              }
+              _freeEntry = _numberOfEntries;
+              delete[] _entrySegment;
+              delete[] _entryNext;
+              _entrySegment = newEntrySegment;
+              _entryNext = newEntryNext;
+              _numberOfEntries = newNumberOfEntries;
+            }
+            entry = _freeEntry;
+            _freeEntry = _entryNext[entry];
+            _entrySegment[entry] = segmentID;
+            _entryNext[entry] = *next;
+            *next = entry;
+            _numberOfUsedEntries++;
+          } else if (!insert && entry != _NULLENTRY) {
+            if (previous == _NULLENTRY) {
+              *next = _entryNext[entry];
+            } else {
+              _entryNext[previous] = _entryNext[entry];
+            }
+            _entryNext[entry] = _freeEntry;
+            _freeEntry = entry;
+            _numberOfUsedEntries--;
+          }
+        }
+      }
+    }
+  }
+}
+
+void TreeSegmentGrid::insert(int segmentID) {
+  int d;
+  Point proximalPoint = _tree->proximalPoint(segmentID),
+        distalPoint = _tree->distalPoint(segmentID);
+  for (d = 0; d < 3; d++) {
+    _proximalPoint[3 * segmentID + d] = proximalPoint.coordinates()[d];
+    _distalPoint[3 * segmentID + d] = distalPoint.coordinates()[d];
+  }
+  link(segmentID, true);
+  _isIndexed[segmentID] = true;
+}
+
+void TreeSegmentGrid::remove(int segmentID) {
+  link(segmentID, false);
+  _isIndexed[segmentID] = false;
+}
+
+void TreeSegmentGrid::synchronize() {
+  int i, segmentID, end = _tree->end();
+  Point proximalPoint, distalPoint;
+
+  for (i = 0; i < _numberOfModifiedSegments; i++) {
+    segmentID = _modifiedSegments[i];
+    _isModified[segmentID] = false;
+    if (segmentID < end) {
+      /* Most segments changed only their flow or radius. */
+      proximalPoint = _tree->proximalPoint(segmentID);
+      distalPoint = _tree->distalPoint(segmentID);
+      if (_isIndexed[segmentID] &&
+          proximalPoint.x() == _proximalPoint[3 * segmentID] &&
+          proximalPoint.y() == _proximalPoint[3 * segmentID + 1] &&
+          proximalPoint.z() == _proximalPoint[3 * segmentID + 2] &&
+          distalPoint.x() == _distalPoint[3 * segmentID] &&
+          distalPoint.y() == _distalPoint[3 * segmentID + 1] &&
+          distalPoint.z() == _distalPoint[3 * segmentID + 2]) {
+        continue;
+      }
+      if (_isIndexed[segmentID]) {
+        remove(segmentID);
+      }
+      insert(segmentID);
+    } else if (_isIndexed[segmentID]) {
+      remove(segmentID);
+    }
+  }
+  _numberOfModifiedSegments = 0;
+
+  /* The segments removed or added without notification. */
+  for (i = end; i < _end; i++) {
+    if (_isIndexed[i]) {
+      remove(i);
+    }
+  }
+  for (i = std::max(_tree->begin(), _end); i < end; i++) {
+    if (!_isIndexed[i]) {
+      insert(i);
+    }
+  }
+  _end = end;
+}
+
+void TreeSegmentGrid::rebuild(double cellSize, int numberOfBuckets) {
+  int i;
+
+  if (numberOfBuckets != _numberOfBuckets) {
+    delete[] _bucket;
+    _bucket = new int[numberOfBuckets];
+    _numberOfBuckets = numberOfBuckets;
+  }
+  for (i = 0; i < _numberOfBuckets; i++) {
+    _bucket[i] = _NULLENTRY;
+  }
+
+  /* Give back all the entries to the list of free entries. */
+  for (i = 0; i < _numberOfEntries; i++) {
+    _entryNext[i] = i + 1 < _numberOfEntries ? i + 1 : _NULLENTRY;
+  }
+  _freeEntry = _numberOfEntries > 0 ? 0 : _NULLENTRY;
+  _numberOfUsedEntries = 0;
+
+  for (i = 0; i < _capacity; i++) {
+    _isIndexed[i] = false;
+    _isModified[i] = false;
+  }
+  _numberOfModifiedSegments = 0;
+
+  _cellSize = cellSize;
+  _end = _tree->end();
+  for (i = _tree->begin(); i < _end; i++) {
+    insert(i);
+  }
+}
+
+void TreeSegmentGrid::prepare(double distance) {
+  /**
+   *  Keep the distance in [0.5, 0.9] times the cell size. The margin to the
+   *  cell size keeps the rounding errors of the cells from missing a segment.
+   **/
+  if (_cellSize == 0.0 || distance > 0.9 * _cellSize ||
+      distance < 0.5 * _cellSize) {
+    rebuild(_CELLFACTOR * distance, _numberOfBuckets);
+  } else {
+    synchronize();
+  }
+
+  /* Keep about two entries per bucket. */
+  if (_numberOfUsedEntries > 2 * _numberOfBuckets) {
+    rebuild(_cellSize, 2 * _numberOfBuckets);
+  }
+}
+
+double TreeSegmentGrid::batchDistance(Point point, int *segmentIDs,
+                                      int numberOfSegments) {
+  int i;
+  double distance = HUGE_VAL, distances[_BATCHSIZE];
+
+  SegmentDistanceKernel::distancesFromSegments(
+      _tree->dimension(), point.coordinates(), _proximalPoint, _distalPoint,
+      segmentIDs, numberOfSegments, distances);
+  for (i = 0; i < numberOfSegments; i++) {
+    distance = std::min(distance, distances[i]);
+  }
+
+  return distance;
+}
+
+double TreeSegmentGrid::closest(Point point, double distance,
+                                bool stopIfCloser) {
+  int entry, count = 0, segmentIDs[_BATCHSIZE];
+  long i, j, k, ci, cj, ck;
+  double givenDistance = distance;
+
+  ci = cell(point.x());
+  cj = cell(point.y());
+  ck = cell(point.z());
+  for (i = ci - 1; i <= ci + 1; i++) {
+    for (j = cj - 1; j <= cj + 1; j++) {
+      for (k = _tree->dimension() == 2 ? ck : ck - 1;
+           k <= (_tree->dimension() == 2 ? ck : ck + 1); k++) {
+        for (entry = _bucket[bucket(i, j, k)]; entry != _NULLENTRY;
+             entry = _entryNext[entry]) {
+          segmentIDs[count++] = _entrySegment[entry];
+          if (count == _BATCHSIZE) {
+            distance =
+                std::min(distance, batchDistance(point, segmentIDs, count));
+            count = 0;
+            if (stopIfCloser && distance < givenDistance) {
+              return distance;
+            }
+          }
+        }
+      }
+    }
+  }
+  if (count > 0) {
+    distance = std::min(distance, batchDistance(point, segmentIDs, count));
+  }
+
+  return distance;
+}
+
+bool TreeSegmentGrid::hasSegmentCloser(Point point, double distance) {
+  if (!(distance > 0.0)) {
+    return false;
+  }
+  prepare(distance);
+
+  return closest(point, distance, true) < distance;
+}
+
+double TreeSegmentGrid::distanceFromSegments(Point point, double distance) {
+  if (!(distance > 0.0)) {
+    return distance;
+  }
+  prepare(distance);
+
+  return closest(point, distance, false);
+}
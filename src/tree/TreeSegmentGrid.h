@@ -0,0 +1,323 @@
+/**
+ * @file TreeSegmentGrid.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "geometry/SegmentDistanceKernel.h"
+#include "interface/TreeModel.h"
+#include "interface/TreeObserver.h"
+
+#ifndef _CCOLAB_TREE_TREESEGMENTGRID_H
+#define _CCOLAB_TREE_TREESEGMENTGRID_H
+/**
+ * @brief Uniform grid of the tree segments, hashed into a fixed number of
+ * buckets.
+ *
+ * Each segment is stored on the buckets of the cells it crosses. A segment
+ * closer than the cell size to a point crosses one of the 3^dimension cells
+ * around the point, so the query visits a constant number of cells. The cell
+ * size follows the queried distance: the grid is rebuilt only when the
+ * distance leaves [0.5, 0.9] times the cell size. The grid observes the
+ * tree, and the changed segments are updated on the next query. The
+ * distances to the segments of the cells are evaluated in batches by
+ * SegmentDistanceKernel.
+ */
+class TreeSegmentGrid : public TreeObserver {
+ private:
+  /**
+   * @brief The null entry index.
+   *
+   */
+  const int _NULLENTRY = -1;
+
+  /**
+   * @brief The cell size relative to the queried distance when the grid is
+   * rebuilt.
+   *
+   */
+  const double _CELLFACTOR = 1.25;
+
+  /**
+   * @brief The number of segments whose distances are evaluated at once.
+   *
+   */
+  static constexpr int _BATCHSIZE = 64;
+
+  /**
+   * @brief The tree.
+   *
+   */
+  TreeModel *_tree;
+
+  /**
+   * @brief The maximum number of segments.
+   *
+   */
+  int _capacity;
+
+  /**
+   * @brief The cell size (zero until the first query).
+   *
+   */
+  double _cellSize = 0.0;
+
+  /**
+   * @brief The number of buckets (a power of two).
+   *
+   */
+  int _numberOfBuckets;
+
+  /**
+   * @brief The first entry of each bucket.
+   *
+   */
+  int *_bucket = nullptr;
+
+  /**
+   * @brief The segment of each entry.
+   *
+   */
+  int *_entrySegment = nullptr;
+
+  /**
+   * @brief The next entry on the same bucket. For free entries it is the
+   * next free entry.
+   *
+   */
+  int *_entryNext = nullptr;
+
+  /**
+   * @brief The number of entries allocated.
+   *
+   */
+  int _numberOfEntries = 0;
+
+  /**
+   * @brief The number of entries on the buckets.
+   *
+   */
+  int _numberOfUsedEntries = 0;
+
+  /**
+   * @brief The first entry of the list of free entries.
+   *
+   */
+  int _freeEntry;
+
+  /**
+   * @brief Flag if each segment is on the grid.
+   *
+   */
+  bool *_isIndexed;
+
+  /**
+   * @brief The proximal point of each segment on the grid (3 coordinates
+   * per segment, as SegmentDistanceKernel reads them).
+   *
+   */
+  double *_proximalPoint;
+
+  /**
+   * @brief The distal point of each segment on the grid (3 coordinates per
+   * segment).
+   *
+   */
+  double *_distalPoint;
+
+  /**
+   * @brief The segments changed since the last query.
+   *
+   */
+  int *_modifiedSegments;
+
+  /**
+   * @brief Flag if each segment changed since the last query.
+   *
+   */
+  bool *_isModified;
+
+  /**
+   * @brief The number of segments changed since the last query.
+   *
+   */
+  int _numberOfModifiedSegments = 0;
+
+  /**
+   * @brief The end of the tree segments on the last query.
+   *
+   */
+  int _end = 0;
+
+  /**
+   * @brief Get the bucket of a cell.
+   *
+   * @param i The first cell coordinate.
+   * @param j The second cell coordinate.
+   * @param k The third cell coordinate.
+   * @return The bucket index.
+   */
+  int bucket(long i, long j, long k);
+
+  /**
+   * @brief Get the cell coordinate of a point coordinate.
+   *
+   * @param value The point coordinate.
+   * @return The cell coordinate.
+   */
+  long cell(double value);
+
+  /**
+   * @brief Add the segment to the buckets of the cells it crosses, or remove
+   * it from them.
+   *
+   * The segment is split in pieces not longer than the cell size, so the
+   * bounding box of each piece covers at most two cells on each axis.
+   *
+   * @param segmentID The segment index.
+   * @param insert Flag if the segment is added (or removed).
+   */
+  void link(int segmentID, bool insert);
+
+  /**
+   * @brief Put the segment on the grid with its current endpoints.
+   *
+   * @param segmentID The segment index.
+   */
+  void insert(int segmentID);
+
+  /**
+   * @brief Take the segment out of the grid.
+   *
+   * @param segmentID The segment index.
+   */
+  void remove(int segmentID);
+
+  /**
+   * @brief Update the segments changed since the last query.
+   *
+   */
+  void synchronize();
+
+  /**
+   * @brief Rebuild the grid with the cell size and the number of buckets.
+   *
+   * @param cellSize The cell size.
+   * @param numberOfBuckets The number of buckets.
+   */
+  void rebuild(double cellSize, int numberOfBuckets);
+
+  /**
+   * @brief Update the grid for a query with the distance.
+   *
+   * @param distance The queried distance.
+   */
+  void prepare(double distance);
+
+  /**
+   * @brief Get the distance from the point to the closest segment on the
+   * 3^dimension cells around the point, if it is less than the given
+   * distance. The distances are evaluated in batches of _BATCHSIZE segments.
+   *
+   * @param point The point.
+   * @param distance The given distance.
+   * @param stopIfCloser Flag if the search stops at the first batch with a
+   * segment closer than the given distance.
+   * @return The distance to the closest segment found, or the given
+   * distance if no segment is closer.
+   */
+  double closest(Point point, double distance, bool stopIfCloser);
+
+  /**
+   * @brief Get the distance from the point to the closest of the segments.
+   *
+   * @param point The point.
+   * @param segmentIDs The indices of the segments.
+   * @param numberOfSegments The number of segments (at most _BATCHSIZE).
+   * @return The distance to the closest segment.
+   */
+  double batchDistance(Point point, int *segmentIDs, int numberOfSegments);
+
+ public:
+  /**
+   * @brief Construct a new Tree Segment Grid object attached to the tree.
+   *
+   * @param tree The tree.
+   */
+  explicit TreeSegmentGrid(TreeModel *tree);
+
+  /**
+   * @brief Destroy the Tree Segment Grid object (it is detached from the
+   * tree).
+   *
+   */
+  ~TreeSegmentGrid();
+
+  /**
+   * @brief Get the tree.
+   *
+   * @return The tree.
+   */
+  TreeModel *tree();
+
+  /**
+   * @brief Get the cell size.
+   *
+   * @return The cell size.
+   */
+  double cellSize();
+
+  /**
+   * @brief Notify that the segment changed.
+   *
+   * @param segmentID The index of the segment.
+   */
+  virtual void changed(int segmentID);
+
+  /**
+   * @brief Check if some segment is closer than the distance to the point.
+   *
+   * The distance is the same of Geometry::distanceFromSegment, so the answer
+   * is the same of checking every segment of the tree.
+   *
+   * @param point The point.
+   * @param distance The distance.
+   * @return Returns true if some segment is closer than the distance to the
+   * point. Returns false otherwise.
+   */
+  bool hasSegmentCloser(Point point, double distance);
+
+  /**
+   * @brief Get the distance from the point to the closest segment, if it is
+   * less than the given distance.
+   *
+   * @param point The point.
+   * @param distance The given distance.
+   * @return The distance to the closest segment, or the given distance if
+   * no segment is closer.
+   */
+  double distanceFromSegments(Point point, double distance);
+};
+#endif //_CCOLAB_TREE_TREESEGMENTGRID_H
@@ -0,0 +1,624 @@
+/**
+ * @file TreeTrial.cc
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ * 
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include "TreeTrial.h"
+
+TreeTrial::TreeTrial(TreeModel *tree)
+    : TreeModel(tree->seed(), tree->numberOfTerminals(), tree->dimension()) {
+  _tree = tree;
+  _geometry = new Geometry(tree->dimension());
+  allocate();
+}
+
+TreeTrial::~TreeTrial() {
+  delete _geometry;
+  deallocate();
+}
+
+void TreeTrial::allocate() {
+  int i;
+
+  /**
+   *  Allocate all vectors once. It speed up the code because later it wont
+   *  need to create/destroy objects for each connection.
+   **/
+  _totalNumberOfSegments = _tree->totalNumberOfSegments();
+  _segments = new Segment[_totalNumberOfSegments];
+  _length = new double[_totalNumberOfSegments];
+  _reducedHydrodynamicResistance = new double[_totalNumberOfSegments];
+  _position = new int[_totalNumberOfSegments];
+  _differentSegments = new int[_totalNumberOfSegments];
+  _changedSegments = new int[_totalNumberOfSegments];
+  _radiusRatio = new double[_totalNumberOfSegments];
+  _radiusRatioVersion = new long[_totalNumberOfSegments];
+  _radiusRatioPath = new int[_totalNumberOfSegments];
+  for (i = 0; i < _totalNumberOfSegments; i++) {
+    _position[i] = -1;
+    _radiusRatioVersion[i] = -1;
+  }
+  _numberOfDifferentSegments = 0;
+  _numberOfChangedSegments = 0;
+  _isConnected = false;
+}
+
+void TreeTrial::deallocate() {
+  delete[] _segments;
+  delete[] _length;
+  delete[] _reducedHydrodynamicResistance;
+  delete[] _position;
+  delete[] _differentSegments;
+  delete[] _changedSegments;
+  delete[] _radiusRatio;
+  delete[] _radiusRatioVersion;
+  delete[] _radiusRatioPath;
+}
+
+void TreeTrial::setTree(TreeModel *tree) {
+  deallocate();
+  _tree = tree;
+  delete _geometry;
+  _geometry = new Geometry(tree->dimension());
+  allocate();
+}
+
+void TreeTrial::clear() {
+  int i;
+  for (i = 0; i < _numberOfDifferentSegments; i++) {
+    _position[_differentSegments[i]] = -1;
+  }
+  _numberOfDifferentSegments = 0;
+  _numberOfChangedSegments = 0;
+  _isConnected = false;
+  _bifurcationSegmentID = -1;
+  _connectionSegmentID = -1;
+  _newSegmentID = -1;
+  _version++;
+}
+
+Segment *TreeTrial::differ(int segmentID) {
+  int position = _position[segmentID];
+  if (position < 0) {
+    position = _numberOfDifferentSegments++;
+    _position[segmentID] = position;
+    _differentSegments[position] = segmentID;
+    if (segmentID < _tree->end()) {
+      _segments[position] = *_tree->segment(segmentID);
+      _length[position] = _tree->length(segmentID);
+      _reducedHydrodynamicResistance[position] =
+          _tree->reducedHydrodynamicResistance(segmentID);
+    }
+  }
+
+  return &_segments[position];
+}
+
+void TreeTrial::connect(int segmentID, Point bifurcationPoint,
+                        Segment newSegment) {
+  int i, childID, parentID, level;
+  double connectionLength, newLength;
+  Segment parent = *_tree->segment(segmentID), *segment;
+
+  clear();
+  _isConnected = true;
+  _bifurcationSegmentID = segmentID;
+  _connectionSegmentID = _tree->end();
+  _newSegmentID = _tree->end() + 1;
+  _newSegment = newSegment;
+
+  /* Create the connection segment as a copy of the parent. */
+  segment = differ(_connectionSegmentID);
+  segment->setDimension(dimension());
+  segment->setID(_connectionSegmentID);
+  segment->setPoint(parent.point());
+  segment->setFlow(parent.flow());
+  segment->setBifurcationRatioLeft(parent.bifurcationRatioLeft());
+  segment->setBifurcationRatioRight(parent.bifurcationRatioRight());
+  segment->setLeft(parent.left());
+  segment->setRight(parent.right());
+  segment->setUp(segmentID);
+  if (parent.left() != _TERMINALEND) {
+    differ(parent.left())->setUp(_connectionSegmentID);
+  }
+
+  if (parent.right() != _TERMINALEND) {
+    differ(parent.right())->setUp(_connectionSegmentID);
+  }
+
+  connectionLength = _geometry->distance(bifurcationPoint, parent.point());
+  _length[_position[_connectionSegmentID]] = lengthUnit() * connectionLength;
+  _reducedHydrodynamicResistance[_position[_connectionSegmentID]] =
+      _tree->reducedHydrodynamicResistance(segmentID) +
+      _poiseuilleLawConstant *
+          (bloodViscosity(_connectionSegmentID) * connectionLength -
+           bloodViscosity(segmentID) * _tree->length(segmentID));
+
+  /* Add the new segment. */
+  segment = differ(_newSegmentID);
+  segment->setDimension(dimension());
+  segment->setID(_newSegmentID);
+  segment->setPoint(newSegment.point());
+  segment->setFlow(newSegment.flow());
+  segment->setBifurcationRatioLeft(1.0);
+  segment->setBifurcationRatioRight(1.0);
+  segment->setLeft(_TERMINALEND);
+  segment->setRight(_TERMINALEND);
+  segment->setUp(segmentID);
+  newLength = _geometry->distance(bifurcationPoint, newSegment.point());
+  _length[_position[_newSegmentID]] = lengthUnit() * newLength;
+  _reducedHydrodynamicResistance[_position[_newSegmentID]] =
+      _poiseuilleLawConstant * bloodViscosity(_newSegmentID) * newLength;
+
+  _changedSegments[_numberOfChangedSegments++] = _newSegmentID;
+
+  /**
+   *  The ratios copied from the parent were evaluated at its level. As
+   *  Tree::growSegment does, evaluate the subtree moved one level down again
+   *  when its expoents changed (never with a constant law).
+   **/
+  level = _tree->level(segmentID) + 1;
+  if (!isBifurcationExpoentConstant() &&
+      isExpoentShifted(_connectionSegmentID, level)) {
+    updateSubtree(_connectionSegmentID, level);
+  } else {
+    _changedSegments[_numberOfChangedSegments++] = _connectionSegmentID;
+  }
+
+  /* Update the bifurcation segment. */
+  segment = differ(segmentID);
+  segment->setPoint(bifurcationPoint);
+  segment->setLeft(_connectionSegmentID);
+  segment->setRight(_newSegmentID);
+  _length[_position[segmentID]] =
+      lengthUnit() *
+      _geometry->distance(proximalPoint(segmentID), bifurcationPoint);
+
+  /* Recalculate the radii bifurcations ratio and the flow. */
+  updateUp(segmentID);
+
+  /* Evaluate the radius ratios from the root down to the new segments. */
+  _rootRadius =
+      radiusUnit() *
+      pow(reducedHydrodynamicResistance(rootID()) * perfusionFlow() /
+              (perfusionPressure() - terminalPressure()),
+          0.25);
+  for (i = _numberOfChangedSegments - 1; i >= 0; i--) {
+    childID = _changedSegments[i];
+    if (isRoot(childID)) {
+      _radiusRatio[childID] = 1.0;
+    } else {
+      parentID = this->segment(childID)->up();
+      segment = this->segment(parentID);
+      if (segment->left() == childID) {
+        _radiusRatio[childID] =
+            _radiusRatio[parentID] * segment->bifurcationRatioLeft();
+      } else {
+        _radiusRatio[childID] =
+            _radiusRatio[parentID] * segment->bifurcationRatioRight();
+      }
+    }
+    _radiusRatioVersion[childID] = _version;
+  }
+}
+
+void TreeTrial::updateSegment(int segmentID, int segmentLevel) {
+  int connectionID, _newID;
+  double connectionFlow, newFlow, flowRatio, leftReducedHydrodynamicResistance,
+      rightReducedHydrodynamicResistance, reducedHydrodynamicResistanceRatio,
+      radiusRatio, Rtemp, radiusRatioPowerBifurcationExpoent, leftRadiusRatio,
+      rightRadiusRatio, expoent;
+  Segment *segment = differ(segmentID);
+
+  connectionID = segment->left();
+  _newID = segment->right();
+
+  connectionFlow = this->segment(connectionID)->flow();
+  newFlow = this->segment(_newID)->flow();
+  segment->setFlow(connectionFlow + newFlow);
+  flowRatio = connectionFlow / newFlow;
+
+  leftReducedHydrodynamicResistance =
+      reducedHydrodynamicResistance(connectionID);
+  rightReducedHydrodynamicResistance = reducedHydrodynamicResistance(_newID);
+  reducedHydrodynamicResistanceRatio =
+      leftReducedHydrodynamicResistance / rightReducedHydrodynamicResistance;
+
+  radiusRatio = pow(flowRatio * reducedHydrodynamicResistanceRatio, 0.25);
+  expoent = bifurcationExpoent(segmentLevel);
+  radiusRatioPowerBifurcationExpoent = pow(radiusRatio, expoent);
+  leftRadiusRatio =
+      pow(1.0 + 1.0 / radiusRatioPowerBifurcationExpoent, -1.0 / expoent);
+  rightRadiusRatio =
+      pow(1.0 + radiusRatioPowerBifurcationExpoent, -1.0 / expoent);
+
+  segment->setBifurcationRatioLeft(leftRadiusRatio);
+  segment->setBifurcationRatioRight(rightRadiusRatio);
+
+  Rtemp = pow(leftRadiusRatio, 4.0) / leftReducedHydrodynamicResistance +
+          pow(rightRadiusRatio, 4.0) / rightReducedHydrodynamicResistance;
+  _reducedHydrodynamicResistance[_position[segmentID]] =
+      _poiseuilleLawConstant * bloodViscosity(segmentID) * length(segmentID) +
+      1.0 / Rtemp;
+}
+
+void TreeTrial::updateUp(int segmentID) {
+  /* The same evaluation of TreeModel::update, from the segment up to the
+   * root. The segments from the bifurcation up keep their level on the tree.
+   */
+  do {
+    updateSegment(segmentID, _tree->level(segmentID));
+    _changedSegments[_numberOfChangedSegments++] = segmentID;
+    segmentID = segment(segmentID)->up();
+  } while (segmentID != _TERMINALEND);
+}
+
+bool TreeTrial::isExpoentShifted(int segmentID, int segmentLevel) {
+  int currentID = segmentID, previousID, level = segmentLevel;
+  while (true) {
+    if (!isTerminal(currentID)) {
+      if (bifurcationExpoent(level) != bifurcationExpoent(level - 1)) {
+        return true;
+      }
+      currentID = segment(currentID)->left();
+      level++;
+      continue;
+    }
+
+    /* Climb up to the first ascendent whose right subtree is not visited. */
+    do {
+      if (currentID == segmentID) {
+        return false;
+      }
+      previousID = currentID;
+      currentID = segment(currentID)->up();
+      level--;
+    } while (segment(currentID)->right() == previousID);
+    currentID = segment(currentID)->right();
+    level++;
+  }
+}
+
+void TreeTrial::updateSubtree(int segmentID, int segmentLevel) {
+  int currentID = segmentID, previousID, level = segmentLevel;
+  while (true) {
+    while (!isTerminal(currentID)) {
+      currentID = segment(currentID)->left();
+      level++;
+    }
+
+    /**
+     *  Climb up evaluating the bifurcations whose right subtree is visited,
+     *  until the first one whose right subtree is not.
+     **/
+    while (true) {
+      if (!isTerminal(currentID)) {
+        updateSegment(currentID, level);
+        _changedSegments[_numberOfChangedSegments++] = currentID;
+      }
+      if (currentID == segmentID) {
+        return;
+      }
+      previousID = currentID;
+      currentID = segment(currentID)->up();
+      level--;
+      if (segment(currentID)->left() == previousID) {
+        currentID = segment(currentID)->right();
+        level++;
+        break;
+      }
+    }
+  }
+}
+
+double TreeTrial::radiusRatio(int segmentID) {
+  int i, pathSize = 0, ancestorID = segmentID, _parent;
+
+  /* Search for the closest ancestor with an updated radius ratio. */
+  while (_radiusRatioVersion[ancestorID] != _version && !isRoot(ancestorID)) {
+    _radiusRatioPath[pathSize++] = ancestorID;
+    ancestorID = segment(ancestorID)->up();
+  }
+
+  if (_radiusRatioVersion[ancestorID] != _version) {
+    _radiusRatio[ancestorID] = 1.0;
+    _radiusRatioVersion[ancestorID] = _version;
+  }
+
+  /* Evaluate the radius ratios from that ancestor down to the segment. */
+  while (pathSize > 0) {
+    i = _radiusRatioPath[--pathSize];
+    _parent = segment(i)->up();
+    if (segment(_parent)->left() == i) {
+      _radiusRatio[i] =
+          _radiusRatio[_parent] * segment(_parent)->bifurcationRatioLeft();
+    } else {
+      _radiusRatio[i] =
+          _radiusRatio[_parent] * segment(_parent)->bifurcationRatioRight();
+    }
+    _radiusRatioVersion[i] = _version;
+  }
+
+  return _radiusRatio[segmentID];
+}
+
+int TreeTrial::rootID() { return _tree->rootID(); }
+
+Point TreeTrial::seed() { return _tree->seed(); }
+
+Segment *TreeTrial::segments() { return _tree->segments(); }
+
+int TreeTrial::numberOfTerminals() { return _tree->numberOfTerminals(); }
+
+int TreeTrial::currentNumberOfTerminals() {
+  return _tree->currentNumberOfTerminals() + (_isConnected ? 1 : 0);
+}
+
+int TreeTrial::currentNumberOfSegments() {
+  return _tree->currentNumberOfSegments() + (_isConnected ? 2 : 0);
+}
+
+int TreeTrial::totalNumberOfSegments() { return _totalNumberOfSegments; }
+
+int TreeTrial::begin() { return _tree->begin(); }
+
+int TreeTrial::end() { return _tree->end() + (_isConnected ? 2 : 0); }
+
+int TreeTrial::dimension() { return _tree->dimension(); }
+
+double TreeTrial::radiusUnit() { return _tree->radiusUnit(); }
+
+double TreeTrial::lengthUnit() { return _tree->lengthUnit(); }
+
+double TreeTrial::perfusionVolume() { return _tree->perfusionVolume(); }
+
+double TreeTrial::perfusionPressure() { return _tree->perfusionPressure(); }
+
+double TreeTrial::terminalPressure() { return _tree->terminalPressure(); }
+
+double TreeTrial::perfusionFlow() { return _tree->perfusionFlow(); }
+
+double TreeTrial::bloodViscosity(int segmentID) {
+  return _tree->bloodViscosity(segmentID);
+}
+
+double TreeTrial::bifurcationExpoent(int segmentLevel) {
+  return _tree->bifurcationExpoent(segmentLevel);
+}
+
+bool TreeTrial::isBifurcationExpoentConstant() {
+  return _tree->isBifurcationExpoentConstant();
+}
+
+Segment TreeTrial::root() { return *segment(rootID()); }
+
+Segment TreeTrial::parent(int segmentID) {
+  if (isRoot(segmentID)) {
+    return *segment(segmentID);
+  } else {
+    return *segment(segment(segmentID)->up());
+  }
+}
+
+Segment TreeTrial::left(int segmentID) {
+  return *segment(segment(segmentID)->left());
+}
+
+Segment TreeTrial::right(int segmentID) {
+  return *segment(segment(segmentID)->right());
+}
+
+Segment *TreeTrial::segment(int segmentID) {
+  return _position[segmentID] < 0 ? _tree->segment(segmentID)
+                                  : &_segments[_position[segmentID]];
+}
+
+void TreeTrial::moveDistalPoint(int segmentID, Point point) {
+  if (!_isConnected || segmentID != _bifurcationSegmentID) {
+    throw invalid_argument(
+        "Oops! Only the bifurcation segment of a trial can be moved.");
+  }
+
+  connect(segmentID, point, _newSegment);
+}
+
+double TreeTrial::length(int segmentID) {
+  return _position[segmentID] < 0 ? _tree->length(segmentID)
+                                  : _length[_position[segmentID]];
+}
+
+double TreeTrial::radius(int segmentID) {
+  if (!_isConnected) {
+    return _tree->radius(segmentID);
+  }
+
+  return radiusRatio(segmentID) * _rootRadius;
+}
+
+double TreeTrial::volume() {
+  int i;
+  double r, vol = 0.0;
+
+  for (i = begin(); i < end(); i++) {
+    r = radius(i);
+    vol += (r * r) * length(i);
+  }
+
+  vol *= M_PI;
+
+  return vol;
+}
+
+double TreeTrial::reducedHydrodynamicResistance(int segmentID) {
+  return _position[segmentID] < 0
+             ? _tree->reducedHydrodynamicResistance(segmentID)
+             : _reducedHydrodynamicResistance[_position[segmentID]];
+}
+
+int TreeTrial::level(int segmentID) {
+  int _level = 0;
+  while (!isRoot(segmentID)) {
+    _level++;
+    segmentID = segment(segmentID)->up();
+  }
+
+  return _level;
+}
+
+int TreeTrial::strahlerOrder(int segmentID) {
+  int leftSO, rightSO;
+
+  if (isTerminal(segmentID)) {
+    return 1;
+  } else {
+    leftSO = strahlerOrder(segment(segmentID)->left());
+    rightSO = strahlerOrder(segment(segmentID)->right());
+    if (leftSO == rightSO) {
+      return leftSO + 1;
+    } else {
+      return leftSO > rightSO ? leftSO : rightSO;
+    }
+  }
+}
+
+Segment TreeTrial::growRoot(Segment /*root*/) {
+  throw invalid_argument("Oops! A tree trial can not grow.");
+}
+
+void TreeTrial::copy(Segment /*source*/, Segment /*destination*/) {
+  throw invalid_argument("Oops! A tree trial can not be changed.");
+}
+
+Segment TreeTrial::growSegment(Point /*bifurcationPoint*/,
+                               Segment /*parent*/, Segment /*child*/) {
+  throw invalid_argument("Oops! A tree trial can not grow.");
+}
+
+Segment TreeTrial::remove(Segment /*segment*/) {
+  throw invalid_argument("Oops! A tree trial can not be changed.");
+}
+
+void TreeTrial::update(Segment /*segment*/) {
+  throw invalid_argument("Oops! A tree trial can not be changed.");
+}
+
+bool TreeTrial::isRoot(int segmentID) { return segmentID == rootID(); }
+
+bool TreeTrial::isTerminal(int segmentID) {
+  return (segment(segmentID)->left() == _TERMINALEND &&
+          segment(segmentID)->right() == _TERMINALEND);
+}
+
+Point TreeTrial::proximalPoint(int segmentID) {
+  if (isRoot(segmentID)) {
+    return seed();
+  } else {
+    return segment(segment(segmentID)->up())->point();
+  }
+}
+
+Point TreeTrial::distalPoint(int segmentID) {
+  return segment(segmentID)->point();
+}
+
+int TreeTrial::nearestSegments(Point point, int numberOfSegments,
+                               int *segmentIDs, double *distances) {
+  int i, j, count = 0;
+  double distance;
+
+  if (!_isConnected) {
+    return _tree->nearestSegments(point, numberOfSegments, segmentIDs,
+                                  distances);
+  }
+
+  /**
+   * The spatial index of the tree does not know the trial, so keep the
+   * closest segments sorted by distance (and by index on ties).
+   */
+  for (i = begin(); i < end(); i++) {
+    distance = _geometry->distanceFromSegment(point, proximalPoint(i),
+                                              distalPoint(i));
+    if (count < numberOfSegments) {
+      j = count++;
+    } else if (numberOfSegments > 0 && distance < distances[count - 1]) {
+      j = count - 1;
+    } else {
+      continue;
+    }
+
+    while (j > 0 && distances[j - 1] > distance) {
+      distances[j] = distances[j - 1];
+      segmentIDs[j] = segmentIDs[j - 1];
+      j--;
+    }
+    distances[j] = distance;
+    segmentIDs[j] = i;
+  }
+
+  return count;
+}
+
+int TreeTrial::nearbySegments(Point pointA, Point pointB, double distance,
+                              int *segmentIDs) {
+  int i, count, numberOfSegments;
+
+  numberOfSegments =
+      _tree->nearbySegments(pointA, pointB, distance, segmentIDs);
+  if (!_isConnected) {
+    return numberOfSegments;
+  }
+
+  /**
+   * Only the bifurcation segment moved. It is given with the new segments
+   * instead of the tree one (returning more segments is allowed).
+   */
+  count = 0;
+  for (i = 0; i < numberOfSegments; i++) {
+    if (segmentIDs[i] != _bifurcationSegmentID) {
+      segmentIDs[count++] = segmentIDs[i];
+    }
+  }
+  segmentIDs[count++] = _bifurcationSegmentID;
+  segmentIDs[count++] = _connectionSegmentID;
+  segmentIDs[count++] = _newSegmentID;
+
+  return count;
+}
+
+double TreeTrial::flow() { return segment(rootID())->flow(); }
+
+void TreeTrial::print() {
+  int i;
+
+  cout << "Seed:" << endl;
+  seed().print();
+
+  for (i = begin(); i < end(); i++) {
+    segment(i)->print(reducedHydrodynamicResistance(i), length(i), radius(i));
+  }
+
+  cout << "---" << endl;
+}
@@ -0,0 +1,444 @@
+/**
+ * @file TreeTrial.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+#include <stdexcept>
+
+#include "geometry/Geometry.h"
+#include "interface/TreeModel.h"
+
+using std::invalid_argument;
+
+#ifndef _CCOLAB_TREE_TREETRIAL_H
+#define _CCOLAB_TREE_TREETRIAL_H
+/**
+ * @brief View of a tree plus one hypothetical bifurcation.
+ *
+ * The trial connects a new terminal segment to a segment of the tree exactly
+ * like TreeModel::growSegment would do, but the flow, resistance and radii
+ * of the affected segments (the new ones and the path up to the root) are
+ * kept apart, so the tree is never written. The other segments are read from
+ * the tree.
+ *
+ * The trial must be connected again whenever the tree changes.
+ */
+class TreeTrial final : public TreeModel {
+ private:
+  /**
+   * @brief The tree.
+   *
+   */
+  TreeModel *_tree;
+
+  /**
+   * @brief Geometry object to do some geometric calculations.
+   *
+   */
+  Geometry *_geometry;
+
+  /**
+   * @brief The maximum number of segments on the tree.
+   *
+   */
+  int _totalNumberOfSegments = 0;
+
+  /**
+   * @brief Flag if there is a connection.
+   *
+   */
+  bool _isConnected = false;
+
+  /**
+   * @brief The index of the bifurcation segment.
+   *
+   */
+  int _bifurcationSegmentID = -1;
+
+  /**
+   * @brief The index of the connection segment.
+   *
+   */
+  int _connectionSegmentID = -1;
+
+  /**
+   * @brief The index of the new segment.
+   *
+   */
+  int _newSegmentID = -1;
+
+  /**
+   * @brief The new terminal segment.
+   *
+   */
+  Segment _newSegment;
+
+  /**
+   * @brief The segments that differ from the tree.
+   *
+   */
+  Segment *_segments;
+
+  /**
+   * @brief The length of the segments that differ from the tree.
+   *
+   */
+  double *_length;
+
+  /**
+   * @brief The reduced hydrodynamic resistance of the segments that differ
+   * from the tree.
+   *
+   */
+  double *_reducedHydrodynamicResistance;
+
+  /**
+   * @brief The position of each segment on the vectors of segments that
+   * differ from the tree (or -1).
+   *
+   */
+  int *_position;
+
+  /**
+   * @brief The index of the segments that differ from the tree.
+   *
+   */
+  int *_differentSegments;
+
+  /**
+   * @brief The number of segments that differ from the tree.
+   *
+   */
+  int _numberOfDifferentSegments = 0;
+
+  /**
+   * @brief The segments whose subtree changed, from the deepest one up to the
+   * root.
+   *
+   */
+  int *_changedSegments;
+
+  /**
+   * @brief The number of segments whose subtree changed.
+   *
+   */
+  int _numberOfChangedSegments = 0;
+
+  /**
+   * @brief Vector of the radius ratio between each segment and the root.
+   *
+   */
+  double *_radiusRatio;
+
+  /**
+   * @brief The version of the trial when each radius ratio was evaluated.
+   *
+   */
+  long *_radiusRatioVersion;
+
+  /**
+   * @brief The segments waiting to have their radius ratio evaluated.
+   *
+   */
+  int *_radiusRatioPath;
+
+  /**
+   * @brief The version of the trial. It changes on every connection.
+   *
+   */
+  long _version = 0;
+
+  /**
+   * @brief The radius of the root segment.
+   *
+   */
+  double _rootRadius;
+
+  /**
+   * @brief Allocate the vectors for the segments of the tree.
+   *
+   */
+  void allocate();
+
+  /**
+   * @brief Free the vectors.
+   *
+   */
+  void deallocate();
+
+  /**
+   * @brief Copy the segment of the tree to the segments that differ from it.
+   *
+   * @param segmentID The index of the segment.
+   * @return The copy of the segment.
+   */
+  Segment *differ(int segmentID);
+
+  /**
+   * @brief Recalculate the radii bifurcations ratio, the flow and the
+   * reduced hydrodynamic resistance of the bifurcation segment from its
+   * descendents, like Tree::updateSegment.
+   *
+   * @param segmentID The index of the segment.
+   * @param segmentLevel The bifurcation level of the segment on the trial.
+   */
+  void updateSegment(int segmentID, int segmentLevel);
+
+  /**
+   * @brief Recalculate the radii bifurcations ratio and the flow from the
+   * segment up to the root, like TreeModel::update.
+   *
+   * @param segmentID The index of the segment.
+   */
+  void updateUp(int segmentID);
+
+  /**
+   * @brief Check if the expoent of a bifurcation of the subtree of the
+   * segment differs from the one it had one level up, like the tree does
+   * when growSegment moves the subtree of the connection one level down.
+   *
+   * @param segmentID The index of the segment.
+   * @param segmentLevel The bifurcation level of the segment on the trial.
+   * @return Returns true if an expoent changed. Returns false otherwise.
+   */
+  bool isExpoentShifted(int segmentID, int segmentLevel);
+
+  /**
+   * @brief Recalculate every bifurcation of the subtree of the segment, the
+   * descendents before their ascendents, like Tree::updateSubtree. They are
+   * added to the changed segments in that order.
+   *
+   * @param segmentID The index of the segment.
+   * @param segmentLevel The bifurcation level of the segment on the trial.
+   */
+  void updateSubtree(int segmentID, int segmentLevel);
+
+  /**
+   * @brief Get the radius ratio between the segment and the root.
+   *
+   * @param segmentID The index of the segment.
+   * @return The radius ratio between the segment and the root.
+   */
+  double radiusRatio(int segmentID);
+
+ public:
+  /**
+   * @brief Construct a new Tree Trial object.
+   *
+   * @param tree The tree.
+   */
+  explicit TreeTrial(TreeModel *tree);
+
+  /**
+   * @brief Destroy the Tree Trial object.
+   *
+   */
+  ~TreeTrial();
+
+  /**
+   * @brief Get the tree.
+   *
+   * @return The tree.
+   */
+  TreeModel *tree() { return _tree; }
+
+  /**
+   * @brief Set the tree (and clear the connection).
+   *
+   * @param tree The tree.
+   */
+  void setTree(TreeModel *tree);
+
+  /**
+   * @brief Connect the new segment to the segment like
+   * TreeModel::growSegment.
+   *
+   * @param segmentID The index of the bifurcation segment.
+   * @param bifurcationPoint The bifurcation point.
+   * @param newSegment The new segment (only its distal point and flow are
+   * used).
+   */
+  void connect(int segmentID, Point bifurcationPoint, Segment newSegment);
+
+  /**
+   * @brief Remove the connection, so the trial is equal to the tree.
+   *
+   */
+  void clear();
+
+  /**
+   * @brief Check if there is a connection.
+   *
+   * @return Returns true if there is a connection. Returns false otherwise.
+   */
+  bool isConnected() { return _isConnected; }
+
+  /**
+   * @brief Get the index of the bifurcation segment.
+   *
+   * @return The index of the bifurcation segment.
+   */
+  int bifurcationSegmentID() { return _bifurcationSegmentID; }
+
+  /**
+   * @brief Get the index of the connection segment.
+   *
+   * @return The index of the connection segment.
+   */
+  int connectionSegmentID() { return _connectionSegmentID; }
+
+  /**
+   * @brief Get the index of the new segment.
+   *
+   * @return The index of the new segment.
+   */
+  int newSegmentID() { return _newSegmentID; }
+
+  /**
+   * @brief Get the number of segments whose subtree changed.
+   *
+   * @return The number of segments whose subtree changed.
+   */
+  int numberOfChangedSegments() { return _numberOfChangedSegments; }
+
+  /**
+   * @brief Get the segments whose subtree changed (the new segment, the
+   * connection segment and the path from the bifurcation segment up to the
+   * root, in that order). When the bifurcation expoent of the subtree moved
+   * one level down changes, its bifurcations come right before the
+   * connection segment, the descendents before their ascendents.
+   *
+   * @return The segments whose subtree changed.
+   */
+  int *changedSegments() { return _changedSegments; }
+
+  /* The methods below read the tree through the trial. */
+  virtual int rootID();
+  virtual Point seed();
+  virtual Segment *segments();
+  virtual int numberOfTerminals();
+  virtual int currentNumberOfTerminals();
+  virtual int currentNumberOfSegments();
+  virtual int totalNumberOfSegments();
+  virtual int begin();
+  virtual int end();
+  virtual int dimension();
+  virtual double radiusUnit();
+  virtual double lengthUnit();
+  virtual double perfusionVolume();
+  virtual double perfusionPressure();
+  virtual double terminalPressure();
+  virtual double perfusionFlow();
+  virtual double bloodViscosity(int segmentID);
+  virtual double bifurcationExpoent(int segmentLevel);
+  virtual bool isBifurcationExpoentConstant();
+  virtual Segment root();
+  virtual Segment parent(int segmentID);
+  virtual Segment left(int segmentID);
+  virtual Segment right(int segmentID);
+  virtual Segment *segment(int segmentID);
+
+  /**
+   * @brief Move the distal point of the bifurcation segment. It is the same
+   * as connecting the new segment again at the point.
+   *
+   * @param segmentID The index of the bifurcation segment.
+   * @param point The new bifurcation point.
+   */
+  virtual void moveDistalPoint(int segmentID, Point point);
+
+  virtual double length(int segmentID);
+  virtual double radius(int segmentID);
+  virtual double volume();
+  virtual double reducedHydrodynamicResistance(int segmentID);
+  virtual int level(int segmentID);
+  virtual int strahlerOrder(int segmentID);
+
+  /**
+   * @brief The trial can not be changed but by TreeTrial::connect.
+   *
+   */
+  virtual Segment growRoot(Segment root);
+
+  /**
+   * @brief The trial can not be changed but by TreeTrial::connect.
+   *
+   */
+  virtual void copy(Segment source, Segment destination);
+
+  /**
+   * @brief The trial can not be changed but by TreeTrial::connect.
+   *
+   */
+  virtual Segment growSegment(Point bifurcationPoint, Segment parent,
+                              Segment child);
+
+  /**
+   * @brief The trial can not be changed but by TreeTrial::connect.
+   *
+   */
+  virtual Segment remove(Segment segment);
+
+  /**
+   * @brief The trial can not be changed but by TreeTrial::connect.
+   *
+   */
+  virtual void update(Segment segment);
+
+  virtual bool isRoot(int segmentID);
+  virtual bool isTerminal(int segmentID);
+  virtual Point proximalPoint(int segmentID);
+  virtual Point distalPoint(int segmentID);
+  virtual int nearestSegments(Point point, int numberOfSegments,
+                              int *segmentIDs, double *distances);
+  virtual int nearbySegments(Point pointA, Point pointB, double distance,
+                             int *segmentIDs);
+
+  /**
+   * @brief Nothing happens: the trial never notifies the observers.
+   *
+   * @param observer The observer.
+   */
+  virtual void attach(TreeObserver * /*observer*/) {}
+
+  /**
+   * @brief Nothing happens: the trial never notifies the observers.
+   *
+   * @param observer The observer.
+   */
+  virtual void detach(TreeObserver * /*observer*/) {}
+
+  /**
+   * @brief Refresh the tree. The values of the trial are evaluated by
+   * TreeTrial::connect.
+   *
+   */
+  virtual void refresh() { _tree->refresh(); }
+
+  virtual double flow();
+  virtual void print();
+};
+#endif  //_CCOLAB_TREE_TREETRIAL_H
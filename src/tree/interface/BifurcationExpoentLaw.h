@@ -51,5 +51,14 @@ class BifurcationExpoentLaw {
    * @return The bifurcation expoent.
    */
   virtual double eval(int segmentLevel) = 0;
+
+  /**
+   * @brief Check if the bifurcation expoent is the same at every level, so
+   * the radii bifurcation ratios do not change when a subtree changes level.
+   * 
+   * @return Returns true if the expoent does not depend on the level.
+   * Returns false otherwise.
+   */
+  virtual bool isConstant() { return false; }
 };
 #endif //_CCOLAB_TREE_INTERFACE_BIFURCATIONEXPOENTLAW_H
@@ -33,6 +33,7 @@
 #include "BifurcationExpoentLaw.h"
 #include "BloodViscosity.h"
 #include "Segment.h"
+#include "TreeObserver.h"
 using std::cout;
 using std::endl;
 
@@ -50,7 +51,7 @@ class TreeModel {
    * @brief Vector of segments on the tree.
    * 
    */
-  Segment *_segments;
+  Segment *_segments = nullptr;
 
   /**
    * @brief The number of terminal segments.
@@ -363,6 +364,17 @@ class TreeModel {
     return _bifurcationExpoent->eval(segmentLevel);
   }
 
+  /**
+   * @brief Check if the bifurcation expoent is the same at every level (see
+   * BifurcationExpoentLaw::isConstant).
+   * 
+   * @return Returns true if the expoent does not depend on the level.
+   * Returns false otherwise.
+   */
+  virtual bool isBifurcationExpoentConstant() {
+    return _bifurcationExpoent->isConstant();
+  }
+
   /**
    * @brief Set the seed of the tree.
    * 
@@ -504,6 +516,33 @@ class TreeModel {
    */
   virtual Segment *segment(int segmentID) = 0;
 
+  /**
+   * @brief Get the index of the parent (ie, ascendent) segment without
+   * copying the segments.
+   * 
+   * @param segmentID The index of the segment.
+   * @return The index of the parent segment (_TERMINALEND for the root).
+   */
+  virtual int parentID(int segmentID) { return segment(segmentID)->up(); }
+
+  /**
+   * @brief Get the index of the left descendent segment without copying the
+   * segments.
+   * 
+   * @param segmentID The index of the segment.
+   * @return The index of the left segment (_TERMINALEND for a terminal).
+   */
+  virtual int leftID(int segmentID) { return segment(segmentID)->left(); }
+
+  /**
+   * @brief Get the index of the right descendent segment without copying the
+   * segments.
+   * 
+   * @param segmentID The index of the segment.
+   * @return The index of the right segment (_TERMINALEND for a terminal).
+   */
+  virtual int rightID(int segmentID) { return segment(segmentID)->right(); }
+
   /**
    * @brief Move the distal point of the segment.
    * 
@@ -643,6 +682,75 @@ class TreeModel {
    */
   virtual Point distalPoint(int segmentID) = 0;
 
+  /**
+   * @brief Find the segments closest to the point.
+   * 
+   * The segments are sorted by the critic distance from the point and the
+   * ties are sorted by the segment index.
+   * 
+   * @param point The point.
+   * @param numberOfSegments The maximum number of segments to find.
+   * @param segmentIDs The closest segments (at least numberOfSegments
+   * positions).
+   * @param distances The distance of the closest segments (at least
+   * numberOfSegments positions).
+   * @return The number of segments found.
+   */
+  virtual int nearestSegments(Point point, int numberOfSegments,
+                              int *segmentIDs, double *distances) = 0;
+
+  /**
+   * @brief Find the segments that may be closer than the distance from the
+   * segment AB.
+   * 
+   * Every segment closer than the distance is found, but some farther
+   * segments may be found too.
+   * 
+   * @param pointA The proximal point of the segment AB.
+   * @param pointB The distal point of the segment AB.
+   * @param distance The distance.
+   * @param segmentIDs The segments found (at least totalNumberOfSegments
+   * positions).
+   * @return The number of segments found.
+   */
+  virtual int nearbySegments(Point pointA, Point pointB, double distance,
+                             int *segmentIDs) = 0;
+
+  /**
+   * @brief Attach the observer to be notified when the segments change.
+   * 
+   * @param observer The observer.
+   */
+  virtual void attach(TreeObserver *observer) = 0;
+
+  /**
+   * @brief Detach the observer (nothing happens if it is not attached).
+   * 
+   * @param observer The observer.
+   */
+  virtual void detach(TreeObserver *observer) = 0;
+
+  /**
+   * @brief Evaluate now the values the tree caches on demand (as the radii
+   * and the segment index).
+   * 
+   * Until the tree changes again, the getters only read the tree, so they may
+   * be called by several threads at once. The segment searches still use
+   * working memory of the tree and must not be called concurrently.
+   */
+  virtual void refresh() {}
+
+  /**
+   * @brief Renumber the segments so the walks over the tree read the memory
+   * sequentially (the default keeps the current numbering).
+   * 
+   * The tree is the same, but the indices of the segments held by other
+   * objects are invalid afterwards. The growth breaks the ties between
+   * candidate connections by index, so renumbering while growing may change
+   * the tree grown.
+   */
+  virtual void reorder() {}
+
   /**
    * @brief Get the flow passing through the root segment.
    * 
@@ -0,0 +1,58 @@
+/**
+ * @file TreeObserver.h
+ *
+ *  Copyright 2022 Luiz C. M. de Aquino.
+ *
+ *  This file is part of CCOLab.
+ *
+ *  CCOLab is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CCOLab is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CCOLab.  If not, see <https://www.gnu.org/licenses/>
+ *
+ */
+
+/**
+ * @author Luiz Cláudio Mesquita de Aquino (luiz.aquino@ufvjm.edu.br)
+ * @brief
+ * @version 1.0
+ * @date 2022-05-18
+ */
+
+#ifndef _CCOLAB_TREE_INTERFACE_TREEOBSERVER_H
+#define _CCOLAB_TREE_INTERFACE_TREEOBSERVER_H
+class TreeObserver {
+ public:
+  /**
+   * @brief Construct a new Tree Observer object.
+   *
+   */
+  TreeObserver() {}
+
+  /**
+   * @brief Destroy the Tree Observer object.
+   *
+   */
+  virtual ~TreeObserver() {}
+
+  /**
+   * @brief Notify that the segment changed.
+   *
+   * The tree calls it for every segment whose distal point, length, flow,
+   * bifurcation ratios or descendents changed. The segments changed by one
+   * operation are notified from the deepest one up to the root, so the
+   * parent of a segment is always notified after it.
+   *
+   * @param segmentID The index of the segment.
+   */
+  virtual void changed(int segmentID) = 0;
+};
+#endif //_CCOLAB_TREE_INTERFACE_TREEOBSERVER_H